@@ -0,0 +1,97 @@
+/*
+ * Audio Arena Header
+ * Cache-aligned arena for engine state and per-block scratch
+ *
+ * One mapping, sized from memory_pool_mb, backs every buffer the engine
+ * touches while rendering. Modules carve persistent regions out of it
+ * during init; audio_arena_seal() then turns the rest into a scratch area
+ * that the render path bump-allocates from and resets every sub-block.
+ * Every region starts on its own cache line. The mapping asks for huge
+ * pages (explicit, else transparent) and is prefaulted so the first block
+ * does not take page faults.
+ *
+ * State planned after the seal stays on the heap, since the arena never
+ * frees: reverb responses loaded from the control thread (replaced and
+ * retired while the engine runs) and the capture resampler set up when
+ * input starts. Both are allocated on the control thread and only read
+ * by the render path. The resampler, FFT and convolver take an optional
+ * arena and fall back to the heap when given none.
+ *
+ * Builds with RETROSAGA_ARENA_CHECK wrap the allocator and abort when
+ * malloc, calloc or realloc is called inside a real-time section once the
+ * engine arena is sealed (RETROSAGA_ARENA_CHECK=1 scripts/build-audio.sh).
+ */
+
+#ifndef AUDIO_ARENA_H
+#define AUDIO_ARENA_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "retrosaga_audio.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define AUDIO_ARENA_ALIGNMENT 64
+
+typedef enum {
+    AUDIO_ARENA_PAGES_REGULAR = 0,
+    AUDIO_ARENA_PAGES_TRANSPARENT_HUGE,  // madvise(MADV_HUGEPAGE)
+    AUDIO_ARENA_PAGES_HUGE               // MAP_HUGETLB
+} audio_arena_pages_t;
+
+typedef struct {
+    uint8_t* base;
+    size_t capacity;
+    size_t used;                 // Persistent regions, grows until sealed
+    size_t scratch_start;
+    size_t scratch_reserved;     // Sum of the per-block needs declared at init
+    size_t scratch_used;
+    size_t scratch_peak;
+    uint64_t failed_allocations;
+    audio_arena_pages_t pages;
+    bool sealed;
+} audio_arena_t;
+
+// Lifecycle of a standalone arena
+int audio_arena_create(audio_arena_t* arena, size_t bytes);
+void audio_arena_destroy(audio_arena_t* arena);
+
+// Zeroed, AUDIO_ARENA_ALIGNMENT-aligned persistent region; init time only,
+// returns NULL once the arena is sealed or full
+void* audio_arena_alloc(audio_arena_t* arena, size_t bytes);
+
+// Declare per-block scratch needs at init; seal fails if they do not fit
+void audio_arena_scratch_reserve(audio_arena_t* arena, size_t bytes);
+
+// End of init: the remaining space becomes scratch
+int audio_arena_seal(audio_arena_t* arena);
+
+// Per-block scratch, valid until the next reset; not zeroed
+void* audio_arena_scratch_alloc(audio_arena_t* arena, size_t bytes);
+void audio_arena_scratch_reset(audio_arena_t* arena);
+
+// Engine arena, owned by the audio subsystem; NULL when not initialized
+int audio_arena_init(const retrosaga_audio_config_t* config);
+void audio_arena_shutdown(void);
+audio_arena_t* audio_arena_engine(void);
+bool audio_arena_validate(void);
+
+// Real-time sections for the allocation check; nest freely
+#ifdef RETROSAGA_ARENA_CHECK
+void audio_arena_rt_enter(void);
+void audio_arena_rt_leave(void);
+#define AUDIO_ARENA_RT_ENTER() audio_arena_rt_enter()
+#define AUDIO_ARENA_RT_LEAVE() audio_arena_rt_leave()
+#else
+#define AUDIO_ARENA_RT_ENTER() ((void)0)
+#define AUDIO_ARENA_RT_LEAVE() ((void)0)
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // AUDIO_ARENA_H
@@ -0,0 +1,72 @@
+/*
+ * Audio Configuration Header
+ * Runtime pipeline configuration from pkg.nlink
+ *
+ * Reads the [retrosaga_engine], [audio_pipeline], [threading] and
+ * [validation] sections, validates them against the rules of
+ * schemas/audio/pipeline-v1.0.0.json and caches the validated result in
+ * binary form so repeated startups skip parsing.
+ */
+
+#ifndef AUDIO_CONFIG_H
+#define AUDIO_CONFIG_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "retrosaga_audio.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define AUDIO_CONFIG_SCHEMA_VERSION "1.0.0"
+#define AUDIO_CONFIG_DEFAULT_PATH   "pkg.nlink"
+#define AUDIO_CONFIG_PATH_ENV       "RETROSAGA_CONFIG"
+#define AUDIO_CONFIG_CACHE_SUFFIX   ".cache"
+
+#define AUDIO_CONFIG_MIN_SAMPLE_RATE 8000
+#define AUDIO_CONFIG_MAX_SAMPLE_RATE 192000
+#define AUDIO_CONFIG_MAX_BUFFER_SIZE 8192
+#define AUDIO_CONFIG_MIN_SUB_BLOCK   32
+#define AUDIO_CONFIG_MAX_SUB_BLOCK   1024
+
+#define RETROSAGA_AUDIO_CONFIG_DEFAULT {            \
+    .sample_rate = RETROSAGA_SAMPLE_RATE,           \
+    .buffer_size = RETROSAGA_BUFFER_SIZE,           \
+    .max_polyphony = RETROSAGA_MAX_POLYPHONY,       \
+    .target_fps = 60,                               \
+    .module_mask = RETROSAGA_MODULE_ALL,            \
+    .channels = 2,                                  \
+    .bit_depth = 16,                                \
+    .latency_target_ms = 20.0f,                     \
+    .sub_block_frames = 32,                         \
+    .output_sample_rate = 0,                        \
+    .resampler_quality = 1,                         \
+    .worker_count = 1,                              \
+    .pin_workers = true,                            \
+    .queue_depth = 64,                              \
+    .stack_size_kb = 512,                           \
+    .work_stealing = false,                         \
+    .latency_max_ms = 20.0f,                        \
+    .memory_pool_mb = 64                            \
+}
+
+void audio_config_defaults(retrosaga_audio_config_t* config);
+
+// Parse and validate a pkg.nlink file, ignoring any cache
+int audio_config_parse_file(const char* path, retrosaga_audio_config_t* config);
+
+// Load through the binary cache (cache_path NULL = path + ".cache"); the
+// cache is rebuilt when the source size, mtime or inode changes
+int audio_config_load(const char* path, const char* cache_path, retrosaga_audio_config_t* config);
+
+// Schema rules; returns RETROSAGA_ERROR_CONFIG and logs each violation
+int audio_config_validate(const retrosaga_audio_config_t* config);
+
+bool audio_config_self_test(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // AUDIO_CONFIG_H
@@ -0,0 +1,90 @@
+/*
+ * Audio Convolver Header
+ * Zero-latency non-uniformly partitioned FFT convolution
+ *
+ * The impulse response is cut into levels of growing partition size. The
+ * head level uses the block size B and runs every block. Each later level
+ * has partitions P four times the previous one and covers taps [2P, 8P),
+ * and the last level takes the rest of the response. Every level is
+ * uniformly partitioned overlap-save with a frequency-domain delay line.
+ * Starting a level at tap 2P means a chunk finished in this block is not
+ * heard until the chunk after next, so its complex multiply-adds are
+ * spread over the P / B blocks in between: a block pays for its head
+ * level, a slice of every later level, and an FFT pair only where a chunk
+ * completes. The output has no latency beyond the block.
+ *
+ * All spectra are allocated and transformed by audio_convolver_init();
+ * processing never allocates.
+ */
+
+#ifndef AUDIO_CONVOLVER_H
+#define AUDIO_CONVOLVER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "retrosaga_audio.h"
+#include "audio_arena.h"
+#include "audio_fft.h"
+#include "audio_snapshot.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define AUDIO_CONVOLVER_MAX_LEVELS    8
+#define AUDIO_CONVOLVER_LEVEL_RATIO   4
+#define AUDIO_CONVOLVER_MAX_PARTITION 8192   // Largest tail partition, in frames
+#define AUDIO_CONVOLVER_MAX_GROWTH    64     // Largest tail partition, in blocks
+
+typedef struct {
+    uint32_t partition;          // Frames per chunk
+    uint32_t offset;             // First impulse response tap covered
+    uint32_t parts;              // Partitions in the delay line
+    uint32_t fill;               // Frames of the current chunk received
+    uint32_t newest;             // Delay line slot of the latest chunk
+    uint32_t accumulated;        // Partitions already summed into work
+    bool in_flight;              // work holds a chunk still being filtered
+    audio_fft_t fft;             // 2 * partition points
+    float* window;               // Previous and current chunk, 2 * partition
+    float* spectra;              // Delay line: parts input spectra
+    float* filter;               // parts impulse response spectra
+    float* work;                 // Accumulated spectrum, then its inverse
+    float* output;               // Levels after the head: frames for the current chunk
+} audio_convolver_level_t;
+
+typedef struct {
+    uint32_t block_frames;
+    uint32_t ir_frames;
+    uint32_t level_count;
+    size_t bytes;                // Memory held by the levels
+    bool arena_backed;
+    audio_convolver_level_t levels[AUDIO_CONVOLVER_MAX_LEVELS];
+} audio_convolver_t;
+
+// Plan for blocks of block_frames (a power of two) and transform the
+// response; ir_stride steps between taps, so one channel of an
+// interleaved response can be used directly. Allocates from arena when
+// given, else from the heap.
+int audio_convolver_init(audio_convolver_t* conv, const float* ir, uint32_t ir_frames, uint32_t ir_stride,
+                         uint32_t block_frames, audio_arena_t* arena);
+void audio_convolver_destroy(audio_convolver_t* conv);
+
+// Forget all input history
+void audio_convolver_reset(audio_convolver_t* conv);
+
+// One block of block_frames: output = input convolved with the response
+void audio_convolver_process(audio_convolver_t* conv, const float* input, float* output);
+
+// Input history and chunks in flight, for engine snapshots; restore needs
+// a convolver planned from the same response and block size
+void audio_convolver_snapshot_save(const audio_convolver_t* conv, audio_snapshot_stream_t* stream);
+bool audio_convolver_snapshot_restore(audio_convolver_t* conv, audio_snapshot_stream_t* stream);
+
+bool audio_convolver_validate(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // AUDIO_CONVOLVER_H
@@ -0,0 +1,63 @@
+/*
+ * Audio FFT Header
+ * Self-contained real FFT for block convolution
+ *
+ * A real transform of N points runs as a complex transform of N/2 points
+ * (even samples in the real part, odd in the imaginary part) followed by
+ * a split pass. The complex transform is iterative decimation in time:
+ * bit-reversed load, one radix-2 pass when log2(N/2) is odd, radix-4
+ * passes after that. Twiddles and the bit-reversal table are computed
+ * once per plan, so transforms never allocate or call trigonometry.
+ *
+ * Spectra hold bins 0..N/2 as interleaved (re, im) pairs: N + 2 floats.
+ */
+
+#ifndef AUDIO_FFT_H
+#define AUDIO_FFT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "retrosaga_audio.h"
+#include "audio_arena.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define AUDIO_FFT_MIN_SIZE 4
+#define AUDIO_FFT_MAX_SIZE (1u << 20)
+
+typedef struct {
+    uint32_t size;               // Real points, a power of two
+    uint32_t half;               // Points of the inner complex transform
+    uint32_t half_log2;
+    float* twiddles;             // exp(-2*pi*i*k/half), k < half, interleaved
+    float* split;                // exp(-2*pi*i*k/size), k < half, interleaved
+    uint32_t* bitrev;            // Bit-reversed index of each complex point
+    bool arena_backed;
+} audio_fft_t;
+
+// Plan a transform of size real points; allocates from arena when given,
+// else from the heap, so never on the audio thread
+int audio_fft_init(audio_fft_t* fft, uint32_t size, audio_arena_t* arena);
+void audio_fft_destroy(audio_fft_t* fft);
+
+// Floats in a spectrum of this plan
+static inline uint32_t audio_fft_spectrum_floats(const audio_fft_t* fft) {
+    return fft->size + 2;
+}
+
+// size real samples in, size / 2 + 1 complex bins out
+void audio_fft_forward(const audio_fft_t* fft, const float* input, float* spectrum);
+
+// Inverse including the 1/size scale; the spectrum is used as work space
+// and does not survive the call; output may be the spectrum itself
+void audio_fft_inverse(const audio_fft_t* fft, float* spectrum, float* output);
+
+bool audio_fft_validate(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // AUDIO_FFT_H
@@ -0,0 +1,99 @@
+/*
+ * Audio Parameters Header
+ * Smoothed per-channel parameters and the CC mapping table
+ *
+ * Every parameter moves towards its target as a linear ramp spread over
+ * AUDIO_PARAM_SMOOTHING_MS of render blocks; consumers read each block's
+ * start and end value and interpolate inside the block. A bank keeps a
+ * mask of ramping parameters so a settled bank costs a single test per
+ * block, and a mask of parameters that moved in the last block so
+ * derived values (oscillator increments, filter coefficients, pan gains)
+ * are only recomputed on change.
+ */
+
+#ifndef AUDIO_PARAMS_H
+#define AUDIO_PARAMS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "retrosaga_audio.h"
+#include "audio_snapshot.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define AUDIO_PARAM_CHANNELS        16
+#define AUDIO_PARAM_SMOOTHING_MS    5.0f
+#define AUDIO_PARAM_BEND_RANGE      2.0f    // Semitones at full pitch bend
+
+typedef enum {
+    AUDIO_PARAM_VOLUME = 0,     // 0..1, CC7
+    AUDIO_PARAM_EXPRESSION,     // 0..1, CC11
+    AUDIO_PARAM_PAN,            // -1..1, CC10
+    AUDIO_PARAM_PITCH_BEND,     // Semitones
+    AUDIO_PARAM_MODULATION,     // 0..1, CC1
+    AUDIO_PARAM_CUTOFF,         // 0..1 filter brightness, CC74
+    AUDIO_PARAM_RESONANCE,      // 0..1, CC71
+    AUDIO_PARAM_COUNT,
+    AUDIO_PARAM_NONE = 0xFF
+} audio_param_id_t;
+
+#define AUDIO_PARAM_BIT(id) (1u << (id))
+
+typedef struct {
+    float block_start;          // Value at the start of the last block
+    float value;                // Value at the end of the last block
+    float target;
+    float step;                 // Change per block while ramping
+    uint32_t blocks_left;
+} audio_param_t;
+
+typedef struct {
+    audio_param_t params[AUDIO_PARAM_COUNT];
+    uint32_t ramping;           // Parameters still moving
+    uint32_t changed;           // Parameters that moved in the last block
+} audio_param_bank_t;
+
+// Single-parameter ramps, also used by effect parameters
+void audio_param_init(audio_param_t* param, float value);
+void audio_param_set(audio_param_t* param, float target, uint32_t ramp_blocks);
+bool audio_param_advance(audio_param_t* param);
+
+// Module-specific functions
+int audio_params_init(void);
+int audio_params_process(void);
+void audio_params_shutdown(void);
+bool audio_params_validate(void);
+
+// Engine snapshots: channel banks and the CC map
+void audio_params_snapshot_save(audio_snapshot_stream_t* stream);
+bool audio_params_snapshot_restore(audio_snapshot_stream_t* stream);
+
+// Blocks per smoothing ramp at the configured sample rate and sub-block
+uint32_t audio_params_ramp_blocks(void);
+
+// Targets; the value is reached AUDIO_PARAM_SMOOTHING_MS later
+int audio_params_set(uint8_t channel, audio_param_id_t param, float value);
+int audio_params_control_change(uint8_t channel, uint8_t controller, uint8_t value);
+int audio_params_pitch_bend(uint8_t channel, uint16_t value);
+
+// MIDI 2.0 resolution: 32-bit controller values, 0x80000000 is centre
+int audio_params_control_change_hr(uint8_t channel, uint8_t controller, uint32_t value);
+int audio_params_pitch_bend_hr(uint8_t channel, uint32_t value);
+
+// CC mapping table: controller -> parameter, linear over [minimum, maximum]
+int audio_params_map_cc(uint8_t controller, audio_param_id_t param, float minimum, float maximum);
+
+// Advance every channel bank by one render block
+void audio_params_advance_block(void);
+const audio_param_bank_t* audio_params_channel(uint8_t channel);
+
+// Return every channel to its default values immediately
+void audio_params_reset(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // AUDIO_PARAMS_H
@@ -0,0 +1,77 @@
+/*
+ * Audio Recorder Header
+ * Background recording of the engine output to WAV or raw files
+ *
+ * sound_output taps every block it receives at the engine rate into an
+ * SPSC ring; a writer thread drains the ring, converts to the file format
+ * and writes in large batches aligned to AUDIO_RECORDER_ALIGN, optionally
+ * with O_DIRECT. The tap never waits on the writer: a full ring drops the
+ * block, counts it and leaves a gap that the writer fills with silence so
+ * the file keeps the engine's timeline. Silent blocks are passed as a
+ * frame count and cost no copy.
+ */
+
+#ifndef AUDIO_RECORDER_H
+#define AUDIO_RECORDER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "retrosaga_audio.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define AUDIO_RECORDER_ALIGN 4096   // Write offsets and sizes; the WAV header is padded to it
+
+typedef enum {
+    AUDIO_RECORDER_WAV_FLOAT32 = 0,
+    AUDIO_RECORDER_WAV_PCM16,
+    AUDIO_RECORDER_RAW_FLOAT32,
+    AUDIO_RECORDER_RAW_S16LE
+} audio_recorder_format_t;
+
+typedef struct {
+    const char* path;
+    audio_recorder_format_t format;
+    uint32_t block_frames;         // Frames per ring slot; longer taps are split
+    float buffer_ms;               // Ring depth: how long the disk may stall without drops
+    uint32_t batch_bytes;          // Bytes per write, a multiple of AUDIO_RECORDER_ALIGN
+    bool direct_io;                // O_DIRECT where the filesystem allows it
+} audio_recorder_config_t;
+
+typedef struct {
+    uint64_t blocks_recorded;
+    uint64_t frames_recorded;      // Written to the file, including filled gaps
+    uint64_t bytes_written;
+    uint64_t writes;
+    uint64_t dropped_blocks;       // Taps refused because the ring was full
+    uint64_t dropped_frames;
+    uint64_t write_errors;
+    uint32_t ring_depth;
+    uint32_t ring_fill;
+    bool direct_io;                // O_DIRECT is in effect
+} audio_recorder_stats_t;
+
+// Module-specific functions
+int audio_recorder_init(void);
+int audio_recorder_process(void);
+void audio_recorder_shutdown(void);
+bool audio_recorder_validate(void);
+
+// Recording control; stop drains the ring and finishes the file
+void audio_recorder_default_config(audio_recorder_config_t* config);
+int audio_recorder_start(const audio_recorder_config_t* config);
+void audio_recorder_stop(void);
+bool audio_recorder_active(void);
+void audio_recorder_get_stats(audio_recorder_stats_t* stats);
+
+// Audio thread side: interleaved engine-rate frames, or silence by count
+void audio_recorder_tap(const float* samples, uint32_t frames);
+void audio_recorder_tap_silence(uint32_t frames);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // AUDIO_RECORDER_H
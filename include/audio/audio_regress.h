@@ -0,0 +1,61 @@
+/*
+ * Audio Regression Header
+ * Golden-output regression tests for the render path
+ *
+ * Canonical MIDI scenes are rendered offline with the default
+ * configuration and compared against reference renders stored as 32-bit
+ * float WAV files. A scene passes when its SNR against the reference and
+ * its largest per-sample error are both within tolerance, so kernels
+ * that change rounding can be adopted with proof of how much they moved.
+ */
+
+#ifndef AUDIO_REGRESS_H
+#define AUDIO_REGRESS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "retrosaga_audio.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define AUDIO_REGRESS_DEFAULT_DIR   "golden/audio"
+#define AUDIO_REGRESS_MIN_SNR_DB    90.0
+#define AUDIO_REGRESS_MAX_ERROR     1.0e-4
+
+typedef struct {
+    double min_snr_db;
+    double max_error;
+} audio_regress_tolerance_t;
+
+typedef struct {
+    const char* scene;
+    bool passed;
+    bool missing_reference;
+    uint32_t frames;
+    double snr_db;               // INFINITY when identical
+    double max_error;
+    uint32_t max_error_frame;
+    int32_t first_diff_frame;    // -1 when identical
+} audio_regress_result_t;
+
+// Number of canonical scenes and their names
+uint32_t audio_regress_scene_count(void);
+const char* audio_regress_scene_name(uint32_t index);
+
+// Render one scene with the audio subsystem shut down; the caller frees
+// *samples (interleaved, *channels wide, at *sample_rate)
+int audio_regress_render(uint32_t index, float** samples, uint32_t* frames, uint8_t* channels,
+                         uint32_t* sample_rate);
+
+// Compare every scene against directory/<scene>.wav, or rewrite the
+// references when update is set; prints a per-scene report and returns the
+// number of failing scenes, or a negative error code
+int audio_regress_run(const char* directory, bool update, const audio_regress_tolerance_t* tolerance);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // AUDIO_REGRESS_H
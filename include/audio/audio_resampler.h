@@ -0,0 +1,103 @@
+/*
+ * Audio Resampler Header
+ * Streaming polyphase windowed-sinc sample-rate conversion
+ *
+ * Rates are reduced to an exact ratio num/den of input frames per output
+ * frame and every output position is tracked as an integer frame plus a
+ * fraction in 1/den steps, so conversion never drifts. When den is small
+ * (44100 <-> 48000 gives 160 and 147) the table holds one Kaiser-windowed
+ * sinc phase per fraction and each output is a single inner product; for
+ * other ratios the table holds AUDIO_RESAMPLER_PHASES phases and the two
+ * nearest are blended. Downsampling lowers the cutoff to the output
+ * Nyquist and widens the filter to match.
+ *
+ * Input history is kept per channel between calls, so a stream may be fed
+ * in any block sizes with identical results. Tables and history are
+ * allocated by audio_resampler_init(); processing never allocates.
+ */
+
+#ifndef AUDIO_RESAMPLER_H
+#define AUDIO_RESAMPLER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "retrosaga_audio.h"
+#include "audio_arena.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define AUDIO_RESAMPLER_MAX_CHANNELS   8
+#define AUDIO_RESAMPLER_MAX_TAPS       256     // Cap for steep downsampling
+#define AUDIO_RESAMPLER_MAX_PHASES     1024    // Largest exact phase table
+#define AUDIO_RESAMPLER_PHASES         256     // Blended table for other ratios
+#define AUDIO_RESAMPLER_CHUNK          1024    // Input frames buffered per pass
+
+typedef enum {
+    AUDIO_RESAMPLER_FAST = 0,    // 16 taps
+    AUDIO_RESAMPLER_BALANCED,    // 32 taps
+    AUDIO_RESAMPLER_BEST,        // 64 taps
+    AUDIO_RESAMPLER_QUALITY_COUNT
+} audio_resampler_quality_t;
+
+typedef struct {
+    uint32_t input_rate;
+    uint32_t output_rate;
+    uint8_t channels;
+    audio_resampler_quality_t quality;
+    uint32_t taps;               // Per phase, a multiple of 8
+    uint32_t phases;
+    bool blend;                  // Interpolate between adjacent phases
+    uint32_t step_num;           // Input frames per output frame, reduced
+    uint32_t step_den;
+    float* coefficients;         // phases + 1 rows of taps
+    float* history;              // Planar, capacity frames per channel
+    uint32_t capacity;
+    uint32_t buffered;           // Frames held in history
+    uint32_t base;               // First tap of the next output
+    uint32_t fraction;           // Position of the next output past base, in 1/step_den
+    uint32_t silent_frames;      // Trailing frames of history known to be zero
+    bool arena_backed;
+    uint64_t frames_in;
+    uint64_t frames_out;
+    uint64_t frames_dropped;     // Input refused because the output was full
+} audio_resampler_t;
+
+// Plan a converter; allocates from arena when given, else from the heap,
+// so never on the audio thread
+int audio_resampler_init(audio_resampler_t* rs, uint32_t input_rate, uint32_t output_rate, uint8_t channels,
+                         audio_resampler_quality_t quality, audio_arena_t* arena);
+void audio_resampler_destroy(audio_resampler_t* rs);
+
+// Forget the stream, as if newly initialized
+void audio_resampler_reset(audio_resampler_t* rs);
+
+// Most output frames the next call can produce from input_frames
+uint32_t audio_resampler_max_output(const audio_resampler_t* rs, uint32_t input_frames);
+
+// Input frames the next call needs to produce exactly output_frames
+uint32_t audio_resampler_input_for_output(const audio_resampler_t* rs, uint32_t output_frames);
+
+// Convert interleaved frames; input NULL feeds silence. Output stops at
+// output_capacity; all input is kept as long as the output can hold
+// audio_resampler_max_output(input_frames). Returns frames written.
+uint32_t audio_resampler_process(audio_resampler_t* rs, const float* input, uint32_t input_frames, float* output,
+                                 uint32_t output_capacity);
+
+// Input frames an output lags the input it depends on
+static inline uint32_t audio_resampler_latency(const audio_resampler_t* rs) {
+    return rs->taps / 2;
+}
+
+// "fast", "balanced" or "best"; false for anything else
+bool audio_resampler_parse_quality(const char* name, audio_resampler_quality_t* quality);
+const char* audio_resampler_quality_name(audio_resampler_quality_t quality);
+
+bool audio_resampler_validate(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // AUDIO_RESAMPLER_H
@@ -0,0 +1,65 @@
+/*
+ * Audio Ring Buffer Header
+ * Lock-free single-producer/single-consumer block ring
+ *
+ * Slots are handed out by pointer so producers write and consumers
+ * process audio in place without intermediate copies.
+ */
+
+#ifndef AUDIO_RING_H
+#define AUDIO_RING_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "retrosaga_audio.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define AUDIO_RING_CACHE_LINE 64
+
+typedef struct {
+    // Producer-owned cache line
+    uint32_t write_index __attribute__((aligned(AUDIO_RING_CACHE_LINE)));
+    uint64_t overruns;
+    uint64_t blocks_written;
+
+    // Consumer-owned cache line
+    uint32_t read_index __attribute__((aligned(AUDIO_RING_CACHE_LINE)));
+    uint64_t blocks_read;
+
+    // Immutable after init
+    float* storage __attribute__((aligned(AUDIO_RING_CACHE_LINE)));
+    uint32_t* slot_frames_used;
+    uint32_t slot_count;       // Power of two
+    uint32_t slot_mask;
+    uint32_t slot_frames;
+    uint32_t slot_stride;      // Floats per slot, padded to a cache line
+    uint8_t channels;
+} audio_ring_t;
+
+// Lifecycle
+int audio_ring_init(audio_ring_t* ring, uint32_t slot_count, uint32_t slot_frames, uint8_t channels);
+void audio_ring_destroy(audio_ring_t* ring);
+void audio_ring_reset(audio_ring_t* ring);
+
+// Producer side: acquire a free slot, fill it, then commit the frame count.
+// Returns NULL and counts an overrun when the ring is full.
+float* audio_ring_write_acquire(audio_ring_t* ring);
+void audio_ring_write_commit(audio_ring_t* ring, uint32_t frames);
+bool audio_ring_writable(const audio_ring_t* ring);
+
+// Consumer side: acquire the oldest filled slot, process it, then release.
+// Returns NULL when the ring is empty.
+float* audio_ring_read_acquire(audio_ring_t* ring, uint32_t* frames);
+void audio_ring_read_release(audio_ring_t* ring);
+
+uint32_t audio_ring_fill_level(const audio_ring_t* ring);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // AUDIO_RING_H
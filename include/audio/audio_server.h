@@ -0,0 +1,166 @@
+/*
+ * Audio Server Header
+ * Local render server sharing one engine between client processes
+ *
+ * A server process owns the engine, its sample banks and reverb, and
+ * renders for clients on the same machine. A client connects once over a
+ * Unix socket, which only carries the handshake: the server answers with
+ * a memfd holding the session (a UMP event ring and a ring of block
+ * slots) and a memfd holding the server doorbell. From then on the client
+ * writes events, requests blocks and reads them back in place, and both
+ * sides sleep on futexes in the shared pages; no data goes through the
+ * socket. Closing the socket, or the client exiting, ends the session.
+ *
+ * Every session has its own voices, channel state and reverb tail. The
+ * render thread keeps one session resident in the engine and switches
+ * with engine snapshots, so a lone client never pays for a switch and
+ * several clients pay one save and one restore per change of session.
+ * Sessions start from the engine state the server was started with.
+ *
+ * While serving, the engine belongs to the render thread: the host must
+ * not render, update or feed MIDI to it until audio_server_stop().
+ */
+
+#ifndef AUDIO_SERVER_H
+#define AUDIO_SERVER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "retrosaga_audio.h"
+#include "midi_event.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define AUDIO_SERVER_MAGIC            0x56525352u   // "RSRV"
+#define AUDIO_SERVER_VERSION          1
+#define AUDIO_SERVER_CACHE_LINE       64
+#define AUDIO_SERVER_MAX_CLIENTS      16
+#define AUDIO_SERVER_MAX_BLOCK_FRAMES 4096
+#define AUDIO_SERVER_MAX_SLOTS        64
+#define AUDIO_SERVER_MAX_EVENT_WORDS  MIDI_EVENT_QUEUE_CAPACITY   // A block's events always fit the queue
+
+// Session region at the start of the session memfd. Counters are free
+// running and wrap; each is written by one side only. The geometry is
+// read once at connect: the server keeps its own copy and never trusts
+// what a client leaves in this page.
+typedef struct {
+    // Set by the server before the region is handed out
+    uint32_t magic;
+    uint32_t version;
+    uint32_t sample_rate;
+    uint32_t channels;
+    uint32_t block_frames;
+    uint32_t slot_count;       // Power of two
+    uint32_t event_words;      // Power of two
+    uint32_t slot_bytes;       // Stride between slots
+    uint32_t events_offset;    // From the start of the region
+    uint32_t slots_offset;
+    uint32_t region_bytes;
+
+    // Client-owned cache line
+    uint32_t requested __attribute__((aligned(AUDIO_SERVER_CACHE_LINE)));   // Blocks requested
+    uint32_t waiting;          // Client sleeps on rendered
+
+    // Server-owned cache line
+    uint32_t event_tail __attribute__((aligned(AUDIO_SERVER_CACHE_LINE)));   // UMP words taken
+    uint32_t rendered;         // Futex word: blocks rendered
+    uint32_t closed;           // Session ended by the server
+} audio_server_shared_t;
+
+// One block slot; samples are interleaved at the engine channel count
+typedef struct {
+    uint32_t event_end;        // Client: event_head when the block was requested
+    uint32_t silent;           // Server: every sample is zero
+    uint32_t reserved[2];
+    float samples[];
+} audio_server_slot_t;
+
+// Server-wide doorbell page shared with every client
+typedef struct {
+    uint32_t doorbell;         // Futex word: bumped after every request
+    uint32_t sleeping;         // Render thread sleeps on doorbell
+} audio_server_doorbell_t;
+
+typedef struct {
+    const char* path;          // Unix socket for the handshake
+    uint32_t max_clients;      // Up to AUDIO_SERVER_MAX_CLIENTS
+} audio_server_config_t;
+
+typedef struct {
+    uint32_t clients;
+    uint64_t sessions_opened;
+    uint64_t connections_refused;
+    uint64_t blocks_rendered;
+    uint64_t frames_rendered;
+    uint64_t event_words;
+    uint64_t session_switches;   // Snapshot save and restore pairs
+    uint64_t protocol_errors;    // Sessions closed for corrupt ring state
+} audio_server_stats_t;
+
+typedef struct {
+    const char* path;
+    uint32_t block_frames;     // Up to AUDIO_SERVER_MAX_BLOCK_FRAMES
+    uint32_t slot_count;       // Blocks in flight, rounded up to a power of two
+    uint32_t event_words;      // UMP ring, rounded up to a power of two
+} audio_server_client_config_t;
+
+// Client end of a session; fields after channels are private
+typedef struct {
+    uint32_t sample_rate;
+    uint32_t block_frames;
+    uint32_t slot_count;
+    uint8_t channels;
+
+    int socket;
+    audio_server_shared_t* shared;
+    audio_server_doorbell_t* doorbell;
+    uint32_t* events;
+    uint8_t* slots;
+    uint32_t event_words;
+    size_t slot_bytes;
+    size_t region_bytes;
+    uint32_t event_head;
+    uint32_t requested;
+    uint32_t consumed;
+} audio_server_client_t;
+
+// Module-specific functions
+int audio_server_init(void);
+int audio_server_process(void);
+void audio_server_shutdown(void);
+bool audio_server_validate(void);
+
+// Server side, in the process that initialized the engine
+void audio_server_default_config(audio_server_config_t* config);
+int audio_server_start(const audio_server_config_t* config);
+void audio_server_stop(void);
+bool audio_server_active(void);
+void audio_server_get_stats(audio_server_stats_t* stats);
+
+// Client side; needs no engine in the client process
+void audio_server_client_default_config(audio_server_client_config_t* config);
+int audio_server_connect(audio_server_client_t* client, const audio_server_client_config_t* config);
+void audio_server_disconnect(audio_server_client_t* client);
+
+// Queue events for the next requested block; whole UMP packets only.
+// Returns the words queued, fewer when the ring is short of space.
+size_t audio_server_send_ump(audio_server_client_t* client, const uint32_t* words, size_t word_count);
+int audio_server_send_midi(audio_server_client_t* client, uint8_t status, uint8_t data1, uint8_t data2);
+
+// Ask for one block rendered after the events queued so far; false when
+// slot_count blocks are already in flight
+bool audio_server_request(audio_server_client_t* client);
+
+// Oldest requested block, waiting up to timeout_ms for it; NULL on
+// timeout, with nothing requested, or once the server closed the session
+const float* audio_server_read_acquire(audio_server_client_t* client, int timeout_ms, bool* silent);
+void audio_server_read_release(audio_server_client_t* client);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // AUDIO_SERVER_H
@@ -0,0 +1,89 @@
+/*
+ * Audio Snapshot Header
+ * Save and restore of the engine's render state
+ *
+ * A snapshot holds everything that decides what the next rendered block
+ * sounds like: voices with their oscillators, envelopes, sampler
+ * playheads and filter state, the smoothed channel parameters, MIDI
+ * channel state with queued events, and the effect chain including the
+ * reverb's delay lines. Restoring it and rendering forward reproduces the
+ * original render bit for bit, so a seek is a restore of the nearest
+ * snapshot plus a short render, and a long render can be cut into
+ * segments rendered from their own snapshots.
+ *
+ * Assets are referenced, not copied: a snapshot expects the same sample
+ * banks on the same channels and the same reverb impulse response, and
+ * restore refuses a snapshot whose engine configuration or assets differ.
+ * The output resampler and capture are device state and are not included.
+ * Only the build that wrote a snapshot reads it back.
+ *
+ * Save and restore run on the render thread between blocks, or while no
+ * block is being rendered, with no MIDI producer running. Neither
+ * allocates. Restore checks the whole snapshot before it changes
+ * anything.
+ */
+
+#ifndef AUDIO_SNAPSHOT_H
+#define AUDIO_SNAPSHOT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "retrosaga_audio.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define AUDIO_SNAPSHOT_MAGIC   0x4E535352u   // "RSSN"
+#define AUDIO_SNAPSHOT_VERSION 2
+
+// Byte stream the modules write their sections to and read them from.
+// A write past capacity keeps counting so the required size is known;
+// a reader in check mode parses everything and changes nothing.
+typedef struct {
+    uint8_t* data;
+    size_t capacity;
+    size_t position;
+    bool failed;                 // Overflow, short read or a refused section
+    bool apply;                  // Reader: false = check only
+} audio_snapshot_stream_t;
+
+void audio_snapshot_put(audio_snapshot_stream_t* stream, const void* bytes, size_t count);
+bool audio_snapshot_get(audio_snapshot_stream_t* stream, void* bytes, size_t count);
+
+// Next count bytes in place, NULL when short; unaligned, so copy out with memcpy
+const void* audio_snapshot_view(audio_snapshot_stream_t* stream, size_t count);
+
+#define AUDIO_SNAPSHOT_TAG(a, b, c, d) \
+    ((uint32_t)(a) | ((uint32_t)(b) << 8) | ((uint32_t)(c) << 16) | ((uint32_t)(d) << 24))
+
+// Each module section starts with its tag and the size of the record it
+// copies whole, so a reader and writer that disagree on layout are caught
+void audio_snapshot_begin_section(audio_snapshot_stream_t* stream, uint32_t tag, uint32_t record_bytes);
+bool audio_snapshot_expect_section(audio_snapshot_stream_t* stream, uint32_t tag, uint32_t record_bytes);
+
+// Marks the stream failed; returns false for use in a return statement
+bool audio_snapshot_refuse(audio_snapshot_stream_t* stream, const char* reason);
+
+// Bytes a snapshot of the current state needs
+size_t audio_snapshot_size(void);
+
+// Write a snapshot tagged with the caller's timeline position (e.g. the
+// frame it was taken at); *size receives the bytes used, or the bytes
+// needed when capacity is too small
+int audio_snapshot_save(void* buffer, size_t capacity, uint64_t position, size_t* size);
+
+// Replace the engine state; nothing changes unless this succeeds
+int audio_snapshot_restore(const void* buffer, size_t size);
+
+// Position a snapshot was tagged with, or UINT64_MAX if it is not one
+uint64_t audio_snapshot_position(const void* buffer, size_t size);
+
+bool audio_snapshot_validate(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // AUDIO_SNAPSHOT_H
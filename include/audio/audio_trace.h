@@ -0,0 +1,97 @@
+/*
+ * Audio Trace Header
+ * Hot-path stage timers and counters
+ *
+ * Stages are timed with CLOCK_MONOTONIC_RAW and aggregated per thread
+ * with no locking: each registered thread owns its statistics and a ring
+ * of recent spans. After a run the spans can be exported as Chrome trace
+ * JSON (chrome://tracing, Perfetto) and the stage totals as folded stacks
+ * for flamegraph/perf tooling.
+ *
+ * The macros compile to nothing unless the build defines RETROSAGA_TRACE
+ * (RETROSAGA_TRACE=1 scripts/build-audio.sh).
+ */
+
+#ifndef AUDIO_TRACE_H
+#define AUDIO_TRACE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "retrosaga_audio.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define AUDIO_TRACE_MAX_THREADS    16
+#define AUDIO_TRACE_SPAN_CAPACITY  65536   // Per thread, power of two
+#define AUDIO_TRACE_FILE_ENV       "RETROSAGA_TRACE_FILE"
+
+typedef enum {
+    AUDIO_TRACE_UPDATE = 0,      // retrosaga_audio_update
+    AUDIO_TRACE_RENDER,          // retrosaga_audio_render
+    AUDIO_TRACE_SUB_BLOCK,       // One engine sub-block
+    AUDIO_TRACE_MIDI_DRAIN,
+    AUDIO_TRACE_VOICE_OSC,       // Control updates, envelopes, oscillators
+    AUDIO_TRACE_VOICE_FILTER,
+    AUDIO_TRACE_VOICE_MIX,       // Gain ramps and mixdown
+    AUDIO_TRACE_EFFECTS,
+    AUDIO_TRACE_OUTPUT,
+    AUDIO_TRACE_STAGE_COUNT
+} audio_trace_stage_t;
+
+typedef enum {
+    AUDIO_TRACE_VOICES_RENDERED = 0,
+    AUDIO_TRACE_EVENTS_APPLIED,
+    AUDIO_TRACE_FRAMES_OUTPUT,
+    AUDIO_TRACE_COUNTER_COUNT
+} audio_trace_counter_t;
+
+typedef struct {
+    uint64_t count;
+    uint64_t total_ns;
+    uint64_t min_ns;
+    uint64_t max_ns;
+} audio_trace_stats_t;
+
+#ifdef RETROSAGA_TRACE
+#define AUDIO_TRACE_BEGIN(start) uint64_t start = audio_trace_now()
+#define AUDIO_TRACE_END(stage, start) audio_trace_record((stage), (start), audio_trace_now())
+#define AUDIO_TRACE_COUNT(counter, amount) audio_trace_count((counter), (amount))
+#else
+#define AUDIO_TRACE_BEGIN(start) ((void)0)
+#define AUDIO_TRACE_END(stage, start) ((void)0)
+#define AUDIO_TRACE_COUNT(counter, amount) ((void)0)
+#endif
+
+// True when the build was made with RETROSAGA_TRACE
+bool audio_trace_compiled_in(void);
+
+// Module lifecycle; init registers the calling thread as "audio"
+int audio_trace_init(void);
+void audio_trace_shutdown(void);
+void audio_trace_reset(void);
+
+// Other threads that run traced code register once, outside the hot path
+int audio_trace_thread_register(const char* name);
+
+// Hot path (use the macros)
+uint64_t audio_trace_now(void);
+void audio_trace_record(audio_trace_stage_t stage, uint64_t start_ns, uint64_t end_ns);
+void audio_trace_count(audio_trace_counter_t counter, uint64_t amount);
+
+// Aggregates over every registered thread
+void audio_trace_get_stats(audio_trace_stage_t stage, audio_trace_stats_t* stats);
+uint64_t audio_trace_get_counter(audio_trace_counter_t counter);
+const char* audio_trace_stage_name(audio_trace_stage_t stage);
+void audio_trace_report(void);
+
+// Exports after a run
+int audio_trace_export_chrome(const char* path);
+int audio_trace_export_folded(const char* path);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // AUDIO_TRACE_H
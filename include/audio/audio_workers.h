@@ -0,0 +1,55 @@
+/*
+ * Audio Workers Header
+ * Fork-join worker pool for intra-block rendering
+ *
+ * The render thread dispatches one job per block and takes part as
+ * worker 0; the pool threads run workers 1..count-1 and the call returns
+ * once all of them have finished, so a block still completes inside the
+ * render call. Idle workers spin briefly for the next dispatch and then
+ * park on a futex, which keeps back-to-back blocks at spin latency
+ * without burning cores between sparse ones.
+ */
+
+#ifndef AUDIO_WORKERS_H
+#define AUDIO_WORKERS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "retrosaga_audio.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define AUDIO_WORKERS_MAX        16
+#define AUDIO_WORKERS_SPIN_LIMIT 20000   // Relax iterations before parking
+
+// Runs once per worker and dispatch; worker 0 is the calling thread
+typedef void (*audio_worker_fn)(void* context, uint32_t worker, uint32_t worker_count);
+
+typedef struct {
+    uint64_t dispatches;
+    uint64_t worker_parks;         // Times a worker gave up spinning
+    uint64_t caller_parks;         // Times the render thread waited on a futex
+} audio_workers_stats_t;
+
+// Pool sized from worker_count (threads = count - 1); a count of 1 runs
+// every job inline. With pin set, workers get one CPU each, skipping the
+// CPU of the calling thread, which should be the render thread.
+int audio_workers_init(uint32_t worker_count, uint32_t stack_size_kb, bool pin);
+void audio_workers_shutdown(void);
+
+// Workers available to a job, including the caller; 1 when no pool
+uint32_t audio_workers_count(void);
+
+// Fork-join: run fn on every worker and return when all are done
+void audio_workers_run(audio_worker_fn fn, void* context);
+
+void audio_workers_get_stats(audio_workers_stats_t* stats);
+bool audio_workers_validate(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // AUDIO_WORKERS_H
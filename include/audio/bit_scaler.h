@@ -20,6 +20,10 @@ int bit_scaler_process(void);
 void bit_scaler_shutdown(void);
 bool bit_scaler_validate(void);
 
+// M2-115-U scaling algorithms
+uint32_t scale_midi_value_min_center_max(uint32_t src_val, uint8_t src_bits, uint8_t dst_bits);
+uint32_t scale_midi_value_zero_extension(uint32_t src_val, uint8_t src_bits, uint8_t dst_bits);
+
 #ifdef __cplusplus
 }
 #endif
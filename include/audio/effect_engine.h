@@ -9,6 +9,7 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include "retrosaga_audio.h"
+#include "audio_snapshot.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -20,6 +21,47 @@ int effect_engine_process(void);
 void effect_engine_shutdown(void);
 bool effect_engine_validate(void);
 
+// Run the effect chain in place over an interleaved block
+int effect_engine_process_buffer(float* buffer, uint32_t frames, uint8_t channels);
+
+// As above with silence propagation: *silent says the input block is all
+// zeros and comes back true when the output is too. A silent input with
+// no tail left skips the chain; a tail ends early once its output and
+// all the reverb response can still return are below
+// EFFECT_ENGINE_SILENCE_THRESHOLD.
+#define EFFECT_ENGINE_SILENCE_THRESHOLD 1.0e-6f   // About -120 dBFS
+int effect_engine_process_block(float* buffer, uint32_t frames, uint8_t channels, bool* silent);
+
+// Frames the chain keeps sounding after its input goes silent
+uint32_t effect_engine_tail_frames(void);
+
+// Quantize the chain output to a signed bit depth (2..24); 0 bypasses
+int effect_engine_set_bitcrush(uint8_t bits);
+
+// Output gain, ramped over the parameter smoothing time
+int effect_engine_set_output_gain(float gain);
+
+// Convolution reverb, first in the chain: out = dry + level * (dry * IR).
+// Runs per sub_block_frames block with no added latency; blocks of another
+// size or channel count (captured input) pass through dry. Output channel c
+// uses IR channel c % ir_channels of the interleaved response.
+#define EFFECT_ENGINE_REVERB_MAX_CHANNELS 8
+#define EFFECT_ENGINE_REVERB_MAX_FRAMES   (30u * 192000u)
+
+// Plans and transforms the response on the calling thread, then hands it
+// to the audio thread, which swaps it in at its next block; the response
+// it replaces is freed by the next load or at shutdown. Call from one
+// control thread, never from the audio thread.
+int effect_engine_load_reverb(const float* ir, uint32_t ir_frames, uint8_t ir_channels);
+
+// Wet level (0 bypasses the convolution), ramped like the output gain
+int effect_engine_set_reverb_level(float level);
+
+// Engine snapshots: parameter ramps, the effect tail and the reverb's delay
+// lines; restore requires the same response to be loaded
+void effect_engine_snapshot_save(audio_snapshot_stream_t* stream);
+bool effect_engine_snapshot_restore(audio_snapshot_stream_t* stream);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,75 @@
+/*
+ * Envelope Generator Header
+ * Block-rate ADSR envelopes
+ *
+ * The stage machine runs once per render block and yields the block's
+ * start and end gain; the per-sample shape inside a block is a linear
+ * ramp applied by the render kernels, so no per-sample stage branching
+ * happens in the voice loop. Attack is linear, decay and release are
+ * exponential segments evaluated exactly at block boundaries.
+ */
+
+#ifndef ENVELOPE_H
+#define ENVELOPE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "retrosaga_audio.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Level below which a releasing envelope is finished (-80 dB)
+#define ENVELOPE_SILENCE 1.0e-4f
+
+typedef enum {
+    ENVELOPE_IDLE = 0,
+    ENVELOPE_ATTACK,
+    ENVELOPE_DECAY,
+    ENVELOPE_SUSTAIN,
+    ENVELOPE_RELEASE
+} envelope_stage_t;
+
+typedef struct {
+    float attack_ms;
+    float decay_ms;
+    float sustain;      // 0..1
+    float release_ms;
+} envelope_params_t;
+
+// Per-block constants derived from envelope_params_t
+typedef struct {
+    float attack_step;  // Level added per block
+    float decay_coef;   // Distance to sustain kept per block
+    float release_coef; // Level kept per block
+    float sustain;
+} envelope_shape_t;
+
+typedef struct {
+    float level;
+    uint8_t stage;
+} envelope_t;
+
+#define ENVELOPE_PARAMS_DEFAULT { 5.0f, 120.0f, 0.7f, 200.0f }
+
+// Decay and release reach -60 dB of their distance in the given time
+void envelope_shape_init(envelope_shape_t* shape, const envelope_params_t* params,
+                         float sample_rate, uint32_t block_frames);
+
+void envelope_gate_on(envelope_t* envelope);
+void envelope_gate_off(envelope_t* envelope);
+
+// Advance one block; returns false once the envelope has gone idle, in
+// which case the block just produced is the final fade to zero
+bool envelope_next_block(envelope_t* envelope, const envelope_shape_t* shape, float* start, float* end);
+
+static inline bool envelope_is_releasing(const envelope_t* envelope) {
+    return envelope->stage == ENVELOPE_RELEASE;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ENVELOPE_H
@@ -9,17 +9,97 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include "retrosaga_audio.h"
+#include "waveform_generator.h"
+#include "audio_resampler.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+// Capture source backends
+typedef enum {
+    INPUT_SOURCE_NONE = 0,
+    INPUT_SOURCE_ALSA,        // Live capture (requires RETROSAGA_HAVE_ALSA)
+    INPUT_SOURCE_WAV_FILE,    // RIFF/WAVE, 8/16/24/32-bit PCM or 32-bit float
+    INPUT_SOURCE_RAW_FILE,    // Headerless interleaved samples
+    INPUT_SOURCE_SYNTHETIC    // Generated test signal
+} input_source_type_t;
+
+typedef enum {
+    INPUT_RAW_FLOAT32 = 0,
+    INPUT_RAW_S16LE
+} input_raw_format_t;
+
+typedef struct {
+    input_source_type_t source;
+    const char* location;          // ALSA device name or file path
+    uint32_t sample_rate;          // Rate of the delivered blocks
+    uint32_t block_frames;         // Frames per ring slot
+    uint8_t channels;              // Ring channels; files are remixed to it
+    float latency_ms;              // Ring depth; also the ALSA buffer target
+
+    // Capture rate when it differs (0 = sample_rate): the ALSA device is
+    // opened at it and raw files and the synthetic source run at it; WAV
+    // files use their header rate. Blocks are converted before the ring.
+    uint32_t source_rate;
+    audio_resampler_quality_t resampler_quality;
+
+    // File sources
+    input_raw_format_t raw_format;
+    bool loop;
+
+    // File and synthetic sources: true = deliver at the sample clock and
+    // count overruns like a device, false = block until the consumer frees a slot
+    bool paced;
+
+    // Synthetic source
+    waveform_type_t synth_waveform;
+    float synth_frequency;
+    float synth_amplitude;
+} input_audio_config_t;
+
+typedef struct {
+    uint64_t blocks_captured;
+    uint64_t blocks_consumed;
+    uint64_t frames_captured;
+    uint64_t overruns;             // Blocks dropped because the ring was full
+    uint64_t underruns;            // Updates that found no block while streaming
+    uint64_t device_xruns;         // Overruns reported by the capture device
+    uint32_t ring_depth;
+    uint32_t ring_fill;
+    uint32_t source_rate;
+    bool end_of_stream;
+} input_audio_stats_t;
+
 // Module-specific functions
 int input_audio_init(void);
 int input_audio_process(void);
 void input_audio_shutdown(void);
 bool input_audio_validate(void);
 
+// Capture control
+void input_audio_default_config(input_audio_config_t* config);
+int input_audio_start(const input_audio_config_t* config);
+void input_audio_stop(void);
+bool input_audio_active(void);
+uint8_t input_audio_channels(void);
+
+// Zero-copy block access; the block may be processed in place and must be
+// released before the next acquire. Not for use while the engine renders,
+// which consumes the ring through input_audio_mix().
+float* input_audio_acquire_block(uint32_t* frames);
+void input_audio_release_block(void);
+
+// Render thread: add up to frames of captured input to an interleaved
+// engine bus, remapping the capture channels to the bus; returns frames
+// added, fewer when capture has fallen behind
+uint32_t input_audio_mix(float* bus, uint32_t frames, uint8_t channels);
+
+// Captured input is waiting to be mixed
+bool input_audio_pending(void);
+
+void input_audio_get_stats(input_audio_stats_t* stats);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,74 @@
+/*
+ * MIDI Benchmark Header
+ * Synthetic MIDI load generator and event throughput measurement
+ *
+ * Generates dense synthetic traffic and drives it through the MIDI input
+ * paths into the voice manager, the way the render thread would drain
+ * it. Reports events/sec, the per-event latency distribution and the
+ * heap allocations made while the clock was running.
+ */
+
+#ifndef MIDI_BENCHMARK_H
+#define MIDI_BENCHMARK_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "retrosaga_audio.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+    MIDI_LOAD_CHORDS = 0,        // 8-note chords on and off across channels
+    MIDI_LOAD_CC_SWEEP,          // Controller sweeps on every mapped CC
+    MIDI_LOAD_PITCH_BEND_FLOOD,  // Continuous 14-bit bends
+    MIDI_LOAD_RUNNING_STATUS,    // CC bursts sent with running status
+    MIDI_LOAD_MIXED,
+    MIDI_LOAD_COUNT
+} midi_load_t;
+
+typedef enum {
+    MIDI_PATH_DIRECT = 0,        // process_midi_message() per message
+    MIDI_PATH_BYTE_STREAM,       // midi_processing_ingest_bytes() in chunks
+    MIDI_PATH_UMP,               // midi_processing_ingest_ump() in chunks
+    MIDI_PATH_COUNT
+} midi_path_t;
+
+typedef struct {
+    midi_load_t load;
+    midi_path_t path;
+    uint32_t messages;
+    uint32_t chunk_messages;     // Messages per ingest call for queued paths
+} midi_benchmark_config_t;
+
+typedef struct {
+    uint64_t events;
+    uint64_t dropped;
+    double seconds;
+    double events_per_second;
+    // Per-event latency; queued paths attribute each chunk evenly to its events
+    uint32_t latency_p50_ns;
+    uint32_t latency_p99_ns;
+    uint32_t latency_p999_ns;
+    uint32_t latency_max_ns;
+    uint64_t allocations;
+} midi_benchmark_result_t;
+
+const char* midi_benchmark_load_name(midi_load_t load);
+const char* midi_benchmark_path_name(midi_path_t path);
+
+// Allocation counter maintained by the host (for example a malloc wrapper);
+// without one the allocation count is reported as zero
+void midi_benchmark_set_allocation_counter(const volatile uint64_t* counter);
+
+// Needs midi_processing and voice_manager initialized; resets voices after.
+// Switch off midi_processing logging first or the trace dominates.
+int midi_benchmark_run(const midi_benchmark_config_t* config, midi_benchmark_result_t* result);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // MIDI_BENCHMARK_H
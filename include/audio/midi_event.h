@@ -0,0 +1,92 @@
+/*
+ * MIDI Event Queue Header
+ * High-resolution channel voice events between MIDI input and the renderer
+ *
+ * Events carry MIDI 2.0 resolution (16-bit velocity, 32-bit controller
+ * and pitch values) whatever protocol they arrived in, so scaling
+ * happens once at ingest and the voice path never rescales. The queue is
+ * a lock-free single-producer/single-consumer ring: the MIDI input
+ * thread pushes, the render thread drains at sub-block boundaries.
+ */
+
+#ifndef MIDI_EVENT_H
+#define MIDI_EVENT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "retrosaga_audio.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define MIDI_EVENT_QUEUE_CAPACITY 1024   // Power of two
+#define MIDI_EVENT_CACHE_LINE     64
+
+// Centre of a 32-bit bipolar value (pitch bend)
+#define MIDI_EVENT_CENTER_32 0x80000000u
+
+typedef enum {
+    MIDI_EVENT_NOTE_OFF = 0,
+    MIDI_EVENT_NOTE_ON,
+    MIDI_EVENT_POLY_PRESSURE,
+    MIDI_EVENT_CONTROL_CHANGE,        // index = controller
+    MIDI_EVENT_PROGRAM_CHANGE,        // value = program
+    MIDI_EVENT_CHANNEL_PRESSURE,
+    MIDI_EVENT_PITCH_BEND,
+    MIDI_EVENT_PER_NOTE_CONTROL,      // index = registered controller number
+    MIDI_EVENT_PER_NOTE_PITCH_BEND,
+    MIDI_EVENT_PER_NOTE_MANAGEMENT,   // attribute = option flags
+    MIDI_EVENT_TYPE_COUNT
+} midi_event_type_t;
+
+// Registered per-note controllers handled by the voice path
+#define MIDI_PER_NOTE_PITCH_7_25   3
+#define MIDI_PER_NOTE_VOLUME       7
+
+// Per-note management option flags
+#define MIDI_PER_NOTE_RESET        0x01
+#define MIDI_PER_NOTE_DETACH       0x02
+
+typedef struct {
+    uint8_t type;
+    uint8_t channel;
+    uint8_t note;
+    uint8_t index;
+    uint16_t velocity;      // Note on/off, full 16-bit range
+    uint16_t attribute;
+    uint32_t value;         // Controllers, pressure, bends, program
+} midi_event_t;
+
+typedef struct {
+    // Producer-owned cache line
+    uint32_t write_index __attribute__((aligned(MIDI_EVENT_CACHE_LINE)));
+    uint64_t dropped;
+
+    // Consumer-owned cache line
+    uint32_t read_index __attribute__((aligned(MIDI_EVENT_CACHE_LINE)));
+
+    midi_event_t events[MIDI_EVENT_QUEUE_CAPACITY] __attribute__((aligned(MIDI_EVENT_CACHE_LINE)));
+} midi_event_queue_t;
+
+void midi_event_queue_reset(midi_event_queue_t* queue);
+
+// Producer side; a full queue drops and counts the remainder
+size_t midi_event_queue_push_batch(midi_event_queue_t* queue, const midi_event_t* events, size_t count);
+bool midi_event_queue_push(midi_event_queue_t* queue, const midi_event_t* event);
+
+// Consumer side
+bool midi_event_queue_pop(midi_event_queue_t* queue, midi_event_t* event);
+uint32_t midi_event_queue_depth(const midi_event_queue_t* queue);
+void midi_event_queue_discard(midi_event_queue_t* queue);   // Drop everything pending
+
+// Upconvert one MIDI 1.0 channel voice message (M2-115-U min-center-max);
+// returns false for messages with no event form
+bool midi_event_from_midi1(uint8_t status, uint8_t data1, uint8_t data2, midi_event_t* event);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // MIDI_EVENT_H
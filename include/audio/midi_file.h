@@ -0,0 +1,76 @@
+/*
+ * MIDI File Reader Header
+ * Streaming Standard MIDI File (SMF) playback
+ *
+ * Files are memory-mapped and tracks are merged lazily through a k-way
+ * heap, so memory stays constant regardless of song length. A tempo map
+ * and sparse seek index are built in one scan at open time.
+ */
+
+#ifndef MIDI_FILE_H
+#define MIDI_FILE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "retrosaga_audio.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Spacing of seek index checkpoints
+#define MIDI_FILE_INDEX_INTERVAL_MS 500
+
+#define MIDI_META_END_OF_TRACK 0x2F
+#define MIDI_META_SET_TEMPO    0x51
+
+typedef struct midi_file midi_file_t;
+
+typedef struct {
+    uint64_t tick;
+    uint64_t sample;                // Offset from song start at the reader's sample rate
+    uint16_t track;
+    uint8_t status;                 // Channel status, 0xF0/0xF7 SysEx or 0xFF meta
+    uint8_t data1;                  // Meta events: meta type
+    uint8_t data2;
+    const uint8_t* payload;         // SysEx/meta body, points into the mapped file
+    uint32_t payload_length;
+} midi_file_event_t;
+
+typedef struct {
+    uint16_t format;
+    uint16_t track_count;
+    uint16_t division;
+    uint64_t total_ticks;
+    uint64_t total_samples;
+    uint32_t tempo_changes;
+    uint32_t index_points;
+    uint32_t malformed_tracks;
+} midi_file_info_t;
+
+// Lifecycle
+int midi_file_open(const char* path, uint32_t sample_rate, midi_file_t** reader);
+int midi_file_open_memory(const uint8_t* data, size_t size, uint32_t sample_rate, midi_file_t** reader);
+void midi_file_close(midi_file_t* reader);
+void midi_file_get_info(const midi_file_t* reader, midi_file_info_t* info);
+
+// Streaming in (tick, track) order; return false at end of song
+bool midi_file_next_event(midi_file_t* reader, midi_file_event_t* event);
+bool midi_file_peek_event(midi_file_t* reader, midi_file_event_t* event);
+
+// Position the stream at the first event at or after the sample offset
+int midi_file_seek(midi_file_t* reader, uint64_t sample);
+uint64_t midi_file_tick_to_sample(const midi_file_t* reader, uint64_t tick);
+
+// Feed channel events earlier than end_sample to process_midi_message;
+// returns the number of events dispatched
+int midi_file_dispatch(midi_file_t* reader, uint64_t end_sample);
+
+bool midi_file_validate(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // MIDI_FILE_H
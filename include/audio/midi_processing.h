@@ -9,6 +9,10 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include "retrosaga_audio.h"
+#include "midi_event.h"
+#include "midi_ump.h"
+#include "midi_stream.h"
+#include "audio_snapshot.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -20,6 +24,26 @@ int midi_processing_process(void);
 void midi_processing_shutdown(void);
 bool midi_processing_validate(void);
 
+// Universal MIDI Packet input; MIDI 1.0 and 2.0 channel voice packets
+// land in the event queue at full resolution. Returns words consumed.
+size_t midi_processing_ingest_ump(const uint32_t* words, size_t word_count);
+
+// Raw MIDI 1.0 byte stream input (serial/USB); messages may span calls.
+// Returns the number of channel events queued.
+#define MIDI_PROCESSING_SYSEX_CAPACITY 4096
+size_t midi_processing_ingest_bytes(const uint8_t* bytes, size_t count);
+
+// Per-message trace output (on by default)
+void midi_processing_set_logging(bool enabled);
+
+// Events waiting for the renderer, drained at sub-block boundaries
+midi_event_queue_t* midi_processing_event_queue(void);
+
+// Engine snapshots: channel state, the byte parser's message in progress
+// and queued events
+void midi_processing_snapshot_save(audio_snapshot_stream_t* stream);
+bool midi_processing_snapshot_restore(audio_snapshot_stream_t* stream);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,78 @@
+/*
+ * MIDI Byte Stream Parser Header
+ * Incremental parsing of raw serial/USB MIDI 1.0 byte streams
+ *
+ * The parser keeps its state between calls, so a message may be split
+ * across buffers at any byte. It tracks running status, passes real-time
+ * bytes (0xF8-0xFF) through without disturbing a message in progress, and
+ * collects SysEx of any length into a caller-supplied buffer (longer
+ * messages are delivered truncated and flagged). Channel voice messages
+ * are upconverted and pushed to an event queue in batches.
+ */
+
+#ifndef MIDI_STREAM_H
+#define MIDI_STREAM_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "retrosaga_audio.h"
+#include "midi_event.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define MIDI_SYSEX_START    0xF0
+#define MIDI_SYSEX_END      0xF7
+#define MIDI_REALTIME_FIRST 0xF8
+
+// Complete SysEx body without the F0/F7 framing
+typedef void (*midi_stream_sysex_fn)(const uint8_t* data, uint32_t length, bool truncated, void* user);
+typedef void (*midi_stream_realtime_fn)(uint8_t status, void* user);
+
+typedef struct {
+    uint64_t bytes;
+    uint64_t channel_messages;
+    uint64_t system_messages;      // System common, parsed and skipped
+    uint64_t realtime_messages;
+    uint64_t sysex_messages;
+    uint64_t sysex_truncated;
+    uint64_t stray_bytes;          // Data bytes with no status to attach to
+    uint64_t dropped;              // Events lost to a full queue
+} midi_stream_stats_t;
+
+typedef struct {
+    uint8_t status;                // Message in progress; kept after channel
+                                   // messages for running status, 0 when cancelled
+    uint8_t data[2];
+    uint8_t data_count;
+    uint8_t data_expected;
+    bool in_sysex;
+
+    uint8_t* sysex;                // Preallocated by the caller
+    uint32_t sysex_capacity;
+    uint32_t sysex_length;
+    bool sysex_overflow;
+
+    midi_stream_sysex_fn on_sysex;
+    midi_stream_realtime_fn on_realtime;
+    void* user;
+
+    midi_stream_stats_t stats;
+} midi_stream_parser_t;
+
+int midi_stream_parser_init(midi_stream_parser_t* parser, uint8_t* sysex_buffer, uint32_t sysex_capacity);
+void midi_stream_parser_reset(midi_stream_parser_t* parser);
+
+// Parse a whole buffer; every byte is consumed. Returns events produced.
+size_t midi_stream_parse(midi_stream_parser_t* parser, const uint8_t* bytes, size_t count,
+                         midi_event_queue_t* queue);
+
+bool midi_stream_self_test(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // MIDI_STREAM_H
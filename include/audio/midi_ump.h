@@ -0,0 +1,57 @@
+/*
+ * MIDI UMP Parser Header
+ * Universal MIDI Packet ingestion
+ *
+ * Parses a buffer of 32-bit UMP words into midi_event_t in batches.
+ * MIDI 2.0 channel voice packets (type 0x4) keep their native 16/32-bit
+ * values; MIDI 1.0 channel voice packets (type 0x2) are upconverted
+ * once here. Utility, system, data and stream packets are skipped by
+ * their packet size so the stream stays in sync.
+ */
+
+#ifndef MIDI_UMP_H
+#define MIDI_UMP_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "retrosaga_audio.h"
+#include "midi_event.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// UMP message types (top nibble of the first word)
+#define UMP_TYPE_UTILITY         0x0
+#define UMP_TYPE_SYSTEM          0x1
+#define UMP_TYPE_MIDI1_VOICE     0x2
+#define UMP_TYPE_DATA64          0x3
+#define UMP_TYPE_MIDI2_VOICE     0x4
+
+typedef struct {
+    uint64_t packets;
+    uint64_t events;
+    uint64_t skipped;      // Valid packets with no channel voice event
+    uint64_t dropped;      // Events lost to a full queue
+} midi_ump_stats_t;
+
+// Words in a packet of the given message type
+uint32_t midi_ump_packet_words(uint32_t first_word);
+
+// Parse whole packets into events; returns the number of words consumed
+// (a trailing partial packet is left for the next call)
+size_t midi_ump_parse(const uint32_t* words, size_t word_count, midi_event_t* events,
+                      size_t max_events, size_t* event_count, midi_ump_stats_t* stats);
+
+// Parse and push straight into a queue in batches
+size_t midi_ump_ingest(const uint32_t* words, size_t word_count, midi_event_queue_t* queue,
+                       midi_ump_stats_t* stats);
+
+bool midi_ump_self_test(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // MIDI_UMP_H
@@ -0,0 +1,73 @@
+/*
+ * Pitch Table Header
+ * Note-to-increment tables and a fast exp2 for pitch math
+ *
+ * A pitch_table_t holds the 32.32 phase increment of every integer note
+ * from PITCH_TABLE_LOWEST to PITCH_TABLE_HIGHEST at one sample rate, so a
+ * fractional note (with bend, per-note pitch or vibrato folded in) costs
+ * one lookup and one pitch_exp2f() of the fraction. Integer notes come
+ * straight from the table. Increments wrap like render_osc_increment().
+ *
+ * pitch_exp2f() evaluates a degree-5 minimax polynomial on the fraction
+ * and builds the power of two in the float exponent; its relative error
+ * stays below 1e-7, about 0.0002 cents.
+ */
+
+#ifndef PITCH_TABLE_H
+#define PITCH_TABLE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "retrosaga_audio.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define PITCH_TABLE_LOWEST  (-64)   // Per-note bend reaches well below note 0
+#define PITCH_TABLE_HIGHEST 191
+#define PITCH_TABLE_SIZE    (PITCH_TABLE_HIGHEST - PITCH_TABLE_LOWEST + 1)
+
+typedef struct {
+    float sample_rate;
+    int64_t increments[PITCH_TABLE_SIZE];    // Cycles per sample, 32.32; signed converts faster
+} pitch_table_t;
+
+// Build for a sample rate; does nothing when the rate is unchanged
+void pitch_table_set_rate(pitch_table_t* table, float sample_rate);
+
+// 2^x for |x| < 126
+static inline float pitch_exp2f(float x) {
+    x = x < -126.0f ? -126.0f : (x > 126.0f ? 126.0f : x);
+    int32_t whole = (int32_t)x;
+    whole -= x < (float)whole;
+    float f = x - (float)whole;
+    float p = 1.0f + f * (0.6931513118f + f * (0.2401644502f + f * (0.05579991310f +
+                     f * (0.009017030322f + f * 0.001867130070f))));
+    uint32_t bits = (uint32_t)(whole + 127) << 23;
+    float scale;
+    memcpy(&scale, &bits, sizeof(scale));
+    return p * scale;
+}
+
+// Phase increment of a fractional note number
+static inline uint32_t pitch_table_increment(const pitch_table_t* table, float note) {
+    const float highest = (float)PITCH_TABLE_HIGHEST;
+    note = note < (float)PITCH_TABLE_LOWEST ? (float)PITCH_TABLE_LOWEST : (note > highest ? highest : note);
+    int32_t index = (int32_t)(note - (float)PITCH_TABLE_LOWEST);
+    float fraction = note - (float)(index + PITCH_TABLE_LOWEST);
+    int64_t increment = table->increments[index];
+    if (fraction > 0.0f) {
+        increment = (int64_t)((double)increment * pitch_exp2f(fraction * (1.0f / 12.0f)));
+    }
+    return (uint32_t)increment;
+}
+
+bool pitch_table_validate(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PITCH_TABLE_H
@@ -0,0 +1,73 @@
+/*
+ * Render Benchmark Header
+ * End-to-end voice render benchmark with reproducible scenarios
+ *
+ * Each scenario brings the audio subsystem up with its own block size
+ * and channel count, holds a fixed set of voices and renders a fixed
+ * amount of audio through voice_manager_render(). Results are written
+ * as JSON, one scenario object per line, and compared against a stored
+ * baseline of the same format.
+ */
+
+#ifndef RENDER_BENCHMARK_H
+#define RENDER_BENCHMARK_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include "retrosaga_audio.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define RENDER_BENCHMARK_NAME_MAX       48
+#define RENDER_BENCHMARK_MAX_SCENARIOS  64
+#define RENDER_BENCHMARK_DEFAULT_SECONDS 2.0f
+#define RENDER_BENCHMARK_TOLERANCE      0.10   // Allowed ns/sample/voice slowdown
+
+typedef struct {
+    char name[RENDER_BENCHMARK_NAME_MAX];
+    uint8_t waveform;
+    uint32_t voices;
+    bool effects;                  // Bitcrush and output gain ramp enabled
+    uint32_t block_frames;         // Host buffer and sub-block size
+    uint8_t channels;
+    float seconds;                 // Audio rendered per scenario
+    float reverb_seconds;          // Convolution reverb response length, 0 = none
+} render_scenario_t;
+
+typedef struct {
+    uint64_t frames;
+    uint32_t blocks;
+    double wall_seconds;
+    double real_time_factor;       // Audio seconds per wall-clock second
+    double ns_per_sample_voice;
+    uint32_t block_p50_ns;
+    uint32_t block_p99_ns;
+    uint32_t block_max_ns;
+} render_result_t;
+
+// Fixed suite: voice counts per waveform, effects on/off, convolution
+// reverb, block sizes and channel counts; returns the number of scenarios written
+size_t render_benchmark_default_suite(render_scenario_t* scenarios, size_t max_scenarios);
+
+// Runs with the audio subsystem shut down: initializes it from base with
+// the scenario's block size and channels, and shuts it down afterwards
+int render_benchmark_run(const render_scenario_t* scenario, const retrosaga_audio_config_t* base,
+                         render_result_t* result);
+
+int render_benchmark_write_json(FILE* out, const render_scenario_t* scenarios, const render_result_t* results,
+                                size_t count);
+
+// Report each scenario against the baseline file; returns the number of
+// scenarios slower than tolerance, or a negative error code
+int render_benchmark_compare(const char* baseline_path, const render_scenario_t* scenarios,
+                             const render_result_t* results, size_t count, double tolerance);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // RENDER_BENCHMARK_H
@@ -0,0 +1,59 @@
+/*
+ * Render Kernels Header
+ * Block-size specialized oscillator, mixer and effect inner loops
+ *
+ * Each kernel body is instantiated for the common block sizes and
+ * channel counts so the compiler sees constant trip counts and can fully
+ * unroll and vectorize. render_kernels_select() is resolved once per
+ * block shape; any other shape falls back to the generic loops.
+ */
+
+#ifndef RENDER_KERNELS_H
+#define RENDER_KERNELS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "retrosaga_audio.h"
+#include "waveform_generator.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Specialized block sizes and channel counts
+#define RENDER_KERNEL_BLOCK_SIZES  {32, 64, 128, 256, 512, 1024}
+#define RENDER_KERNEL_CHANNELS     {1, 2, 8}
+
+// 32-bit phase accumulator; wraps exactly once per cycle
+typedef struct {
+    uint32_t phase;
+    uint32_t increment;
+} render_osc_t;
+
+typedef void (*render_osc_fn)(render_osc_t* osc, float amplitude, float* out, uint32_t frames);
+typedef void (*render_mix_fn)(const float* voice, const float* gains, float* bus,
+                              uint32_t frames, uint8_t channels);
+typedef void (*render_crush_fn)(float* buffer, float levels, uint32_t frames, uint8_t channels);
+typedef void (*render_ramp_fn)(float* buffer, float start, float end, uint32_t frames);
+
+typedef struct {
+    uint32_t frames;                         // 0 for the generic set
+    uint8_t channels;                        // 0 when channels are a runtime value
+    render_osc_fn oscillator[WAVEFORM_COUNT];
+    render_mix_fn mix;                       // bus[i * channels + c] += voice[i] * gains[c]
+    render_crush_fn bitcrush;                // Quantize to +/- levels steps
+    render_ramp_fn ramp;                     // Mono gain ramp from start towards end
+} render_kernels_t;
+
+const render_kernels_t* render_kernels_select(uint32_t frames, uint8_t channels);
+bool render_kernels_is_specialized(const render_kernels_t* kernels);
+
+uint32_t render_osc_increment(float frequency, float sample_rate);
+
+bool render_kernels_self_test(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // RENDER_KERNELS_H
@@ -24,13 +24,59 @@ extern "C" {
 #define RETROSAGA_ERROR_CRYPTO_VALIDATION   -4
 #define RETROSAGA_ERROR_AUDIO_INIT          -5
 #define RETROSAGA_ERROR_MIDI_INIT           -6
+#define RETROSAGA_ERROR_FILE_IO             -7
+#define RETROSAGA_ERROR_CONFIG              -8
 
-// Audio configuration
+// Audio configuration defaults; the active values come from
+// retrosaga_audio_config_t (see audio_config.h for pkg.nlink loading)
 #define RETROSAGA_SAMPLE_RATE    44100
 #define RETROSAGA_BUFFER_SIZE    1024
 #define RETROSAGA_MAX_POLYPHONY  64
 #define RETROSAGA_MAX_CHANNELS   16
 
+// Pipeline modules selectable through [audio_pipeline]
+typedef enum {
+    RETROSAGA_MODULE_INPUT_AUDIO        = 1 << 0,
+    RETROSAGA_MODULE_AUDIO_ENTROPY      = 1 << 1,
+    RETROSAGA_MODULE_PRNG               = 1 << 2,
+    RETROSAGA_MODULE_MIDI_PROCESSING    = 1 << 3,
+    RETROSAGA_MODULE_BIT_SCALER         = 1 << 4,
+    RETROSAGA_MODULE_EFFECT_ENGINE      = 1 << 5,
+    RETROSAGA_MODULE_WAVEFORM_GENERATOR = 1 << 6,
+    RETROSAGA_MODULE_SOUND_OUTPUT       = 1 << 7
+} retrosaga_module_t;
+
+#define RETROSAGA_MODULE_ALL 0xFFu
+
+// Runtime configuration (plain data so it can be cached in binary form)
+typedef struct {
+    // [retrosaga_engine]
+    uint32_t sample_rate;
+    uint32_t buffer_size;
+    uint32_t max_polyphony;
+    uint32_t target_fps;
+
+    // [audio_pipeline]
+    uint32_t module_mask;
+    uint8_t channels;
+    uint8_t bit_depth;
+    float latency_target_ms;
+    uint32_t sub_block_frames;    // Internal render granularity, any host buffer size
+    uint32_t output_sample_rate;  // Device rate for sound_output, 0 = sample_rate
+    uint8_t resampler_quality;    // audio_resampler_quality_t for rate conversion
+
+    // [threading]
+    uint32_t worker_count;
+    bool pin_workers;             // One CPU per render worker, never the render thread's
+    uint32_t queue_depth;
+    uint32_t stack_size_kb;
+    bool work_stealing;
+
+    // [validation]
+    float latency_max_ms;
+    uint32_t memory_pool_mb;
+} retrosaga_audio_config_t;
+
 // MIDI message types
 typedef enum {
     MIDI_NOTE_OFF = 0x80,
@@ -45,7 +91,13 @@ typedef enum {
 
 // Audio processing modules
 int retrosaga_audio_init(void);
+int retrosaga_audio_init_with_config(const retrosaga_audio_config_t* config);
+const retrosaga_audio_config_t* retrosaga_audio_get_config(void);
 int retrosaga_audio_update(float delta_time_ms);
+// Render any number of interleaved frames; the engine works in sub-blocks internally
+int retrosaga_audio_render(float* output, uint32_t frames);
+// True while nothing sounds: no voices, no effect tail, no captured input
+bool retrosaga_audio_is_idle(void);
 void retrosaga_audio_shutdown(void);
 bool retrosaga_audio_validate(void);
 
@@ -55,11 +107,13 @@ int audio_entropy_init(void);
 int prng_module_init(void);
 
 // Processing modules  
+int audio_params_init(void);
 int midi_processing_init(void);
 int bit_scaler_init(void);
 int effect_engine_init(void);
 
 // Output modules
+int voice_manager_init(void);
 int waveform_generator_init(void);
 int sound_output_init(void);
 
@@ -70,6 +124,7 @@ int scale_midi_value(uint32_t value, uint8_t src_bits, uint8_t dst_bits);
 // Waveform generation
 int generate_waveform(float frequency, float amplitude, float* buffer, size_t samples);
 int output_audio_buffer(const float* buffer, size_t samples);
+int output_audio_silence(size_t samples);   // Fast path for blocks known to be zero
 
 // Diagnostic interface
 int retrosaga_audio_diagnose(void);
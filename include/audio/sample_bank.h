@@ -0,0 +1,117 @@
+/*
+ * Sample Bank Header
+ * Memory-mapped PCM sample banks and the sampler voice
+ *
+ * A bank file holds a zone table and the PCM of every zone (16-bit or
+ * 32-bit float, mono) and is mapped read-only and shared, so every engine
+ * in the process and every process on the machine plays from the same
+ * page-cache pages. Opening a file that is already open returns the same
+ * bank with its reference count raised.
+ *
+ * Pages come in lazily. At open, the first SAMPLE_BANK_HEAD_MS of every
+ * zone is faulted in so note attacks never wait on the disk; while voices
+ * play, each publishes the span it will read next on a prefetch cursor and
+ * a background thread touches those pages ahead of the playhead. The audio
+ * thread only ever stores to its cursor.
+ *
+ * File layout, little endian: a 64-byte header ("RSBK", version, zone
+ * count, sample format, data offset and size), zone_count 32-byte
+ * sample_zone_t records, then the sample data at a page-aligned offset.
+ */
+
+#ifndef SAMPLE_BANK_H
+#define SAMPLE_BANK_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "retrosaga_audio.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SAMPLE_BANK_VERSION      1
+#define SAMPLE_BANK_MAX_ZONES    4096
+#define SAMPLE_BANK_HEAD_MS      250    // Faulted in at open for every zone
+#define SAMPLE_BANK_PREFETCH_MS  500    // Kept ahead of each playhead
+#define SAMPLE_BANK_MAX_CURSORS  256
+
+typedef enum {
+    SAMPLE_FORMAT_PCM16 = 1,     // WAVE format tags
+    SAMPLE_FORMAT_FLOAT32 = 3
+} sample_format_t;
+
+// One key/velocity region; also the on-disk record
+typedef struct {
+    uint8_t key_low;
+    uint8_t key_high;
+    uint8_t velocity_low;
+    uint8_t velocity_high;
+    uint8_t root_key;            // Plays at the recorded pitch
+    uint8_t loop;                // 0 = one-shot, 1 = forward loop
+    int16_t tune_cents;
+    uint32_t sample_rate;
+    uint32_t frames;
+    uint32_t loop_start;         // Frames from the zone start, loop_end exclusive
+    uint32_t loop_end;
+    uint64_t offset;             // First frame in the bank's sample data
+} sample_zone_t;
+
+typedef struct sample_bank sample_bank_t;
+
+typedef struct {
+    uint32_t zone_count;
+    sample_format_t format;
+    uint64_t total_frames;
+    size_t mapped_bytes;
+    uint32_t references;
+} sample_bank_info_t;
+
+// Playback state of one sampler voice
+typedef struct {
+    const sample_bank_t* bank;
+    const sample_zone_t* zone;   // NULL when the voice is not a sampler voice
+    const void* data;            // The zone's first frame
+    uint64_t position;           // 32.32 fixed-point frame
+    uint64_t step;               // 32.32 frames per output frame
+    int32_t cursor;              // Prefetch cursor, -1 for none
+} sample_voice_t;
+
+// Lifecycle; open and close are for control threads, never the audio thread
+int sample_bank_open(const char* path, sample_bank_t** bank);
+void sample_bank_close(sample_bank_t* bank);
+void sample_bank_get_info(const sample_bank_t* bank, sample_bank_info_t* info);
+
+// Write a bank file: zones with offsets filled in on the way, and one
+// float array of zones[i].frames per zone, stored in format
+int sample_bank_write(const char* path, const sample_zone_t* zones, const float* const* samples,
+                      uint32_t zone_count, sample_format_t format);
+
+// First zone covering the note and 7-bit velocity, or NULL
+const sample_zone_t* sample_bank_find_zone(const sample_bank_t* bank, uint8_t note, uint8_t velocity);
+
+// Process-unique bank id and zones by index, for engine snapshots
+uint64_t sample_bank_id(const sample_bank_t* bank);
+const sample_zone_t* sample_bank_zone(const sample_bank_t* bank, uint32_t index);
+
+// Prefetch cursors, one per voice; acquire and release at init and shutdown
+int32_t sample_bank_cursor_acquire(void);
+void sample_bank_cursor_release(int32_t cursor);
+
+// Sampler voices: start at the zone's first frame, retune with the played
+// pitch (fractional note) at the engine rate, render with 4-point
+// interpolation; render returns false once a one-shot zone has ended and
+// zero-fills the rest of the block
+void sample_voice_start(sample_voice_t* voice, const sample_bank_t* bank, const sample_zone_t* zone);
+void sample_voice_set_pitch(sample_voice_t* voice, float pitch, float sample_rate);
+bool sample_voice_render(sample_voice_t* voice, float* out, uint32_t frames);
+void sample_voice_stop(sample_voice_t* voice);
+
+bool sample_bank_validate(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SAMPLE_BANK_H
@@ -20,6 +20,12 @@ int sound_output_process(void);
 void sound_output_shutdown(void);
 bool sound_output_validate(void);
 
+// Device backends receive interleaved frames at sound_output_sample_rate(),
+// which is output_sample_rate when set; the engine rate is converted on the way
+typedef void (*sound_output_sink_t)(const float* samples, uint32_t frames, uint8_t channels, void* user);
+void sound_output_set_sink(sound_output_sink_t sink, void* user);
+uint32_t sound_output_sample_rate(void);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,103 @@
+/*
+ * Voice Filter Header
+ * Per-voice resonant filters processed in SIMD lane groups
+ *
+ * Voices are filtered VOICE_FILTER_LANES at a time: voice v lives in lane
+ * v % LANES of group v / LANES, and every group keeps its state and
+ * coefficients as structure-of-arrays so one sample of all lanes is a
+ * single vector operation. The state-variable filter is the Simper
+ * trapezoidal form; the ladder is a zero-delay-feedback cascade of four
+ * trapezoidal one-poles. Lanes select their response through output
+ * mix coefficients, so mixed modes in one group stay branch-free.
+ * Coefficients change only through voice_filter_set(), at control rate.
+ */
+
+#ifndef VOICE_FILTER_H
+#define VOICE_FILTER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "retrosaga_audio.h"
+#include "audio_arena.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define VOICE_FILTER_LANES 4
+
+typedef enum {
+    VOICE_FILTER_OFF = 0,
+    VOICE_FILTER_LOWPASS,       // 12 dB/oct state-variable
+    VOICE_FILTER_BANDPASS,
+    VOICE_FILTER_HIGHPASS,
+    VOICE_FILTER_LADDER,        // 24 dB/oct ladder lowpass
+    VOICE_FILTER_MODE_COUNT
+} voice_filter_mode_t;
+
+typedef struct {
+    // State-variable filter
+    float a1[VOICE_FILTER_LANES];
+    float a2[VOICE_FILTER_LANES];
+    float a3[VOICE_FILTER_LANES];
+    float m0[VOICE_FILTER_LANES];
+    float m1[VOICE_FILTER_LANES];
+    float m2[VOICE_FILTER_LANES];
+    float ic1eq[VOICE_FILTER_LANES];
+    float ic2eq[VOICE_FILTER_LANES];
+
+    // Ladder
+    float G[VOICE_FILTER_LANES];
+    float feedback[VOICE_FILTER_LANES];
+    float solve[VOICE_FILTER_LANES];     // 1 / (1 + k G^4)
+    float ladder_mix[VOICE_FILTER_LANES];
+    float stage[4][VOICE_FILTER_LANES];
+
+    uint32_t enabled_mask;               // Lanes with a live voice
+    uint32_t svf_mask;                   // Enabled lanes using the state-variable path
+    uint32_t ladder_mask;                // Enabled lanes using the ladder path
+} __attribute__((aligned(64))) voice_filter_group_t;
+
+typedef struct {
+    voice_filter_group_t* groups;
+    uint32_t group_count;
+    uint32_t voice_count;
+    uint32_t max_frames;
+    float sample_rate;
+    float* lane_input;                   // max_frames * LANES, lane-interleaved
+    float* lane_output;
+    bool arena_backed;                   // Buffers belong to an arena, not the heap
+} voice_filter_bank_t;
+
+// Buffers come from the arena when one is given, else from the heap
+int voice_filter_bank_init(voice_filter_bank_t* bank, uint32_t voice_count, uint32_t max_frames, float sample_rate,
+                           audio_arena_t* arena);
+void voice_filter_bank_destroy(voice_filter_bank_t* bank);
+
+// Control rate: recompute one voice's coefficients (resonance 0..1)
+void voice_filter_set(voice_filter_bank_t* bank, uint32_t voice, voice_filter_mode_t mode,
+                      float cutoff_hz, float resonance);
+
+// Clear a voice's state at note start; disable it when the voice ends
+void voice_filter_reset_voice(voice_filter_bank_t* bank, uint32_t voice);
+void voice_filter_disable(voice_filter_bank_t* bank, uint32_t voice);
+
+// Filter every enabled voice in place; voice v's frames start at rows + v * row_stride
+void voice_filter_process(voice_filter_bank_t* bank, float* rows, uint32_t row_stride, uint32_t frames);
+
+// Groups [first_group, end_group) only, transposing through caller-owned
+// lane buffers (max_frames * LANES each) so disjoint ranges can run on
+// different threads
+void voice_filter_process_groups(voice_filter_bank_t* bank, float* rows, uint32_t row_stride, uint32_t frames,
+                                 uint32_t first_group, uint32_t end_group, float* lane_input, float* lane_output);
+
+// Map a normalized 0..1 cutoff control to 20 Hz..20 kHz
+float voice_filter_cutoff_hz(float normalized);
+
+bool voice_filter_self_test(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // VOICE_FILTER_H
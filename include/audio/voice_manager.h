@@ -0,0 +1,92 @@
+/*
+ * Voice Manager Header
+ * Polyphonic voice pool and sub-block render engine
+ *
+ * The engine always renders in fixed sub-blocks of
+ * config.sub_block_frames and serves any host buffer size from them, so
+ * oscillator and effect state advance identically however the host
+ * slices its callbacks. Host buffers that are a multiple of the
+ * sub-block are rendered in place with no extra latency.
+ */
+
+#ifndef VOICE_MANAGER_H
+#define VOICE_MANAGER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "retrosaga_audio.h"
+#include "envelope.h"
+#include "voice_filter.h"
+#include "midi_event.h"
+#include "sample_bank.h"
+#include "audio_snapshot.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+    uint32_t active_voices;
+    uint32_t peak_voices;
+    uint64_t voices_started;
+    uint64_t voices_stolen;
+    uint64_t voices_finished;     // Returned to the pool by their envelope
+    uint64_t sub_blocks_rendered;
+    uint64_t parallel_sub_blocks;  // Split across the render workers
+    uint64_t silent_sub_blocks;    // No voices and no effect tail
+    uint64_t frames_rendered;
+} voice_manager_stats_t;
+
+// Module-specific functions
+int voice_manager_init(void);
+int voice_manager_process(void);
+void voice_manager_shutdown(void);
+bool voice_manager_validate(void);
+
+// Voice allocation; when the pool is full the quietest releasing voice
+// is stolen, or the oldest voice if none is releasing
+int voice_manager_note_on(uint8_t channel, uint8_t note, uint8_t velocity);
+int voice_manager_note_off(uint8_t channel, uint8_t note);
+void voice_manager_all_notes_off(void);   // Release every voice
+void voice_manager_all_sound_off(void);   // Silence every voice immediately
+
+// Apply one high-resolution event; queued MIDI input is drained through
+// this at the start of every sub-block
+int voice_manager_apply_event(const midi_event_t* event);
+
+// Per-channel voice settings, applied from the next sub-block; volume,
+// pan and pitch bend come from the smoothed audio_params banks
+int voice_manager_set_program(uint8_t channel, uint8_t program);
+int voice_manager_set_envelope(uint8_t channel, const envelope_params_t* params);
+int voice_manager_set_filter(uint8_t channel, voice_filter_mode_t mode);
+
+// Play the channel's notes from a sample bank instead of its waveform, or
+// NULL to go back; the bank must stay open while voices may use it
+int voice_manager_set_sample_bank(uint8_t channel, const sample_bank_t* bank);
+
+// Render interleaved frames at the configured channel count
+int voice_manager_render(float* output, uint32_t frames);
+
+// As above; *silent reports whether every frame written is zero
+int voice_manager_render_block(float* output, uint32_t frames, bool* silent);
+
+// Split busy sub-blocks across the render workers (worker_count > 1);
+// on by default when the pool has workers
+void voice_manager_set_parallel(bool enabled);
+
+// Drop all voices and any partially consumed sub-block
+void voice_manager_reset(void);
+
+void voice_manager_get_stats(voice_manager_stats_t* stats);
+
+// Engine snapshots: channel settings, active voices with their filter
+// state and any partially consumed sub-block; restore requires the same
+// sample banks on the same channels
+void voice_manager_snapshot_save(audio_snapshot_stream_t* stream);
+bool voice_manager_snapshot_restore(audio_snapshot_stream_t* stream);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // VOICE_MANAGER_H
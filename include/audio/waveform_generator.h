@@ -14,12 +14,26 @@
 extern "C" {
 #endif
 
+// Basic waveform shapes
+typedef enum {
+    WAVEFORM_SINE = 0,
+    WAVEFORM_SAWTOOTH,
+    WAVEFORM_SQUARE,
+    WAVEFORM_TRIANGLE,
+    WAVEFORM_COUNT
+} waveform_type_t;
+
 // Module-specific functions
 int waveform_generator_init(void);
 int waveform_generator_process(void);
 void waveform_generator_shutdown(void);
 bool waveform_generator_validate(void);
 
+// Phase-continuous generation starting at an absolute sample position,
+// so consecutive blocks join without discontinuities
+int generate_waveform_at(waveform_type_t type, float frequency, float amplitude,
+                         uint64_t start_sample, float* buffer, size_t samples);
+
 #ifdef __cplusplus
 }
 #endif
@@ -33,6 +33,7 @@ mkdir -p "$BUILD_DIR" "$OUT_DIR"
 
 # Define source modules in dependency order
 INPUT_MODULES=(
+    "audio_ring.c"
     "input_audio.c"
     "audio_entropy.c"
     "prng_module.c"
@@ -40,16 +41,44 @@ INPUT_MODULES=(
 
 PROCESSING_MODULES=(
     "bit_scaler.c"
+    "audio_params.c"
+    "midi_event.c"
+    "midi_ump.c"
+    "midi_stream.c"
     "midi_processing.c"
+    "midi_file.c"
+    "midi_benchmark.c"
+    "audio_fft.c"
+    "audio_resampler.c"
+    "audio_convolver.c"
     "effect_engine.c"
 )
 
 OUTPUT_MODULES=(
+    "render_kernels.c"
+    "pitch_table.c"
+    "envelope.c"
+    "voice_filter.c"
+    "sample_bank.c"
+    "voice_manager.c"
     "waveform_generator.c"
     "sound_output.c"
+    "audio_recorder.c"
+    "render_benchmark.c"
 )
 
-ALL_MODULES=("${INPUT_MODULES[@]}" "${PROCESSING_MODULES[@]}" "${OUTPUT_MODULES[@]}")
+CORE_MODULES=(
+    "audio_config.c"
+    "audio_trace.c"
+    "audio_arena.c"
+    "audio_workers.c"
+    "retrosaga_audio.c"
+    "audio_regress.c"
+    "audio_snapshot.c"
+    "audio_server.c"
+)
+
+ALL_MODULES=("${INPUT_MODULES[@]}" "${PROCESSING_MODULES[@]}" "${OUTPUT_MODULES[@]}" "${CORE_MODULES[@]}")
 
 # Compiler flags with enhanced audio support
 CFLAGS="-std=c99 -Wall -Werror -O2 -I$INCLUDE_DIR"
@@ -57,7 +86,7 @@ LDFLAGS="-lm -lpthread"
 
 # Add audio library support if available
 if pkg-config --exists alsa; then
-    CFLAGS="$CFLAGS $(pkg-config --cflags alsa)"
+    CFLAGS="$CFLAGS $(pkg-config --cflags alsa) -DRETROSAGA_HAVE_ALSA"
     LDFLAGS="$LDFLAGS $(pkg-config --libs alsa)"
     log_info "ALSA support enabled"
 fi
@@ -68,6 +97,19 @@ if pkg-config --exists libpulse; then
     log_info "PulseAudio support enabled"
 fi
 
+# Stage timers are compiled in only on request (RETROSAGA_TRACE=1)
+if [[ "${RETROSAGA_TRACE:-0}" == "1" ]]; then
+    CFLAGS="$CFLAGS -DRETROSAGA_TRACE"
+    log_info "Stage tracing enabled"
+fi
+
+# Debug check: abort on heap allocation in the render path after init
+if [[ "${RETROSAGA_ARENA_CHECK:-0}" == "1" ]]; then
+    CFLAGS="$CFLAGS -DRETROSAGA_ARENA_CHECK"
+    LDFLAGS="$LDFLAGS -Wl,--wrap=malloc,--wrap=calloc,--wrap=realloc"
+    log_info "Arena allocation check enabled"
+fi
+
 OUTPUT_EXEC="$OUT_DIR/retrosaga_audio_test"
 
 # Compile each module
@@ -90,14 +132,109 @@ done
 
 # Create simple test main for audio subsystem
 cat > "$BUILD_DIR/audio_main.c" << 'EOL'
+#define _DEFAULT_SOURCE
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <unistd.h>
 #include "audio/retrosaga_audio.h"
+#include "audio/input_audio.h"
+#include "audio/audio_regress.h"
+#include "audio/audio_server.h"
+#include <signal.h>
+#include <time.h>
+
+static volatile sig_atomic_t g_stop_serving = 0;
+
+static void stop_serving(int signal_number) {
+    (void)signal_number;
+    g_stop_serving = 1;
+}
+
+// Render server until SIGINT or SIGTERM: --serve <socket>
+static int run_server(const char* path) {
+    if (retrosaga_audio_init() != RETROSAGA_SUCCESS) {
+        printf("ERROR: Failed to initialize audio subsystem\n");
+        return 1;
+    }
+    audio_server_config_t config;
+    audio_server_default_config(&config);
+    config.path = path;
+    if (audio_server_start(&config) != RETROSAGA_SUCCESS) {
+        retrosaga_audio_shutdown();
+        return 1;
+    }
+    signal(SIGINT, stop_serving);
+    signal(SIGTERM, stop_serving);
+    while (!g_stop_serving) {
+        pause();
+    }
+    retrosaga_audio_shutdown();
+    return 0;
+}
+
+// One client session, no engine in this process: --client <socket> [seconds]
+static int run_client(const char* path, double seconds) {
+    audio_server_client_config_t config;
+    audio_server_client_default_config(&config);
+    config.path = path;
+    audio_server_client_t client;
+    if (audio_server_connect(&client, &config) != RETROSAGA_SUCCESS) {
+        printf("ERROR: Cannot connect to %s\n", path);
+        return 1;
+    }
+    uint32_t blocks = (uint32_t)(seconds * client.sample_rate / client.block_frames);
+    double total_us = 0.0, worst_us = 0.0;
+    audio_server_send_midi(&client, 0x90, 60, 100);
+    audio_server_send_midi(&client, 0x90, 67, 90);
+    for (uint32_t b = 0; b < blocks; b++) {
+        if (b == blocks / 2) {
+            audio_server_send_midi(&client, 0x80, 60, 0);
+            audio_server_send_midi(&client, 0x80, 67, 0);
+        }
+        struct timespec start, end;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        if (!audio_server_request(&client) || !audio_server_read_acquire(&client, 1000, NULL)) {
+            printf("ERROR: Session closed after %u blocks\n", b);
+            audio_server_disconnect(&client);
+            return 1;
+        }
+        audio_server_read_release(&client);
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        double us = (double)(end.tv_sec - start.tv_sec) * 1e6 + (double)(end.tv_nsec - start.tv_nsec) / 1e3;
+        total_us += us;
+        worst_us = us > worst_us ? us : worst_us;
+    }
+    printf("%u blocks of %u frames: %.1f us average, %.1f us worst round trip\n", blocks, client.block_frames,
+           blocks ? total_us / blocks : 0.0, worst_us);
+    audio_server_disconnect(&client);
+    return 0;
+}
 
 int main(int argc, char* argv[]) {
     printf("=== RetroSaga Audio Subsystem Test ===\n");
     
+    // Golden-output regression: --regress [--update] [directory]
+    if (argc > 1 && strcmp(argv[1], "--regress") == 0) {
+        bool update = argc > 2 && strcmp(argv[2], "--update") == 0;
+        const char* directory = argc > (update ? 3 : 2) ? argv[update ? 3 : 2] : AUDIO_REGRESS_DEFAULT_DIR;
+        int failures = audio_regress_run(directory, update, NULL);
+        if (failures != 0) {
+            printf("ERROR: Audio regression failed (%d)\n", failures);
+            return 1;
+        }
+        printf("Audio regression passed\n");
+        return 0;
+    }
+    
+    if (argc > 2 && strcmp(argv[1], "--serve") == 0) {
+        return run_server(argv[2]);
+    }
+    if (argc > 2 && strcmp(argv[1], "--client") == 0) {
+        return run_client(argv[2], argc > 3 ? atof(argv[3]) : 5.0);
+    }
+    
     bool diagnose_mode = (argc > 1 && strcmp(argv[1], "--diagnose") == 0);
     
     // Initialize audio subsystem
@@ -118,13 +255,32 @@ int main(int argc, char* argv[]) {
         printf("All audio modules validated successfully\n");
     } else {
         printf("Audio subsystem initialized successfully\n");
+        
+        // Optional capture source: --input <file.wav>
+        if (argc > 2 && strcmp(argv[1], "--input") == 0) {
+            input_audio_config_t input_config;
+            input_audio_default_config(&input_config);
+            input_config.source = INPUT_SOURCE_WAV_FILE;
+            input_config.location = argv[2];
+            if (input_audio_start(&input_config) != RETROSAGA_SUCCESS) {
+                printf("ERROR: Failed to open input %s\n", argv[2]);
+                retrosaga_audio_shutdown();
+                return 1;
+            }
+        }
+        
         printf("Processing audio for 5 seconds...\n");
         
-        // Simulate audio processing
-        for (int i = 0; i < 300; i++) { // 5 seconds at 60 FPS
+        // Simulate a host: control update and one rendered period per frame
+        const retrosaga_audio_config_t* config = retrosaga_audio_get_config();
+        uint32_t period = config->sample_rate / 60;
+        float* period_buffer = malloc((size_t)period * config->channels * sizeof(float));
+        for (int i = 0; i < 300 && period_buffer; i++) { // 5 seconds at 60 FPS
             retrosaga_audio_update(16.67f);
+            retrosaga_audio_render(period_buffer, period);
             usleep(16670); // ~60 FPS
         }
+        free(period_buffer);
     }
     
     retrosaga_audio_shutdown();
@@ -157,4 +313,15 @@ else
     exit 1
 fi
 
+# Golden-output regression against the stored reference renders
+log_info "Running golden-output regression..."
+if (cd "$PROJECT_ROOT" && "$OUTPUT_EXEC" --regress) > "$BUILD_DIR/regress.log" 2>&1; then
+    grep "^\[AUDIO_REGRESS\]" "$BUILD_DIR/regress.log"
+    log_success "Audio regression passed"
+else
+    grep "^\[AUDIO_REGRESS\]" "$BUILD_DIR/regress.log" || tail -20 "$BUILD_DIR/regress.log"
+    log_error "Audio regression failed (update references with: $OUTPUT_EXEC --regress --update)"
+    exit 1
+fi
+
 log_success "Audio subsystem build and validation complete"
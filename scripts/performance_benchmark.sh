@@ -0,0 +1,279 @@
+#!/bin/bash
+# Audio Subsystem Performance Benchmarks
+# Builds the audio modules, then runs the render and MIDI throughput benchmarks
+#
+# Usage: performance_benchmark.sh [options]
+#   --render-only | --midi-only   Run one suite
+#   --json PATH                   Render results (default build/render_benchmark.json)
+#   --baseline PATH               Stored baseline (default benchmarks/render_baseline.json)
+#   --save-baseline               Record this run as the baseline instead of comparing
+#   --tolerance X                 Allowed ns/sample/voice slowdown (default 0.10)
+#   --messages N, --chunk N       MIDI load size and messages per ingest call
+
+set -e
+
+PROJECT_ROOT="$(cd "$(dirname "${BASH_SOURCE[0]}")/.." && pwd)"
+BUILD_DIR="$PROJECT_ROOT/build/audio"
+INCLUDE_DIR="$PROJECT_ROOT/include"
+OUT_DIR="$PROJECT_ROOT/bin/audio"
+
+# Color output
+GREEN='\033[0;32m'
+BLUE='\033[0;34m'
+RED='\033[0;31m'
+NC='\033[0m'
+
+log_info() {
+    echo -e "${BLUE}[AUDIO_BENCH]${NC} $1"
+}
+
+log_success() {
+    echo -e "${GREEN}[AUDIO_BENCH]${NC} $1"
+}
+
+log_error() {
+    echo -e "${RED}[AUDIO_BENCH]${NC} $1"
+}
+
+# Module objects come from the regular build, validated on the way
+log_info "Building audio modules..."
+BUILD_LOG="$PROJECT_ROOT/build/audio-build.log"
+mkdir -p "$PROJECT_ROOT/build"
+# The bench wraps the allocator itself, so the arena check must stay off
+if ! RETROSAGA_ARENA_CHECK=0 bash "$PROJECT_ROOT/scripts/build-audio.sh" > "$BUILD_LOG" 2>&1; then
+    log_error "Audio build failed, see $BUILD_LOG"
+    exit 1
+fi
+
+CFLAGS="-std=c99 -Wall -Werror -O2 -I$INCLUDE_DIR"
+LDFLAGS="-lm -lpthread"
+if pkg-config --exists alsa; then
+    LDFLAGS="$LDFLAGS $(pkg-config --libs alsa)"
+fi
+if pkg-config --exists libpulse; then
+    LDFLAGS="$LDFLAGS $(pkg-config --libs libpulse)"
+fi
+
+# Allocations are counted by wrapping the allocator at link time
+WRAP_FLAGS="-Wl,--wrap=malloc,--wrap=calloc,--wrap=realloc"
+BENCH_EXEC="$OUT_DIR/retrosaga_audio_bench"
+
+cat > "$BUILD_DIR/bench_main.c" << 'EOL'
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "audio/retrosaga_audio.h"
+#include "audio/audio_config.h"
+#include "audio/midi_processing.h"
+#include "audio/midi_benchmark.h"
+#include "audio/render_benchmark.h"
+
+static volatile uint64_t g_allocations = 0;
+
+void* __real_malloc(size_t size);
+void* __real_calloc(size_t count, size_t size);
+void* __real_realloc(void* ptr, size_t size);
+
+void* __wrap_malloc(size_t size) {
+    g_allocations++;
+    return __real_malloc(size);
+}
+
+void* __wrap_calloc(size_t count, size_t size) {
+    g_allocations++;
+    return __real_calloc(count, size);
+}
+
+void* __wrap_realloc(void* ptr, size_t size) {
+    g_allocations++;
+    return __real_realloc(ptr, size);
+}
+
+// Module init/shutdown chatter is hidden while scenarios run
+static int g_saved_stdout = -1;
+
+static void quiet_begin(void) {
+    fflush(stdout);
+    g_saved_stdout = dup(STDOUT_FILENO);
+    int null_fd = open("/dev/null", O_WRONLY);
+    if (null_fd >= 0) {
+        dup2(null_fd, STDOUT_FILENO);
+        close(null_fd);
+    }
+}
+
+static void quiet_end(void) {
+    fflush(stdout);
+    if (g_saved_stdout >= 0) {
+        dup2(g_saved_stdout, STDOUT_FILENO);
+        close(g_saved_stdout);
+        g_saved_stdout = -1;
+    }
+}
+
+static int run_render_suite(const char* json_path, const char* baseline_path, bool save_baseline,
+                            double tolerance) {
+    static render_scenario_t scenarios[RENDER_BENCHMARK_MAX_SCENARIOS];
+    static render_result_t results[RENDER_BENCHMARK_MAX_SCENARIOS];
+    size_t count = render_benchmark_default_suite(scenarios, RENDER_BENCHMARK_MAX_SCENARIOS);
+
+    retrosaga_audio_config_t base;
+    audio_config_defaults(&base);
+
+    printf("\n=== Render: %.1f s of audio per scenario at %u Hz ===\n", RENDER_BENCHMARK_DEFAULT_SECONDS,
+           base.sample_rate);
+    printf("%-28s %10s %14s %10s %10s %10s\n", "scenario", "x realtime", "ns/sample/vox", "p50 ns",
+           "p99 ns", "max ns");
+
+    for (size_t i = 0; i < count; i++) {
+        quiet_begin();
+        int status = render_benchmark_run(&scenarios[i], &base, &results[i]);
+        quiet_end();
+        if (status != RETROSAGA_SUCCESS) {
+            printf("%-28s FAILED (%d)\n", scenarios[i].name, status);
+            return 1;
+        }
+        printf("%-28s %10.1f %14.3f %10u %10u %10u\n", scenarios[i].name, results[i].real_time_factor,
+               results[i].ns_per_sample_voice, results[i].block_p50_ns, results[i].block_p99_ns,
+               results[i].block_max_ns);
+    }
+
+    FILE* json = fopen(json_path, "w");
+    if (!json || render_benchmark_write_json(json, scenarios, results, count) != RETROSAGA_SUCCESS) {
+        printf("ERROR: Cannot write %s\n", json_path);
+        if (json) {
+            fclose(json);
+        }
+        return 1;
+    }
+    fclose(json);
+    printf("Results written to %s\n", json_path);
+
+    if (save_baseline) {
+        FILE* baseline = fopen(baseline_path, "w");
+        if (!baseline || render_benchmark_write_json(baseline, scenarios, results, count) != RETROSAGA_SUCCESS) {
+            printf("ERROR: Cannot write baseline %s\n", baseline_path);
+            if (baseline) {
+                fclose(baseline);
+            }
+            return 1;
+        }
+        fclose(baseline);
+        printf("Baseline saved to %s\n", baseline_path);
+        return 0;
+    }
+
+    printf("\n=== Render vs baseline %s (tolerance %.0f%%) ===\n", baseline_path, 100.0 * tolerance);
+    int regressions = render_benchmark_compare(baseline_path, scenarios, results, count, tolerance);
+    if (regressions < 0) {
+        printf("No baseline found; run with --save-baseline to record one\n");
+        return 0;
+    }
+    printf("%d scenario(s) regressed\n", regressions);
+    return regressions > 0 ? 1 : 0;
+}
+
+static int run_midi_suite(uint32_t messages, uint32_t chunk) {
+    quiet_begin();
+    int status = retrosaga_audio_init();
+    quiet_end();
+    if (status != RETROSAGA_SUCCESS) {
+        printf("ERROR: Failed to initialize audio subsystem\n");
+        return 1;
+    }
+    midi_processing_set_logging(false);
+    midi_benchmark_set_allocation_counter(&g_allocations);
+
+    printf("\n=== MIDI event throughput: %u messages, %u per ingest call ===\n", messages, chunk);
+    printf("%-18s %-12s %12s %9s %9s %9s %9s %7s %7s\n", "load", "path", "events/s",
+           "p50 ns", "p99 ns", "p99.9 ns", "max ns", "allocs", "dropped");
+
+    int failures = 0;
+    for (int load = 0; load < MIDI_LOAD_COUNT; load++) {
+        for (int path = 0; path < MIDI_PATH_COUNT; path++) {
+            midi_benchmark_config_t config = {(midi_load_t)load, (midi_path_t)path, messages, chunk};
+            midi_benchmark_result_t result;
+            if (midi_benchmark_run(&config, &result) != RETROSAGA_SUCCESS) {
+                printf("%-18s %-12s FAILED\n", midi_benchmark_load_name(config.load),
+                       midi_benchmark_path_name(config.path));
+                failures++;
+                continue;
+            }
+            printf("%-18s %-12s %12.0f %9u %9u %9u %9u %7lu %7lu\n", midi_benchmark_load_name(config.load),
+                   midi_benchmark_path_name(config.path), result.events_per_second, result.latency_p50_ns,
+                   result.latency_p99_ns, result.latency_p999_ns, result.latency_max_ns,
+                   (unsigned long)result.allocations, (unsigned long)result.dropped);
+        }
+    }
+
+    midi_processing_set_logging(true);
+    quiet_begin();
+    retrosaga_audio_shutdown();
+    quiet_end();
+    return failures ? 1 : 0;
+}
+
+int main(int argc, char* argv[]) {
+    uint32_t messages = 200000;
+    uint32_t chunk = 64;
+    const char* json_path = "build/render_benchmark.json";
+    const char* baseline_path = "benchmarks/render_baseline.json";
+    double tolerance = RENDER_BENCHMARK_TOLERANCE;
+    bool save_baseline = false;
+    bool render = true;
+    bool midi = true;
+
+    for (int i = 1; i < argc; i++) {
+        bool has_value = i + 1 < argc;
+        if (strcmp(argv[i], "--messages") == 0 && has_value) {
+            messages = (uint32_t)strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--chunk") == 0 && has_value) {
+            chunk = (uint32_t)strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--json") == 0 && has_value) {
+            json_path = argv[++i];
+        } else if (strcmp(argv[i], "--baseline") == 0 && has_value) {
+            baseline_path = argv[++i];
+        } else if (strcmp(argv[i], "--tolerance") == 0 && has_value) {
+            tolerance = strtod(argv[++i], NULL);
+        } else if (strcmp(argv[i], "--save-baseline") == 0) {
+            save_baseline = true;
+        } else if (strcmp(argv[i], "--render-only") == 0) {
+            midi = false;
+        } else if (strcmp(argv[i], "--midi-only") == 0) {
+            render = false;
+        } else {
+            printf("Unknown option: %s\n", argv[i]);
+            return 2;
+        }
+    }
+
+    int failures = 0;
+    if (render) {
+        failures += run_render_suite(json_path, baseline_path, save_baseline, tolerance);
+    }
+    if (midi) {
+        failures += run_midi_suite(messages, chunk);
+    }
+    printf("\n");
+    return failures ? 1 : 0;
+}
+EOL
+
+log_info "Linking benchmark..."
+gcc $CFLAGS -c "$BUILD_DIR/bench_main.c" -o "$BUILD_DIR/bench_main.o"
+MODULE_OBJECTS=$(ls "$BUILD_DIR"/*.o | grep -v -e '/audio_main.o$' -e '/bench_main.o$')
+gcc $MODULE_OBJECTS "$BUILD_DIR/bench_main.o" -o "$BENCH_EXEC" $WRAP_FLAGS $LDFLAGS
+
+log_info "Running benchmarks..."
+cd "$PROJECT_ROOT"
+mkdir -p build benchmarks
+if "$BENCH_EXEC" "$@"; then
+    log_success "Benchmarks complete"
+else
+    log_error "Benchmark run failed or regressed against the baseline"
+    exit 1
+fi
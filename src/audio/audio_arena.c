@@ -0,0 +1,252 @@
+/*
+ * Audio Arena
+ * Cache-aligned arena for engine state and per-block scratch
+ */
+
+#define _DEFAULT_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include "audio/audio_arena.h"
+
+#define ARENA_HUGE_PAGE (2u * 1024u * 1024u)
+#define ARENA_MAX_MB    4096u
+
+static audio_arena_t g_engine_arena = {0};
+
+static const char* const k_page_names[] = {"regular pages", "transparent huge pages", "huge pages"};
+
+static size_t align_up(size_t value, size_t alignment) {
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+int audio_arena_create(audio_arena_t* arena, size_t bytes) {
+    if (!arena || bytes == 0) {
+        return RETROSAGA_ERROR_INVALID_PARAM;
+    }
+
+    memset(arena, 0, sizeof(*arena));
+    size_t capacity = align_up(bytes, ARENA_HUGE_PAGE);
+    void* base = MAP_FAILED;
+
+#ifdef MAP_HUGETLB
+    // Explicit huge pages only exist when the administrator reserved them
+    base = mmap(NULL, capacity, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | MAP_POPULATE,
+                -1, 0);
+    arena->pages = AUDIO_ARENA_PAGES_HUGE;
+#endif
+    if (base == MAP_FAILED) {
+        base = mmap(NULL, capacity, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (base == MAP_FAILED) {
+            return RETROSAGA_ERROR_AUDIO_INIT;
+        }
+        arena->pages = AUDIO_ARENA_PAGES_REGULAR;
+#ifdef MADV_HUGEPAGE
+        if (madvise(base, capacity, MADV_HUGEPAGE) == 0) {
+            arena->pages = AUDIO_ARENA_PAGES_TRANSPARENT_HUGE;
+        }
+#endif
+        // Prefault after the advice so the touches fault in huge pages
+        long page = sysconf(_SC_PAGESIZE);
+        size_t stride = arena->pages == AUDIO_ARENA_PAGES_TRANSPARENT_HUGE ? ARENA_HUGE_PAGE
+                                                                           : (size_t)(page > 0 ? page : 4096);
+        for (size_t offset = 0; offset < capacity; offset += stride) {
+            ((volatile uint8_t*)base)[offset] = 0;
+        }
+    }
+
+    arena->base = base;
+    arena->capacity = capacity;
+    return RETROSAGA_SUCCESS;
+}
+
+void audio_arena_destroy(audio_arena_t* arena) {
+    if (!arena) {
+        return;
+    }
+    if (arena->base) {
+        munmap(arena->base, arena->capacity);
+    }
+    memset(arena, 0, sizeof(*arena));
+}
+
+void* audio_arena_alloc(audio_arena_t* arena, size_t bytes) {
+    if (!arena || !arena->base || arena->sealed) {
+        if (arena) {
+            arena->failed_allocations++;
+        }
+        return NULL;
+    }
+
+    size_t size = align_up(bytes ? bytes : 1, AUDIO_ARENA_ALIGNMENT);
+    if (size > arena->capacity - arena->used) {
+        arena->failed_allocations++;
+        return NULL;
+    }
+
+    // Fresh mappings are already zero and regions are never reused
+    void* region = arena->base + arena->used;
+    arena->used += size;
+    return region;
+}
+
+void audio_arena_scratch_reserve(audio_arena_t* arena, size_t bytes) {
+    arena->scratch_reserved += align_up(bytes, AUDIO_ARENA_ALIGNMENT);
+}
+
+int audio_arena_seal(audio_arena_t* arena) {
+    if (!arena || !arena->base) {
+        return RETROSAGA_ERROR_NOT_INITIALIZED;
+    }
+    if (arena->sealed) {
+        return RETROSAGA_ERROR_ALREADY_INITIALIZED;
+    }
+    if (arena->scratch_reserved > arena->capacity - arena->used) {
+        return RETROSAGA_ERROR_AUDIO_INIT;
+    }
+    arena->scratch_start = arena->used;
+    arena->scratch_used = 0;
+    arena->sealed = true;
+    return RETROSAGA_SUCCESS;
+}
+
+void* audio_arena_scratch_alloc(audio_arena_t* arena, size_t bytes) {
+    size_t size = align_up(bytes ? bytes : 1, AUDIO_ARENA_ALIGNMENT);
+    if (!arena->sealed || size > arena->capacity - arena->scratch_start - arena->scratch_used) {
+        arena->failed_allocations++;
+        return NULL;
+    }
+
+    void* region = arena->base + arena->scratch_start + arena->scratch_used;
+    arena->scratch_used += size;
+    if (arena->scratch_used > arena->scratch_peak) {
+        arena->scratch_peak = arena->scratch_used;
+    }
+    return region;
+}
+
+void audio_arena_scratch_reset(audio_arena_t* arena) {
+    arena->scratch_used = 0;
+}
+
+// ---------------------------------------------------------------------------
+// Engine arena
+// ---------------------------------------------------------------------------
+
+int audio_arena_init(const retrosaga_audio_config_t* config) {
+    if (g_engine_arena.base) {
+        return RETROSAGA_ERROR_ALREADY_INITIALIZED;
+    }
+    if (!config || config->memory_pool_mb == 0 || config->memory_pool_mb > ARENA_MAX_MB) {
+        return RETROSAGA_ERROR_INVALID_PARAM;
+    }
+
+    int status = audio_arena_create(&g_engine_arena, (size_t)config->memory_pool_mb * 1024u * 1024u);
+    if (status != RETROSAGA_SUCCESS) {
+        printf("[AUDIO_ARENA] ERROR: Cannot map a %u MB arena\n", config->memory_pool_mb);
+        return status;
+    }
+
+    printf("[AUDIO_ARENA] %u MB arena on %s\n", config->memory_pool_mb, k_page_names[g_engine_arena.pages]);
+    return RETROSAGA_SUCCESS;
+}
+
+void audio_arena_shutdown(void) {
+    if (!g_engine_arena.base) {
+        return;
+    }
+
+    printf("[AUDIO_ARENA] Persistent: %zu KB, scratch peak: %zu KB, failed allocations: %lu\n",
+           g_engine_arena.used / 1024, g_engine_arena.scratch_peak / 1024,
+           (unsigned long)g_engine_arena.failed_allocations);
+    audio_arena_destroy(&g_engine_arena);
+}
+
+audio_arena_t* audio_arena_engine(void) {
+    return g_engine_arena.base ? &g_engine_arena : NULL;
+}
+
+bool audio_arena_validate(void) {
+    audio_arena_t arena;
+    if (audio_arena_create(&arena, 1) != RETROSAGA_SUCCESS) {
+        printf("[AUDIO_ARENA] ERROR: Cannot map a test arena\n");
+        return false;
+    }
+
+    bool valid = true;
+    uint8_t* first = audio_arena_alloc(&arena, 3);
+    uint8_t* second = audio_arena_alloc(&arena, 100);
+    valid &= first && second && ((uintptr_t)first % AUDIO_ARENA_ALIGNMENT) == 0 &&
+             ((uintptr_t)second % AUDIO_ARENA_ALIGNMENT) == 0 && second - first == AUDIO_ARENA_ALIGNMENT;
+    valid &= second && second[99] == 0;
+    valid &= audio_arena_alloc(&arena, arena.capacity) == NULL;
+
+    audio_arena_scratch_reserve(&arena, 1024);
+    valid &= audio_arena_seal(&arena) == RETROSAGA_SUCCESS;
+    valid &= audio_arena_alloc(&arena, 16) == NULL;
+
+    // Scratch starts after the persistent regions and rewinds on reset
+    uint8_t* scratch = audio_arena_scratch_alloc(&arena, 1000);
+    uint8_t* next = audio_arena_scratch_alloc(&arena, 8);
+    valid &= scratch && scratch >= second + AUDIO_ARENA_ALIGNMENT * 2 && next == scratch + 1024;
+    audio_arena_scratch_reset(&arena);
+    valid &= audio_arena_scratch_alloc(&arena, 8) == scratch && arena.scratch_peak == 1088;
+    audio_arena_destroy(&arena);
+
+    if (!valid) {
+        printf("[AUDIO_ARENA] ERROR: Arena alignment or scratch rewind mismatch\n");
+    }
+    return valid;
+}
+
+// ---------------------------------------------------------------------------
+// Allocation check
+// ---------------------------------------------------------------------------
+
+#ifdef RETROSAGA_ARENA_CHECK
+
+void* __real_malloc(size_t size);
+void* __real_calloc(size_t count, size_t size);
+void* __real_realloc(void* ptr, size_t size);
+void* __wrap_malloc(size_t size);
+void* __wrap_calloc(size_t count, size_t size);
+void* __wrap_realloc(void* ptr, size_t size);
+
+static __thread uint32_t t_rt_depth = 0;
+
+void audio_arena_rt_enter(void) {
+    t_rt_depth++;
+}
+
+void audio_arena_rt_leave(void) {
+    t_rt_depth--;
+}
+
+static void check_allocation(const char* function, size_t bytes) {
+    if (t_rt_depth > 0 && g_engine_arena.sealed) {
+        t_rt_depth = 0;
+        fflush(stdout);
+        fprintf(stderr, "[AUDIO_ARENA] FATAL: %s(%zu) on the audio thread after init\n", function, bytes);
+        abort();
+    }
+}
+
+void* __wrap_malloc(size_t size) {
+    check_allocation("malloc", size);
+    return __real_malloc(size);
+}
+
+void* __wrap_calloc(size_t count, size_t size) {
+    check_allocation("calloc", count * size);
+    return __real_calloc(count, size);
+}
+
+void* __wrap_realloc(void* ptr, size_t size) {
+    check_allocation("realloc", size);
+    return __real_realloc(ptr, size);
+}
+
+#endif
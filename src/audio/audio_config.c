@@ -0,0 +1,574 @@
+/*
+ * Audio Configuration
+ * Runtime pipeline configuration from pkg.nlink
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <errno.h>
+#include <sys/stat.h>
+#include "audio/audio_config.h"
+#include "audio/audio_resampler.h"
+
+#define CONFIG_MAX_LINE   512
+#define CONFIG_MAX_PATH   1024
+#define CONFIG_CACHE_MAGIC   0x43415352u // "RSAC"
+#define CONFIG_CACHE_VERSION 4u
+
+typedef enum {
+    SECTION_OTHER = 0,
+    SECTION_ENGINE,
+    SECTION_PIPELINE,
+    SECTION_THREADING,
+    SECTION_VALIDATION
+} config_section_t;
+
+// Module table mirroring the AudioModule type/category enums of the schema
+typedef struct {
+    const char* name;
+    const char* type;
+    const char* category;
+    uint32_t mask;
+} module_rule_t;
+
+static const module_rule_t k_module_rules[] = {
+    {"input_audio",        "input",      "audio_input",  RETROSAGA_MODULE_INPUT_AUDIO},
+    {"audio_entropy",      "input",      "entropy",      RETROSAGA_MODULE_AUDIO_ENTROPY},
+    {"prng_module",        "input",      "prng",         RETROSAGA_MODULE_PRNG},
+    {"midi_processing",    "processing", "midi",         RETROSAGA_MODULE_MIDI_PROCESSING},
+    {"bit_scaler",         "processing", "scaling",      RETROSAGA_MODULE_BIT_SCALER},
+    {"effect_engine",      "processing", "effects",      RETROSAGA_MODULE_EFFECT_ENGINE},
+    {"waveform_generator", "output",     "waveform",     RETROSAGA_MODULE_WAVEFORM_GENERATOR},
+    {"sound_output",       "output",     "audio_output", RETROSAGA_MODULE_SOUND_OUTPUT},
+};
+
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t config_size;
+    uint32_t checksum;
+    uint64_t source_size;
+    uint64_t source_inode;
+    int64_t source_mtime_sec;
+    int64_t source_mtime_nsec;
+} config_cache_header_t;
+
+typedef struct {
+    const char* path;
+    int line;
+    int errors;
+    bool have_module_lists;
+    uint32_t module_mask;
+} parse_context_t;
+
+static const retrosaga_audio_config_t k_default_config = RETROSAGA_AUDIO_CONFIG_DEFAULT;
+
+void audio_config_defaults(retrosaga_audio_config_t* config) {
+    *config = k_default_config;
+}
+
+// ---------------------------------------------------------------------------
+// Value parsing
+// ---------------------------------------------------------------------------
+
+static char* trim(char* text) {
+    while (isspace((unsigned char)*text)) {
+        text++;
+    }
+    char* end = text + strlen(text);
+    while (end > text && isspace((unsigned char)end[-1])) {
+        *--end = '\0';
+    }
+    return text;
+}
+
+static void config_error(parse_context_t* ctx, const char* key, const char* message) {
+    printf("[AUDIO_CONFIG] ERROR: %s:%d: %s: %s\n", ctx->path, ctx->line, key, message);
+    ctx->errors++;
+}
+
+static bool parse_uint(parse_context_t* ctx, const char* key, const char* value, uint32_t* out) {
+    char* end = NULL;
+    errno = 0;
+    unsigned long parsed = strtoul(value, &end, 10);
+    if (errno != 0 || end == value || *end != '\0' || value[0] == '-' || parsed > UINT32_MAX) {
+        config_error(ctx, key, "expected a non-negative integer");
+        return false;
+    }
+    *out = (uint32_t)parsed;
+    return true;
+}
+
+static bool parse_float(parse_context_t* ctx, const char* key, const char* value, float* out) {
+    char* end = NULL;
+    errno = 0;
+    float parsed = strtof(value, &end);
+    if (errno != 0 || end == value || *end != '\0') {
+        config_error(ctx, key, "expected a number");
+        return false;
+    }
+    *out = parsed;
+    return true;
+}
+
+static bool parse_bool(parse_context_t* ctx, const char* key, const char* value, bool* out) {
+    if (strcmp(value, "true") == 0) {
+        *out = true;
+    } else if (strcmp(value, "false") == 0) {
+        *out = false;
+    } else {
+        config_error(ctx, key, "expected true or false");
+        return false;
+    }
+    return true;
+}
+
+// Module lists look like ["input_audio", "audio_entropy"]; each name must
+// be a known module whose schema type matches the list it appears in
+static void parse_module_list(parse_context_t* ctx, const char* key, char* value, const char* type) {
+    if (value[0] != '[' || value[strlen(value) - 1] != ']') {
+        config_error(ctx, key, "expected a [\"module\", ...] list");
+        return;
+    }
+
+    char* cursor = value + 1;
+    while ((cursor = strchr(cursor, '"')) != NULL) {
+        char* name = cursor + 1;
+        char* close = strchr(name, '"');
+        if (!close) {
+            config_error(ctx, key, "unterminated module name");
+            return;
+        }
+        *close = '\0';
+        cursor = close + 1;
+
+        const module_rule_t* rule = NULL;
+        for (size_t i = 0; i < sizeof(k_module_rules) / sizeof(k_module_rules[0]); i++) {
+            if (strcmp(k_module_rules[i].name, name) == 0) {
+                rule = &k_module_rules[i];
+                break;
+            }
+        }
+
+        if (!rule) {
+            printf("[AUDIO_CONFIG] ERROR: %s:%d: %s: unknown module \"%s\"\n", ctx->path, ctx->line, key, name);
+            ctx->errors++;
+        } else if (strcmp(rule->type, type) != 0) {
+            printf("[AUDIO_CONFIG] ERROR: %s:%d: %s: module \"%s\" has type %s, not %s\n",
+                   ctx->path, ctx->line, key, name, rule->type, type);
+            ctx->errors++;
+        } else {
+            ctx->module_mask |= rule->mask;
+        }
+    }
+
+    ctx->have_module_lists = true;
+}
+
+static void apply_key(parse_context_t* ctx, config_section_t section, const char* key, char* value,
+                      retrosaga_audio_config_t* config) {
+    uint32_t number = 0;
+
+    switch (section) {
+        case SECTION_ENGINE:
+            if (strcmp(key, "audio_sample_rate") == 0) {
+                parse_uint(ctx, key, value, &config->sample_rate);
+            } else if (strcmp(key, "audio_buffer_size") == 0) {
+                parse_uint(ctx, key, value, &config->buffer_size);
+            } else if (strcmp(key, "midi_polyphony") == 0) {
+                parse_uint(ctx, key, value, &config->max_polyphony);
+            } else if (strcmp(key, "target_fps") == 0) {
+                parse_uint(ctx, key, value, &config->target_fps);
+            }
+            break;
+
+        case SECTION_PIPELINE:
+            if (strcmp(key, "input_modules") == 0) {
+                parse_module_list(ctx, key, value, "input");
+            } else if (strcmp(key, "processing_modules") == 0) {
+                parse_module_list(ctx, key, value, "processing");
+            } else if (strcmp(key, "output_modules") == 0) {
+                parse_module_list(ctx, key, value, "output");
+            } else if (strcmp(key, "channels") == 0) {
+                if (parse_uint(ctx, key, value, &number)) {
+                    config->channels = (uint8_t)(number > 255 ? 255 : number);
+                }
+            } else if (strcmp(key, "bit_depth") == 0) {
+                if (parse_uint(ctx, key, value, &number)) {
+                    config->bit_depth = (uint8_t)(number > 255 ? 255 : number);
+                }
+            } else if (strcmp(key, "latency_target_ms") == 0) {
+                parse_float(ctx, key, value, &config->latency_target_ms);
+            } else if (strcmp(key, "sub_block_frames") == 0) {
+                parse_uint(ctx, key, value, &config->sub_block_frames);
+            } else if (strcmp(key, "output_sample_rate") == 0) {
+                parse_uint(ctx, key, value, &config->output_sample_rate);
+            } else if (strcmp(key, "resampler_quality") == 0) {
+                audio_resampler_quality_t quality;
+                if (audio_resampler_parse_quality(value, &quality)) {
+                    config->resampler_quality = (uint8_t)quality;
+                } else {
+                    config_error(ctx, key, "expected \"fast\", \"balanced\" or \"best\"");
+                }
+            }
+            break;
+
+        case SECTION_THREADING:
+            if (strcmp(key, "worker_count") == 0) {
+                parse_uint(ctx, key, value, &config->worker_count);
+            } else if (strcmp(key, "pin_workers") == 0) {
+                parse_bool(ctx, key, value, &config->pin_workers);
+            } else if (strcmp(key, "queue_depth") == 0) {
+                parse_uint(ctx, key, value, &config->queue_depth);
+            } else if (strcmp(key, "stack_size_kb") == 0) {
+                parse_uint(ctx, key, value, &config->stack_size_kb);
+            } else if (strcmp(key, "enable_work_stealing") == 0) {
+                parse_bool(ctx, key, value, &config->work_stealing);
+            }
+            break;
+
+        case SECTION_VALIDATION:
+            if (strcmp(key, "audio_latency_max_ms") == 0) {
+                parse_float(ctx, key, value, &config->latency_max_ms);
+            } else if (strcmp(key, "memory_pool_mb") == 0) {
+                parse_uint(ctx, key, value, &config->memory_pool_mb);
+            }
+            break;
+
+        default:
+            break;
+    }
+}
+
+static config_section_t section_from_name(const char* name) {
+    if (strcmp(name, "retrosaga_engine") == 0) {
+        return SECTION_ENGINE;
+    }
+    if (strcmp(name, "audio_pipeline") == 0) {
+        return SECTION_PIPELINE;
+    }
+    if (strcmp(name, "threading") == 0) {
+        return SECTION_THREADING;
+    }
+    if (strcmp(name, "validation") == 0) {
+        return SECTION_VALIDATION;
+    }
+    return SECTION_OTHER;
+}
+
+static int parse_stream(FILE* file, const char* path, retrosaga_audio_config_t* config) {
+    parse_context_t ctx = {path, 0, 0, false, 0};
+    config_section_t section = SECTION_OTHER;
+    char buffer[CONFIG_MAX_LINE];
+
+    audio_config_defaults(config);
+
+    while (fgets(buffer, sizeof(buffer), file)) {
+        ctx.line++;
+
+        char* comment = strpbrk(buffer, "#;");
+        if (comment) {
+            *comment = '\0';
+        }
+        char* line = trim(buffer);
+        if (line[0] == '\0') {
+            continue;
+        }
+
+        if (line[0] == '[') {
+            char* close = strchr(line, ']');
+            if (!close) {
+                config_error(&ctx, line, "unterminated section header");
+                continue;
+            }
+            *close = '\0';
+            section = section_from_name(trim(line + 1));
+            continue;
+        }
+
+        char* equals = strchr(line, '=');
+        if (!equals) {
+            config_error(&ctx, line, "expected key = value");
+            continue;
+        }
+        *equals = '\0';
+        char* key = trim(line);
+        char* value = trim(equals + 1);
+
+        // Scalars may be quoted
+        size_t length = strlen(value);
+        if (length >= 2 && value[0] == '"' && value[length - 1] == '"') {
+            value[length - 1] = '\0';
+            value++;
+        }
+
+        apply_key(&ctx, section, key, value, config);
+    }
+
+    if (ctx.have_module_lists) {
+        config->module_mask = ctx.module_mask;
+    }
+
+    if (ctx.errors > 0) {
+        return RETROSAGA_ERROR_CONFIG;
+    }
+    return audio_config_validate(config);
+}
+
+int audio_config_parse_file(const char* path, retrosaga_audio_config_t* config) {
+    if (!path || !config) {
+        return RETROSAGA_ERROR_INVALID_PARAM;
+    }
+
+    FILE* file = fopen(path, "r");
+    if (!file) {
+        printf("[AUDIO_CONFIG] ERROR: Cannot open %s: %s\n", path, strerror(errno));
+        return RETROSAGA_ERROR_FILE_IO;
+    }
+
+    int result = parse_stream(file, path, config);
+    fclose(file);
+    return result;
+}
+
+// ---------------------------------------------------------------------------
+// Schema validation
+// ---------------------------------------------------------------------------
+
+static void rule_error(int* errors, const char* field, const char* rule) {
+    printf("[AUDIO_CONFIG] ERROR: %s violates schema %s: %s\n", field, AUDIO_CONFIG_SCHEMA_VERSION, rule);
+    (*errors)++;
+}
+
+int audio_config_validate(const retrosaga_audio_config_t* config) {
+    int errors = 0;
+
+    // PipelineConfiguration (schemas/audio/pipeline-v1.0.0.json)
+    if (config->sample_rate < AUDIO_CONFIG_MIN_SAMPLE_RATE || config->sample_rate > AUDIO_CONFIG_MAX_SAMPLE_RATE) {
+        rule_error(&errors, "sample_rate", "must be 8000..192000");
+    }
+    if (config->buffer_size == 0 || config->buffer_size > AUDIO_CONFIG_MAX_BUFFER_SIZE) {
+        rule_error(&errors, "buffer_size", "must be 1..8192");
+    }
+    if (config->bit_depth != 16 && config->bit_depth != 24 && config->bit_depth != 32) {
+        rule_error(&errors, "bit_depth", "enum [16, 24, 32]");
+    }
+    if (config->channels < 1 || config->channels > 8) {
+        rule_error(&errors, "channels", "minimum 1, maximum 8");
+    }
+    if (config->latency_target_ms < 1.0f || config->latency_target_ms > 100.0f) {
+        rule_error(&errors, "latency_target_ms", "minimum 1.0, maximum 100.0");
+    }
+
+    // Sub-blocks must match a specialized render kernel size
+    uint32_t sub_block = config->sub_block_frames;
+    if (sub_block < AUDIO_CONFIG_MIN_SUB_BLOCK || sub_block > AUDIO_CONFIG_MAX_SUB_BLOCK ||
+        (sub_block & (sub_block - 1)) != 0) {
+        rule_error(&errors, "sub_block_frames", "power of two, 32..1024");
+    }
+
+    // A device rate other than the engine rate is converted by sound_output
+    if (config->output_sample_rate != 0 && (config->output_sample_rate < AUDIO_CONFIG_MIN_SAMPLE_RATE ||
+                                            config->output_sample_rate > AUDIO_CONFIG_MAX_SAMPLE_RATE)) {
+        rule_error(&errors, "output_sample_rate", "0 or 8000..192000");
+    }
+    if (config->resampler_quality >= AUDIO_RESAMPLER_QUALITY_COUNT) {
+        rule_error(&errors, "resampler_quality", "enum [fast, balanced, best]");
+    }
+
+    // SynthesisConfiguration.polyphony (schemas/midi/protocol-v1.0.0.json)
+    if (config->max_polyphony < 1 || config->max_polyphony > 128) {
+        rule_error(&errors, "max_polyphony", "minimum 1, maximum 128");
+    }
+
+    // Engine limits
+    if (config->worker_count < 1 || config->worker_count > 64) {
+        rule_error(&errors, "worker_count", "must be 1..64");
+    }
+    if (config->target_fps == 0) {
+        rule_error(&errors, "target_fps", "must be positive");
+    }
+    if (config->memory_pool_mb < 1 || config->memory_pool_mb > 4096) {
+        rule_error(&errors, "memory_pool_mb", "must be 1..4096");
+    }
+    if ((config->module_mask & ~RETROSAGA_MODULE_ALL) != 0) {
+        rule_error(&errors, "module_mask", "unknown module bits");
+    }
+
+    if (errors > 0) {
+        return RETROSAGA_ERROR_CONFIG;
+    }
+
+    float block_ms = 1000.0f * config->buffer_size / config->sample_rate;
+    if (block_ms > config->latency_max_ms) {
+        printf("[AUDIO_CONFIG] WARNING: %u-sample buffer is %.1f ms, above the %.1f ms latency budget\n",
+               config->buffer_size, block_ms, config->latency_max_ms);
+    }
+    float sub_block_ms = 1000.0f * sub_block / config->sample_rate;
+    if (sub_block_ms > config->latency_max_ms) {
+        printf("[AUDIO_CONFIG] WARNING: %u-sample sub-block is %.1f ms, above the %.1f ms latency budget\n",
+               sub_block, sub_block_ms, config->latency_max_ms);
+    }
+
+    return RETROSAGA_SUCCESS;
+}
+
+// ---------------------------------------------------------------------------
+// Binary cache
+// ---------------------------------------------------------------------------
+
+static uint32_t fnv1a(const void* data, size_t size) {
+    const uint8_t* bytes = data;
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < size; i++) {
+        hash = (hash ^ bytes[i]) * 16777619u;
+    }
+    return hash;
+}
+
+static void fill_cache_header(config_cache_header_t* header, const struct stat* source,
+                              const retrosaga_audio_config_t* config) {
+    memset(header, 0, sizeof(*header));
+    header->magic = CONFIG_CACHE_MAGIC;
+    header->version = CONFIG_CACHE_VERSION;
+    header->config_size = sizeof(retrosaga_audio_config_t);
+    header->source_size = (uint64_t)source->st_size;
+    header->source_inode = (uint64_t)source->st_ino;
+    header->source_mtime_sec = (int64_t)source->st_mtim.tv_sec;
+    header->source_mtime_nsec = (int64_t)source->st_mtim.tv_nsec;
+    header->checksum = config ? fnv1a(config, sizeof(*config)) : 0;
+}
+
+static bool read_cache(const char* cache_path, const struct stat* source, retrosaga_audio_config_t* config) {
+    FILE* file = fopen(cache_path, "rb");
+    if (!file) {
+        return false;
+    }
+
+    config_cache_header_t stored;
+    config_cache_header_t expected;
+    retrosaga_audio_config_t cached;
+    bool ok = fread(&stored, sizeof(stored), 1, file) == 1 && fread(&cached, sizeof(cached), 1, file) == 1;
+    fclose(file);
+    if (!ok) {
+        return false;
+    }
+
+    fill_cache_header(&expected, source, &cached);
+    if (memcmp(&stored, &expected, sizeof(stored)) != 0) {
+        return false;
+    }
+
+    *config = cached;
+    return true;
+}
+
+static void write_cache(const char* cache_path, const struct stat* source, const retrosaga_audio_config_t* config) {
+    char temp_path[CONFIG_MAX_PATH];
+    if (snprintf(temp_path, sizeof(temp_path), "%s.tmp", cache_path) >= (int)sizeof(temp_path)) {
+        return;
+    }
+
+    FILE* file = fopen(temp_path, "wb");
+    if (!file) {
+        return; // Read-only deployments simply parse every time
+    }
+
+    config_cache_header_t header;
+    fill_cache_header(&header, source, config);
+    bool ok = fwrite(&header, sizeof(header), 1, file) == 1 && fwrite(config, sizeof(*config), 1, file) == 1;
+    ok &= (fclose(file) == 0);
+
+    // Rename so concurrent starters never observe a partial cache
+    if (!ok || rename(temp_path, cache_path) != 0) {
+        remove(temp_path);
+    }
+}
+
+int audio_config_load(const char* path, const char* cache_path, retrosaga_audio_config_t* config) {
+    if (!path || !config) {
+        return RETROSAGA_ERROR_INVALID_PARAM;
+    }
+
+    struct stat source;
+    if (stat(path, &source) != 0) {
+        printf("[AUDIO_CONFIG] ERROR: Cannot stat %s: %s\n", path, strerror(errno));
+        return RETROSAGA_ERROR_FILE_IO;
+    }
+
+    char derived_path[CONFIG_MAX_PATH];
+    if (!cache_path) {
+        if (snprintf(derived_path, sizeof(derived_path), "%s%s", path, AUDIO_CONFIG_CACHE_SUFFIX) >=
+            (int)sizeof(derived_path)) {
+            return audio_config_parse_file(path, config);
+        }
+        cache_path = derived_path;
+    }
+
+    if (read_cache(cache_path, &source, config)) {
+        return RETROSAGA_SUCCESS;
+    }
+
+    int result = audio_config_parse_file(path, config);
+    if (result == RETROSAGA_SUCCESS) {
+        write_cache(cache_path, &source, config);
+    }
+    return result;
+}
+
+// ---------------------------------------------------------------------------
+// Self test
+// ---------------------------------------------------------------------------
+
+static int parse_text(const char* text, retrosaga_audio_config_t* config) {
+    FILE* file = tmpfile();
+    if (!file) {
+        return RETROSAGA_ERROR_FILE_IO;
+    }
+    fputs(text, file);
+    rewind(file);
+    int result = parse_stream(file, "<self-test>", config);
+    fclose(file);
+    return result;
+}
+
+bool audio_config_self_test(void) {
+    retrosaga_audio_config_t config;
+
+    static const char* valid_text =
+        "[retrosaga_engine]\n"
+        "audio_sample_rate = 48000\n"
+        "audio_buffer_size = 64   # low-latency deployment\n"
+        "[audio_pipeline]\n"
+        "input_modules = [\"input_audio\"]\n"
+        "processing_modules = [\"midi_processing\", \"effect_engine\"]\n"
+        "output_modules = [\"waveform_generator\", \"sound_output\"]\n"
+        "channels = 1\n"
+        "sub_block_frames = 64\n"
+        "output_sample_rate = 48000\n"
+        "resampler_quality = \"best\"\n"
+        "[threading]\n"
+        "worker_count = 2\n"
+        "pin_workers = false\n";
+
+    if (parse_text(valid_text, &config) != RETROSAGA_SUCCESS || config.sample_rate != 48000 ||
+        config.buffer_size != 64 || config.channels != 1 || config.sub_block_frames != 64 ||
+        config.output_sample_rate != 48000 || config.resampler_quality != AUDIO_RESAMPLER_BEST ||
+        config.worker_count != 2 || config.pin_workers ||
+        config.module_mask != (RETROSAGA_MODULE_INPUT_AUDIO | RETROSAGA_MODULE_MIDI_PROCESSING |
+                               RETROSAGA_MODULE_EFFECT_ENGINE | RETROSAGA_MODULE_WAVEFORM_GENERATOR |
+                               RETROSAGA_MODULE_SOUND_OUTPUT)) {
+        return false;
+    }
+
+    // Schema violations must be rejected
+    printf("[AUDIO_CONFIG] Expecting schema violations from the self test:\n");
+    bool range_rejected = parse_text("[audio_pipeline]\nchannels = 9\n", &config) == RETROSAGA_ERROR_CONFIG;
+    bool type_rejected = parse_text("[audio_pipeline]\noutput_modules = [\"input_audio\"]\n", &config) ==
+                         RETROSAGA_ERROR_CONFIG;
+    return range_rejected && type_rejected;
+}
@@ -0,0 +1,361 @@
+/*
+ * Audio Convolver
+ * Zero-latency non-uniformly partitioned FFT convolution
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "audio/audio_convolver.h"
+
+static void* aligned_calloc(audio_arena_t* arena, size_t size, size_t* total) {
+    void* memory = NULL;
+    if (arena) {
+        memory = audio_arena_alloc(arena, size);
+    } else if (posix_memalign(&memory, 64, size) == 0) {
+        memset(memory, 0, size);
+    }
+    if (memory) {
+        *total += size;
+    }
+    return memory;
+}
+
+// Spectra are padded to whole cache lines so every partition starts on one
+static uint32_t spectrum_stride(const audio_fft_t* fft) {
+    return (audio_fft_spectrum_floats(fft) + 15u) & ~15u;
+}
+
+static int level_init(audio_convolver_level_t* level, const float* ir, uint32_t ir_frames, uint32_t ir_stride,
+                      uint32_t partition, uint32_t offset, uint32_t end, audio_arena_t* arena, size_t* total) {
+    level->partition = partition;
+    level->offset = offset;
+    level->parts = (end - offset + partition - 1) / partition;
+
+    int status = audio_fft_init(&level->fft, 2 * partition, arena);
+    if (status != RETROSAGA_SUCCESS) {
+        return status;
+    }
+
+    const uint32_t stride = spectrum_stride(&level->fft);
+    level->window = aligned_calloc(arena, (size_t)2 * partition * sizeof(float), total);
+    level->spectra = aligned_calloc(arena, (size_t)level->parts * stride * sizeof(float), total);
+    level->filter = aligned_calloc(arena, (size_t)level->parts * stride * sizeof(float), total);
+    level->work = aligned_calloc(arena, (size_t)stride * sizeof(float), total);
+    level->output = offset ? aligned_calloc(arena, (size_t)partition * sizeof(float), total) : NULL;
+    if (!level->window || !level->spectra || !level->filter || !level->work || (offset && !level->output)) {
+        return RETROSAGA_ERROR_AUDIO_INIT;
+    }
+
+    // Each partition is P taps followed by P zeros, as overlap-save needs
+    for (uint32_t p = 0; p < level->parts; p++) {
+        memset(level->window, 0, (size_t)2 * partition * sizeof(float));
+        for (uint32_t j = 0; j < partition; j++) {
+            uint32_t tap = offset + p * partition + j;
+            if (tap >= end || tap >= ir_frames) {
+                break;
+            }
+            level->window[j] = ir[(size_t)tap * ir_stride];
+        }
+        audio_fft_forward(&level->fft, level->window, level->filter + (size_t)p * stride);
+    }
+    memset(level->window, 0, (size_t)2 * partition * sizeof(float));
+    return RETROSAGA_SUCCESS;
+}
+
+int audio_convolver_init(audio_convolver_t* conv, const float* ir, uint32_t ir_frames, uint32_t ir_stride,
+                         uint32_t block_frames, audio_arena_t* arena) {
+    if (!conv || !ir || ir_frames == 0 || ir_stride == 0 || block_frames < AUDIO_FFT_MIN_SIZE ||
+        block_frames > AUDIO_CONVOLVER_MAX_PARTITION || (block_frames & (block_frames - 1)) != 0) {
+        return RETROSAGA_ERROR_INVALID_PARAM;
+    }
+
+    memset(conv, 0, sizeof(*conv));
+    conv->block_frames = block_frames;
+    conv->ir_frames = ir_frames;
+    conv->arena_backed = arena != NULL;
+
+    uint32_t max_partition = block_frames * AUDIO_CONVOLVER_MAX_GROWTH;
+    if (max_partition > AUDIO_CONVOLVER_MAX_PARTITION || max_partition < block_frames) {
+        max_partition = AUDIO_CONVOLVER_MAX_PARTITION;
+    }
+
+    // The head covers [0, 8B); level k covers [2P, 8P) with partitions of
+    // P, and the level whose successor would outgrow the cap takes the rest
+    uint32_t partition = block_frames;
+    uint32_t offset = 0;
+    for (;;) {
+        uint64_t next = (uint64_t)partition * AUDIO_CONVOLVER_LEVEL_RATIO;
+        bool last = next > max_partition || conv->level_count + 1 == AUDIO_CONVOLVER_MAX_LEVELS;
+        uint32_t end = last || 2 * next >= ir_frames ? ir_frames : (uint32_t)(2 * next);
+
+        int status = level_init(&conv->levels[conv->level_count], ir, ir_frames, ir_stride, partition, offset, end,
+                                arena, &conv->bytes);
+        conv->level_count++;
+        if (status != RETROSAGA_SUCCESS) {
+            audio_convolver_destroy(conv);
+            return status;
+        }
+        if (end == ir_frames) {
+            break;
+        }
+        partition = (uint32_t)next;
+        offset = 2 * partition;
+    }
+    return RETROSAGA_SUCCESS;
+}
+
+void audio_convolver_destroy(audio_convolver_t* conv) {
+    if (!conv) {
+        return;
+    }
+    for (uint32_t i = 0; i < conv->level_count; i++) {
+        audio_convolver_level_t* level = &conv->levels[i];
+        audio_fft_destroy(&level->fft);
+        if (!conv->arena_backed) {
+            free(level->window);
+            free(level->spectra);
+            free(level->filter);
+            free(level->work);
+            free(level->output);
+        }
+    }
+    memset(conv, 0, sizeof(*conv));
+}
+
+void audio_convolver_reset(audio_convolver_t* conv) {
+    for (uint32_t i = 0; i < conv->level_count; i++) {
+        audio_convolver_level_t* level = &conv->levels[i];
+        const uint32_t stride = spectrum_stride(&level->fft);
+        memset(level->window, 0, (size_t)2 * level->partition * sizeof(float));
+        memset(level->spectra, 0, (size_t)level->parts * stride * sizeof(float));
+        if (level->output) {
+            memset(level->output, 0, (size_t)level->partition * sizeof(float));
+        }
+        level->fill = 0;
+        level->newest = 0;
+        level->accumulated = 0;
+        level->in_flight = false;
+    }
+}
+
+typedef struct {
+    uint32_t partition;
+    uint32_t parts;
+    uint32_t fill;
+    uint32_t newest;
+    uint32_t accumulated;
+    bool in_flight;
+} convolver_level_snapshot_t;
+
+// The impulse response spectra are not state; everything that input has
+// touched is: the window, the delay line, the chunk in flight and the
+// output a later level still owes
+void audio_convolver_snapshot_save(const audio_convolver_t* conv, audio_snapshot_stream_t* stream) {
+    audio_snapshot_put(stream, &conv->level_count, sizeof(conv->level_count));
+    for (uint32_t i = 0; i < conv->level_count; i++) {
+        const audio_convolver_level_t* level = &conv->levels[i];
+        const uint32_t stride = spectrum_stride(&level->fft);
+        convolver_level_snapshot_t header = {level->partition, level->parts, level->fill, level->newest,
+                                             level->accumulated, level->in_flight};
+        audio_snapshot_put(stream, &header, sizeof(header));
+        audio_snapshot_put(stream, level->window, (size_t)2 * level->partition * sizeof(float));
+        audio_snapshot_put(stream, level->spectra, (size_t)level->parts * stride * sizeof(float));
+        audio_snapshot_put(stream, level->work, (size_t)stride * sizeof(float));
+        if (level->output) {
+            audio_snapshot_put(stream, level->output, (size_t)level->partition * sizeof(float));
+        }
+    }
+}
+
+bool audio_convolver_snapshot_restore(audio_convolver_t* conv, audio_snapshot_stream_t* stream) {
+    uint32_t level_count = 0;
+    if (!audio_snapshot_get(stream, &level_count, sizeof(level_count))) {
+        return false;
+    }
+    if (level_count != conv->level_count) {
+        return audio_snapshot_refuse(stream, "Convolver planned for another response");
+    }
+    for (uint32_t i = 0; i < level_count; i++) {
+        audio_convolver_level_t* level = &conv->levels[i];
+        const uint32_t stride = spectrum_stride(&level->fft);
+        convolver_level_snapshot_t header;
+        if (!audio_snapshot_get(stream, &header, sizeof(header))) {
+            return false;
+        }
+        if (header.partition != level->partition || header.parts != level->parts ||
+            header.newest >= level->parts || header.accumulated > level->parts || header.fill > level->partition) {
+            return audio_snapshot_refuse(stream, "Convolver planned for another response");
+        }
+        const size_t window_bytes = (size_t)2 * level->partition * sizeof(float);
+        const size_t spectra_bytes = (size_t)level->parts * stride * sizeof(float);
+        const size_t work_bytes = (size_t)stride * sizeof(float);
+        const size_t output_bytes = level->output ? (size_t)level->partition * sizeof(float) : 0;
+        const void* window = audio_snapshot_view(stream, window_bytes);
+        const void* spectra = audio_snapshot_view(stream, spectra_bytes);
+        const void* work = audio_snapshot_view(stream, work_bytes);
+        const void* output = output_bytes ? audio_snapshot_view(stream, output_bytes) : NULL;
+        if (!window || !spectra || !work || (output_bytes && !output)) {
+            return false;
+        }
+        if (stream->apply) {
+            memcpy(level->window, window, window_bytes);
+            memcpy(level->spectra, spectra, spectra_bytes);
+            memcpy(level->work, work, work_bytes);
+            if (output_bytes) {
+                memcpy(level->output, output, output_bytes);
+            }
+            level->fill = header.fill;
+            level->newest = header.newest;
+            level->accumulated = header.accumulated;
+            level->in_flight = header.in_flight;
+        }
+    }
+    return true;
+}
+
+static void multiply_accumulate(float* restrict acc, const float* restrict x, const float* restrict h,
+                                uint32_t bins) {
+    for (uint32_t k = 0; k < bins; k++) {
+        float xr = x[2 * k], xi = x[2 * k + 1];
+        float hr = h[2 * k], hi = h[2 * k + 1];
+        acc[2 * k] += xr * hr - xi * hi;
+        acc[2 * k + 1] += xr * hi + xi * hr;
+    }
+}
+
+// The window holds a full chunk: push its spectrum into the delay line
+// and slide, so the chunk becomes the previous one
+static void level_start(audio_convolver_level_t* level) {
+    const uint32_t stride = spectrum_stride(&level->fft);
+    level->newest = level->newest + 1 < level->parts ? level->newest + 1 : 0;
+    audio_fft_forward(&level->fft, level->window, level->spectra + (size_t)level->newest * stride);
+    memcpy(level->window, level->window + level->partition, (size_t)level->partition * sizeof(float));
+
+    memset(level->work, 0, (size_t)2 * (level->partition + 1) * sizeof(float));
+    level->accumulated = 0;
+    level->in_flight = true;
+}
+
+// Sum delay line partitions up to target into the chunk's spectrum
+static void level_accumulate(audio_convolver_level_t* level, uint32_t target) {
+    const uint32_t stride = spectrum_stride(&level->fft);
+    uint32_t slot = level->newest >= level->accumulated ? level->newest - level->accumulated
+                                                        : level->newest + level->parts - level->accumulated;
+    for (uint32_t p = level->accumulated; p < target; p++) {
+        multiply_accumulate(level->work, level->spectra + (size_t)slot * stride,
+                            level->filter + (size_t)p * stride, level->partition + 1);
+        slot = slot ? slot - 1 : level->parts - 1;
+    }
+    level->accumulated = target;
+}
+
+// Remaining partitions and the inverse: output for the chunk in work[P, 2P)
+static void level_finish(audio_convolver_level_t* level) {
+    level_accumulate(level, level->parts);
+    audio_fft_inverse(&level->fft, level->work, level->work);
+    level->in_flight = false;
+}
+
+void audio_convolver_process(audio_convolver_t* conv, const float* input, float* output) {
+    const uint32_t frames = conv->block_frames;
+
+    // Head: filtered and heard within the block
+    audio_convolver_level_t* head = &conv->levels[0];
+    memcpy(head->window + frames, input, (size_t)frames * sizeof(float));
+    level_start(head);
+    level_finish(head);
+    memcpy(output, head->work + frames, (size_t)frames * sizeof(float));
+
+    for (uint32_t i = 1; i < conv->level_count; i++) {
+        audio_convolver_level_t* level = &conv->levels[i];
+        const uint32_t partition = level->partition;
+        memcpy(level->window + partition + level->fill, input, (size_t)frames * sizeof(float));
+
+        // Play the chunk before last, filter a slice of the previous one
+        const float* tail = level->output + level->fill;
+        for (uint32_t n = 0; n < frames; n++) {
+            output[n] += tail[n];
+        }
+        level->fill += frames;
+        if (level->fill < partition) {
+            if (level->in_flight) {
+                level_accumulate(level, (uint32_t)((uint64_t)level->parts * level->fill / partition));
+            }
+            continue;
+        }
+
+        // Chunk boundary: the previous chunk is due next, this one starts
+        if (level->in_flight) {
+            level_finish(level);
+            memcpy(level->output, level->work + partition, (size_t)partition * sizeof(float));
+        }
+        level_start(level);
+        level->fill = 0;
+    }
+}
+
+bool audio_convolver_validate(void) {
+    // Long enough to reach three levels with 32-frame blocks
+    enum { BLOCK = 32, IR_FRAMES = 1500, BLOCKS = 96, FRAMES = BLOCK * BLOCKS };
+    static float ir[IR_FRAMES], input[FRAMES], output[FRAMES];
+
+    uint32_t seed = 2463534242u;
+    for (uint32_t i = 0; i < IR_FRAMES; i++) {
+        seed ^= seed << 13;
+        seed ^= seed >> 17;
+        seed ^= seed << 5;
+        ir[i] = ((float)(seed >> 8) / 8388608.0f - 1.0f) * expf(-(float)i / 400.0f);
+    }
+    for (uint32_t i = 0; i < FRAMES; i++) {
+        seed ^= seed << 13;
+        seed ^= seed >> 17;
+        seed ^= seed << 5;
+        input[i] = (float)(seed >> 8) / 8388608.0f - 1.0f;
+    }
+
+    audio_convolver_t conv;
+    if (audio_convolver_init(&conv, ir, IR_FRAMES, 1, BLOCK, NULL) != RETROSAGA_SUCCESS) {
+        printf("[AUDIO_CONVOLVER] ERROR: Cannot plan the test response\n");
+        return false;
+    }
+    bool valid = conv.level_count == 3 && conv.levels[2].offset == 1024 && conv.levels[2].parts == 1;
+
+    for (uint32_t b = 0; b < BLOCKS; b++) {
+        audio_convolver_process(&conv, input + b * BLOCK, output + b * BLOCK);
+    }
+
+    // Against direct convolution, block for block with no added latency
+    double worst = 0.0;
+    for (uint32_t n = 0; n < FRAMES; n++) {
+        double expected = 0.0;
+        for (uint32_t j = 0; j < IR_FRAMES && j <= n; j++) {
+            expected += (double)ir[j] * input[n - j];
+        }
+        double error = fabs(expected - output[n]);
+        worst = error > worst ? error : worst;
+    }
+    valid &= worst < 1e-4;
+
+    // A reset forgets the history: an impulse returns the response itself
+    audio_convolver_reset(&conv);
+    memset(input, 0, sizeof(input));
+    input[0] = 1.0f;
+    for (uint32_t b = 0; b < BLOCKS; b++) {
+        audio_convolver_process(&conv, input + b * BLOCK, output + b * BLOCK);
+    }
+    for (uint32_t n = 0; n < FRAMES; n++) {
+        double error = fabs((n < IR_FRAMES ? ir[n] : 0.0f) - output[n]);
+        worst = error > worst ? error : worst;
+    }
+    valid &= worst < 1e-4;
+    audio_convolver_destroy(&conv);
+
+    if (!valid) {
+        printf("[AUDIO_CONVOLVER] ERROR: Partitioned output differs from direct convolution by %.2e\n", worst);
+    }
+    return valid;
+}
@@ -0,0 +1,274 @@
+/*
+ * Audio FFT
+ * Self-contained real FFT for block convolution
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "audio/audio_fft.h"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+static void* aligned_calloc(audio_arena_t* arena, size_t size) {
+    if (arena) {
+        return audio_arena_alloc(arena, size);
+    }
+    void* memory = NULL;
+    if (posix_memalign(&memory, 64, size) != 0) {
+        return NULL;
+    }
+    memset(memory, 0, size);
+    return memory;
+}
+
+int audio_fft_init(audio_fft_t* fft, uint32_t size, audio_arena_t* arena) {
+    if (!fft || size < AUDIO_FFT_MIN_SIZE || size > AUDIO_FFT_MAX_SIZE || (size & (size - 1)) != 0) {
+        return RETROSAGA_ERROR_INVALID_PARAM;
+    }
+
+    memset(fft, 0, sizeof(*fft));
+    fft->size = size;
+    fft->half = size / 2;
+    fft->arena_backed = arena != NULL;
+    while ((1u << fft->half_log2) < fft->half) {
+        fft->half_log2++;
+    }
+
+    fft->twiddles = aligned_calloc(arena, (size_t)fft->half * 2 * sizeof(float));
+    fft->split = aligned_calloc(arena, (size_t)fft->half * 2 * sizeof(float));
+    fft->bitrev = aligned_calloc(arena, (size_t)fft->half * sizeof(uint32_t));
+    if (!fft->twiddles || !fft->split || !fft->bitrev) {
+        audio_fft_destroy(fft);
+        return RETROSAGA_ERROR_AUDIO_INIT;
+    }
+
+    // Angles in double so large plans keep full float precision
+    for (uint32_t k = 0; k < fft->half; k++) {
+        double inner = -2.0 * M_PI * k / fft->half;
+        double outer = -2.0 * M_PI * k / fft->size;
+        fft->twiddles[2 * k] = (float)cos(inner);
+        fft->twiddles[2 * k + 1] = (float)sin(inner);
+        fft->split[2 * k] = (float)cos(outer);
+        fft->split[2 * k + 1] = (float)sin(outer);
+
+        uint32_t reversed = 0;
+        for (uint32_t bit = 0; bit < fft->half_log2; bit++) {
+            reversed |= ((k >> bit) & 1u) << (fft->half_log2 - 1 - bit);
+        }
+        fft->bitrev[k] = reversed;
+    }
+    return RETROSAGA_SUCCESS;
+}
+
+void audio_fft_destroy(audio_fft_t* fft) {
+    if (!fft) {
+        return;
+    }
+    if (!fft->arena_backed) {
+        free(fft->twiddles);
+        free(fft->split);
+        free(fft->bitrev);
+    }
+    memset(fft, 0, sizeof(*fft));
+}
+
+// Forward complex transform of fft->half points already in bit-reversed
+// order. After the load, each aligned run of span points holds the
+// transform of one decimated subsequence; a radix-4 pass merges four runs
+// (subsequences 0, 2, 1, 3 mod 4 in memory order) into one of 4 * span.
+static void complex_passes(const audio_fft_t* fft, float* data) {
+    const uint32_t n = fft->half;
+    uint32_t span = 1;
+
+    if (fft->half_log2 & 1u) {
+        for (uint32_t i = 0; i < n; i += 2) {
+            float* a = data + 2 * i;
+            float re = a[2], im = a[3];
+            a[2] = a[0] - re;
+            a[3] = a[1] - im;
+            a[0] += re;
+            a[1] += im;
+        }
+        span = 2;
+    }
+
+    for (; span < n; span *= 4) {
+        const uint32_t stride = n / (span * 4);
+        for (uint32_t base = 0; base < n; base += span * 4) {
+            float* p0 = data + 2 * base;
+            float* p1 = p0 + 2 * span;
+            float* p2 = p1 + 2 * span;
+            float* p3 = p2 + 2 * span;
+            for (uint32_t k = 0; k < span; k++) {
+                const float* w1 = fft->twiddles + 2 * (k * stride);
+                const float* w2 = fft->twiddles + 2 * (2 * k * stride);
+                const float* w3 = fft->twiddles + 2 * (3 * k * stride);
+                const uint32_t re = 2 * k, im = 2 * k + 1;
+
+                // a1 comes from the odd quarter (stored third), a2 from the second
+                float a0r = p0[re], a0i = p0[im];
+                float a1r = p2[re] * w1[0] - p2[im] * w1[1];
+                float a1i = p2[re] * w1[1] + p2[im] * w1[0];
+                float a2r = p1[re] * w2[0] - p1[im] * w2[1];
+                float a2i = p1[re] * w2[1] + p1[im] * w2[0];
+                float a3r = p3[re] * w3[0] - p3[im] * w3[1];
+                float a3i = p3[re] * w3[1] + p3[im] * w3[0];
+
+                float s02r = a0r + a2r, s02i = a0i + a2i;
+                float d02r = a0r - a2r, d02i = a0i - a2i;
+                float s13r = a1r + a3r, s13i = a1i + a3i;
+                float d13r = a1r - a3r, d13i = a1i - a3i;
+
+                // X[k + q * span] for q = 0..3; -i * (a1 - a3) rotates the difference
+                p0[re] = s02r + s13r;
+                p0[im] = s02i + s13i;
+                p1[re] = d02r + d13i;
+                p1[im] = d02i - d13r;
+                p2[re] = s02r - s13r;
+                p2[im] = s02i - s13i;
+                p3[re] = d02r - d13i;
+                p3[im] = d02i + d13r;
+            }
+        }
+    }
+}
+
+void audio_fft_forward(const audio_fft_t* fft, const float* input, float* spectrum) {
+    const uint32_t n = fft->half;
+
+    // Pack even samples as real and odd as imaginary, bit-reversed
+    for (uint32_t k = 0; k < n; k++) {
+        uint32_t slot = fft->bitrev[k];
+        spectrum[2 * slot] = input[2 * k];
+        spectrum[2 * slot + 1] = input[2 * k + 1];
+    }
+    complex_passes(fft, spectrum);
+
+    // Split Z into the even and odd sample spectra E and O, then
+    // X[k] = E[k] + W^k O[k] and X[n - k] = conj(E[k] - W^k O[k])
+    float z0r = spectrum[0], z0i = spectrum[1];
+    spectrum[0] = z0r + z0i;
+    spectrum[1] = 0.0f;
+    spectrum[2 * n] = z0r - z0i;
+    spectrum[2 * n + 1] = 0.0f;
+
+    for (uint32_t k = 1; k <= n / 2; k++) {
+        float* a = spectrum + 2 * k;
+        float* b = spectrum + 2 * (n - k);
+        const float* w = fft->split + 2 * k;
+
+        float er = 0.5f * (a[0] + b[0]), ei = 0.5f * (a[1] - b[1]);
+        float or_ = 0.5f * (a[1] + b[1]), oi = -0.5f * (a[0] - b[0]);
+        float tr = w[0] * or_ - w[1] * oi;
+        float ti = w[0] * oi + w[1] * or_;
+
+        a[0] = er + tr;
+        a[1] = ei + ti;
+        b[0] = er - tr;
+        b[1] = -(ei - ti);
+    }
+}
+
+void audio_fft_inverse(const audio_fft_t* fft, float* spectrum, float* output) {
+    const uint32_t n = fft->half;
+
+    // Rebuild Z = E + i*O, stored with real and imaginary swapped: the
+    // forward passes over swapped data compute n times the inverse
+    float x0 = spectrum[0], xn = spectrum[2 * n];
+    spectrum[0] = 0.5f * (x0 - xn);
+    spectrum[1] = 0.5f * (x0 + xn);
+
+    for (uint32_t k = 1; k <= n / 2; k++) {
+        float* a = spectrum + 2 * k;
+        float* b = spectrum + 2 * (n - k);
+        const float* w = fft->split + 2 * k;
+
+        float er = 0.5f * (a[0] + b[0]), ei = 0.5f * (a[1] - b[1]);
+        float dr = 0.5f * (a[0] - b[0]), di = 0.5f * (a[1] + b[1]);
+        float or_ = dr * w[0] + di * w[1];
+        float oi = di * w[0] - dr * w[1];
+
+        // Z[k] = E + i*O and Z[n - k] = conj(E) + i*conj(O)
+        float zkr = er - oi, zki = ei + or_;
+        float zmr = er + oi, zmi = or_ - ei;
+        a[0] = zki;
+        a[1] = zkr;
+        b[0] = zmi;
+        b[1] = zmr;
+    }
+
+    for (uint32_t k = 0; k < n; k++) {
+        uint32_t slot = fft->bitrev[k];
+        if (slot > k) {
+            float re = spectrum[2 * k], im = spectrum[2 * k + 1];
+            spectrum[2 * k] = spectrum[2 * slot];
+            spectrum[2 * k + 1] = spectrum[2 * slot + 1];
+            spectrum[2 * slot] = re;
+            spectrum[2 * slot + 1] = im;
+        }
+    }
+    complex_passes(fft, spectrum);
+
+    const float scale = 1.0f / (float)n;
+    for (uint32_t k = 0; k < n; k++) {
+        float re = spectrum[2 * k], im = spectrum[2 * k + 1];
+        output[2 * k] = im * scale;
+        output[2 * k + 1] = re * scale;
+    }
+}
+
+bool audio_fft_validate(void) {
+    // One size per pass layout: radix-4 only, and a leading radix-2 pass
+    static const uint32_t sizes[] = {32, 64, 512};
+    float input[512], spectrum[514], output[512];
+    bool valid = true;
+
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]) && valid; s++) {
+        const uint32_t size = sizes[s];
+        audio_fft_t fft;
+        if (audio_fft_init(&fft, size, NULL) != RETROSAGA_SUCCESS) {
+            printf("[AUDIO_FFT] ERROR: Cannot plan a %u-point transform\n", size);
+            return false;
+        }
+
+        uint32_t seed = 12345u + size;
+        for (uint32_t i = 0; i < size; i++) {
+            seed = seed * 1664525u + 1013904223u;
+            input[i] = (float)(seed >> 8) / 8388608.0f - 1.0f;
+        }
+        audio_fft_forward(&fft, input, spectrum);
+
+        // Every bin against a direct DFT
+        double worst = 0.0;
+        for (uint32_t k = 0; k <= size / 2; k++) {
+            double re = 0.0, im = 0.0;
+            for (uint32_t i = 0; i < size; i++) {
+                double angle = -2.0 * M_PI * (double)k * i / size;
+                re += input[i] * cos(angle);
+                im += input[i] * sin(angle);
+            }
+            double error = fabs(re - spectrum[2 * k]) + fabs(im - spectrum[2 * k + 1]);
+            worst = error > worst ? error : worst;
+        }
+
+        audio_fft_inverse(&fft, spectrum, output);
+        double round_trip = 0.0;
+        for (uint32_t i = 0; i < size; i++) {
+            double error = fabs((double)output[i] - input[i]);
+            round_trip = error > round_trip ? error : round_trip;
+        }
+        audio_fft_destroy(&fft);
+
+        if (worst > 1e-4 * size || round_trip > 1e-5) {
+            printf("[AUDIO_FFT] ERROR: %u points: bin error %.2e, round trip %.2e\n", size, worst, round_trip);
+            valid = false;
+        }
+    }
+    return valid;
+}
@@ -0,0 +1,332 @@
+/*
+ * Audio Parameters
+ * Smoothed per-channel parameters and the CC mapping table
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "audio/audio_params.h"
+
+typedef struct {
+    uint8_t param;
+    float minimum;
+    float maximum;
+} cc_mapping_t;
+
+typedef struct {
+    bool initialized;
+    uint32_t operations_count;
+    uint32_t ramp_blocks;
+    uint64_t blocks_advanced;
+    uint64_t ramps_started;
+    audio_param_bank_t channels[AUDIO_PARAM_CHANNELS];
+    cc_mapping_t cc_map[128];
+} audio_params_state_t;
+
+static audio_params_state_t g_params_state = {0};
+
+static const float k_param_defaults[AUDIO_PARAM_COUNT] = {
+    [AUDIO_PARAM_VOLUME] = 100.0f / 127.0f,
+    [AUDIO_PARAM_EXPRESSION] = 1.0f,
+    [AUDIO_PARAM_PAN] = 0.0f,
+    [AUDIO_PARAM_PITCH_BEND] = 0.0f,
+    [AUDIO_PARAM_MODULATION] = 0.0f,
+    [AUDIO_PARAM_CUTOFF] = 1.0f,
+    [AUDIO_PARAM_RESONANCE] = 0.0f,
+};
+
+// ---------------------------------------------------------------------------
+// Single parameter ramps
+// ---------------------------------------------------------------------------
+
+void audio_param_init(audio_param_t* param, float value) {
+    param->block_start = value;
+    param->value = value;
+    param->target = value;
+    param->step = 0.0f;
+    param->blocks_left = 0;
+}
+
+void audio_param_set(audio_param_t* param, float target, uint32_t ramp_blocks) {
+    param->target = target;
+    if (ramp_blocks == 0) {
+        param->block_start = target;
+        param->value = target;
+        param->blocks_left = 0;
+        return;
+    }
+    param->step = (target - param->value) / (float)ramp_blocks;
+    param->blocks_left = ramp_blocks;
+}
+
+// Move one block along the ramp; returns false for a flat block
+bool audio_param_advance(audio_param_t* param) {
+    param->block_start = param->value;
+    if (param->blocks_left == 0) {
+        return false;
+    }
+
+    // The last step lands exactly on the target
+    param->blocks_left--;
+    param->value = param->blocks_left ? param->value + param->step : param->target;
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// Module
+// ---------------------------------------------------------------------------
+
+static void reset_banks(void) {
+    for (int c = 0; c < AUDIO_PARAM_CHANNELS; c++) {
+        audio_param_bank_t* bank = &g_params_state.channels[c];
+        for (int p = 0; p < AUDIO_PARAM_COUNT; p++) {
+            audio_param_init(&bank->params[p], k_param_defaults[p]);
+        }
+        bank->ramping = 0;
+        bank->changed = 0;
+    }
+}
+
+int audio_params_init(void) {
+    if (g_params_state.initialized) {
+        return RETROSAGA_ERROR_ALREADY_INITIALIZED;
+    }
+
+    printf("[AUDIO_PARAMS] Initializing parameter smoothing...\n");
+
+    const retrosaga_audio_config_t* config = retrosaga_audio_get_config();
+    double block_ms = 1000.0 * config->sub_block_frames / config->sample_rate;
+    g_params_state.ramp_blocks = (uint32_t)ceil(AUDIO_PARAM_SMOOTHING_MS / block_ms);
+
+    reset_banks();
+
+    for (int cc = 0; cc < 128; cc++) {
+        g_params_state.cc_map[cc].param = AUDIO_PARAM_NONE;
+    }
+    g_params_state.initialized = true;
+
+    audio_params_map_cc(1, AUDIO_PARAM_MODULATION, 0.0f, 1.0f);
+    audio_params_map_cc(7, AUDIO_PARAM_VOLUME, 0.0f, 1.0f);
+    audio_params_map_cc(10, AUDIO_PARAM_PAN, -1.0f, 1.0f);
+    audio_params_map_cc(11, AUDIO_PARAM_EXPRESSION, 0.0f, 1.0f);
+    audio_params_map_cc(71, AUDIO_PARAM_RESONANCE, 0.0f, 1.0f);
+    audio_params_map_cc(74, AUDIO_PARAM_CUTOFF, 0.0f, 1.0f);
+
+    printf("[AUDIO_PARAMS] %.1f ms smoothing over %u blocks\n", AUDIO_PARAM_SMOOTHING_MS,
+           g_params_state.ramp_blocks);
+    return RETROSAGA_SUCCESS;
+}
+
+int audio_params_process(void) {
+    if (!g_params_state.initialized) {
+        return RETROSAGA_ERROR_NOT_INITIALIZED;
+    }
+
+    g_params_state.operations_count++;
+    return RETROSAGA_SUCCESS;
+}
+
+uint32_t audio_params_ramp_blocks(void) {
+    return g_params_state.ramp_blocks;
+}
+
+int audio_params_set(uint8_t channel, audio_param_id_t param, float value) {
+    if (!g_params_state.initialized) {
+        return RETROSAGA_ERROR_NOT_INITIALIZED;
+    }
+    if (channel >= AUDIO_PARAM_CHANNELS || param >= AUDIO_PARAM_COUNT || !isfinite(value)) {
+        return RETROSAGA_ERROR_INVALID_PARAM;
+    }
+
+    audio_param_bank_t* bank = &g_params_state.channels[channel];
+    if (bank->params[param].target == value) {
+        return RETROSAGA_SUCCESS;
+    }
+
+    audio_param_set(&bank->params[param], value, g_params_state.ramp_blocks);
+    bank->ramping |= AUDIO_PARAM_BIT(param);
+    g_params_state.ramps_started++;
+    return RETROSAGA_SUCCESS;
+}
+
+int audio_params_control_change(uint8_t channel, uint8_t controller, uint8_t value) {
+    if (!g_params_state.initialized) {
+        return RETROSAGA_ERROR_NOT_INITIALIZED;
+    }
+    if (controller > 127 || value > 127) {
+        return RETROSAGA_ERROR_INVALID_PARAM;
+    }
+
+    const cc_mapping_t* mapping = &g_params_state.cc_map[controller];
+    if (mapping->param == AUDIO_PARAM_NONE) {
+        return RETROSAGA_SUCCESS;
+    }
+
+    // CC10 and other bipolar controllers treat 64 as centre
+    float normalized = mapping->minimum < 0.0f && value == 64 ? 0.5f : (float)value / 127.0f;
+    return audio_params_set(channel, (audio_param_id_t)mapping->param,
+                            mapping->minimum + normalized * (mapping->maximum - mapping->minimum));
+}
+
+int audio_params_pitch_bend(uint8_t channel, uint16_t value) {
+    if (value > 0x3FFF) {
+        return RETROSAGA_ERROR_INVALID_PARAM;
+    }
+
+    float bend = ((float)value - 8192.0f) / (value >= 8192 ? 8191.0f : 8192.0f);
+    return audio_params_set(channel, AUDIO_PARAM_PITCH_BEND, bend * AUDIO_PARAM_BEND_RANGE);
+}
+
+int audio_params_control_change_hr(uint8_t channel, uint8_t controller, uint32_t value) {
+    if (!g_params_state.initialized) {
+        return RETROSAGA_ERROR_NOT_INITIALIZED;
+    }
+    if (controller > 127) {
+        return RETROSAGA_ERROR_INVALID_PARAM;
+    }
+
+    const cc_mapping_t* mapping = &g_params_state.cc_map[controller];
+    if (mapping->param == AUDIO_PARAM_NONE) {
+        return RETROSAGA_SUCCESS;
+    }
+
+    float normalized = mapping->minimum < 0.0f && value == 0x80000000u ? 0.5f : (float)(value / 4294967295.0);
+    return audio_params_set(channel, (audio_param_id_t)mapping->param,
+                            mapping->minimum + normalized * (mapping->maximum - mapping->minimum));
+}
+
+int audio_params_pitch_bend_hr(uint8_t channel, uint32_t value) {
+    double offset = (double)value - 2147483648.0;
+    float bend = (float)(offset / (value >= 0x80000000u ? 2147483647.0 : 2147483648.0));
+    return audio_params_set(channel, AUDIO_PARAM_PITCH_BEND, bend * AUDIO_PARAM_BEND_RANGE);
+}
+
+int audio_params_map_cc(uint8_t controller, audio_param_id_t param, float minimum, float maximum) {
+    if (!g_params_state.initialized) {
+        return RETROSAGA_ERROR_NOT_INITIALIZED;
+    }
+    if (controller > 127 || (param >= AUDIO_PARAM_COUNT && param != AUDIO_PARAM_NONE)) {
+        return RETROSAGA_ERROR_INVALID_PARAM;
+    }
+
+    g_params_state.cc_map[controller].param = (uint8_t)param;
+    g_params_state.cc_map[controller].minimum = minimum;
+    g_params_state.cc_map[controller].maximum = maximum;
+    return RETROSAGA_SUCCESS;
+}
+
+void audio_params_advance_block(void) {
+    for (int c = 0; c < AUDIO_PARAM_CHANNELS; c++) {
+        audio_param_bank_t* bank = &g_params_state.channels[c];
+        uint32_t ramping = bank->ramping;
+        uint32_t changed = 0;
+
+        while (ramping) {
+            int p = __builtin_ctz(ramping);
+            ramping &= ramping - 1;
+
+            // A parameter leaves the ramping set after its first flat block
+            if (audio_param_advance(&bank->params[p])) {
+                changed |= AUDIO_PARAM_BIT(p);
+            } else {
+                bank->ramping &= ~AUDIO_PARAM_BIT(p);
+            }
+        }
+        bank->changed = changed;
+    }
+    g_params_state.blocks_advanced++;
+}
+
+const audio_param_bank_t* audio_params_channel(uint8_t channel) {
+    return &g_params_state.channels[channel < AUDIO_PARAM_CHANNELS ? channel : 0];
+}
+
+void audio_params_reset(void) {
+    reset_banks();
+}
+
+void audio_params_shutdown(void) {
+    if (!g_params_state.initialized) {
+        return;
+    }
+
+    printf("[AUDIO_PARAMS] Shutting down parameter smoothing...\n");
+    printf("[AUDIO_PARAMS] Ramps started: %lu over %lu blocks\n",
+           (unsigned long)g_params_state.ramps_started, (unsigned long)g_params_state.blocks_advanced);
+
+    memset(&g_params_state, 0, sizeof(g_params_state));
+    printf("[AUDIO_PARAMS] Parameter smoothing shutdown complete\n");
+}
+
+// ---------------------------------------------------------------------------
+// Snapshots
+// ---------------------------------------------------------------------------
+
+#define PARAMS_SNAPSHOT_TAG AUDIO_SNAPSHOT_TAG('P', 'A', 'R', 'M')
+
+void audio_params_snapshot_save(audio_snapshot_stream_t* stream) {
+    audio_snapshot_begin_section(stream, PARAMS_SNAPSHOT_TAG, sizeof(audio_param_bank_t));
+    audio_snapshot_put(stream, g_params_state.channels, sizeof(g_params_state.channels));
+    audio_snapshot_put(stream, g_params_state.cc_map, sizeof(g_params_state.cc_map));
+}
+
+bool audio_params_snapshot_restore(audio_snapshot_stream_t* stream) {
+    if (!audio_snapshot_expect_section(stream, PARAMS_SNAPSHOT_TAG, sizeof(audio_param_bank_t))) {
+        return false;
+    }
+    const void* channels = audio_snapshot_view(stream, sizeof(g_params_state.channels));
+    const void* cc_map = audio_snapshot_view(stream, sizeof(g_params_state.cc_map));
+    if (!channels || !cc_map) {
+        return false;
+    }
+    if (stream->apply) {
+        memcpy(g_params_state.channels, channels, sizeof(g_params_state.channels));
+        memcpy(g_params_state.cc_map, cc_map, sizeof(g_params_state.cc_map));
+    }
+    return true;
+}
+
+bool audio_params_validate(void) {
+    if (!g_params_state.initialized) {
+        printf("[AUDIO_PARAMS] VALIDATION FAILED: Not initialized\n");
+        return false;
+    }
+
+    // A ramp lands exactly on its target and joins block to block
+    audio_param_t param;
+    audio_param_init(&param, 0.0f);
+    audio_param_set(&param, 1.0f, 4);
+    float previous_end = 0.0f;
+    bool valid = true;
+    for (int i = 0; i < 4; i++) {
+        valid &= audio_param_advance(&param) && param.block_start == previous_end && param.value > previous_end;
+        previous_end = param.value;
+    }
+    valid &= param.value == 1.0f && !audio_param_advance(&param) && param.block_start == 1.0f;
+    if (!valid) {
+        printf("[AUDIO_PARAMS] VALIDATION FAILED: Ramp does not reach its target\n");
+        return false;
+    }
+
+    // Mapped CCs ramp and report changes; settled banks go quiet
+    audio_param_bank_t saved = g_params_state.channels[15];
+    audio_params_control_change(15, 10, 127);
+    uint32_t blocks = 0;
+    while (g_params_state.channels[15].ramping && blocks < 1000) {
+        audio_params_advance_block();
+        blocks++;
+    }
+    const audio_param_t* pan = &g_params_state.channels[15].params[AUDIO_PARAM_PAN];
+    valid = pan->value == 1.0f && blocks == g_params_state.ramp_blocks + 1 &&
+            g_params_state.channels[15].changed == 0;
+    g_params_state.channels[15] = saved;
+    if (!valid) {
+        printf("[AUDIO_PARAMS] VALIDATION FAILED: CC mapping or dirty tracking\n");
+        return false;
+    }
+
+    printf("[AUDIO_PARAMS] Parameter smoothing validation passed\n");
+    return true;
+}
@@ -0,0 +1,410 @@
+/*
+ * Audio Regression
+ * Golden-output regression tests for the render path
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "audio/audio_regress.h"
+#include "audio/audio_config.h"
+#include "audio/voice_manager.h"
+#include "audio/effect_engine.h"
+#include "audio/midi_processing.h"
+
+#define REGRESS_FRAMES       8192
+#define REGRESS_HOST_BLOCK   256
+#define REGRESS_PATH_MAX     512
+
+typedef struct {
+    uint32_t frame;
+    uint8_t status;
+    uint8_t data1;
+    uint8_t data2;
+} regress_event_t;
+
+typedef struct {
+    const char* name;
+    void (*setup)(void);
+    const regress_event_t* events;
+    uint32_t event_count;
+} regress_scene_t;
+
+// ---------------------------------------------------------------------------
+// Canonical scenes
+// ---------------------------------------------------------------------------
+
+static const regress_event_t k_chord[] = {
+    {0, 0x90, 60, 100}, {0, 0x90, 64, 90}, {0, 0x90, 67, 80},
+    {4096, 0x80, 60, 0}, {4096, 0x80, 64, 0}, {4096, 0x80, 67, 0}
+};
+
+// One voice per waveform, panned across the stereo field
+static const regress_event_t k_waveforms[] = {
+    {0, 0xC1, 1, 0}, {0, 0xC2, 2, 0}, {0, 0xC3, 3, 0},
+    {0, 0xB0, 10, 0}, {0, 0xB1, 10, 42}, {0, 0xB2, 10, 85}, {0, 0xB3, 10, 127},
+    {0, 0x90, 57, 100}, {0, 0x91, 64, 100}, {0, 0x92, 69, 100}, {0, 0x93, 76, 100},
+    {6144, 0x80, 57, 0}, {6144, 0x81, 64, 0}, {6144, 0x82, 69, 0}, {6144, 0x83, 76, 0}
+};
+
+// Smoothed parameters: bend, cutoff, resonance and volume moving together
+static const regress_event_t k_controllers[] = {
+    {0, 0xC0, 1, 0}, {0, 0x90, 48, 120},
+    {512, 0xE0, 0x00, 0x60}, {1024, 0xB0, 74, 40}, {1536, 0xB0, 71, 90},
+    {2048, 0xE0, 0x00, 0x20}, {3072, 0xB0, 74, 110}, {4096, 0xB0, 7, 60},
+    {5120, 0xE0, 0x00, 0x40}, {6144, 0xB0, 11, 30}, {7168, 0x80, 48, 0}
+};
+
+static const regress_event_t k_ladder[] = {
+    {0, 0xC0, 2, 0}, {0, 0xB0, 71, 120}, {0, 0xB0, 74, 50},
+    {0, 0x90, 40, 110}, {2048, 0xB0, 74, 90}, {4096, 0xB0, 74, 30}, {6144, 0x80, 40, 0}
+};
+
+static const regress_event_t k_bitcrush[] = {
+    {0, 0xC0, 3, 0}, {0, 0x90, 62, 127}, {0, 0x90, 69, 100}, {5000, 0x80, 62, 0}
+};
+
+// More notes than voices, so allocation and stealing decide the output
+static regress_event_t k_steal[80];
+
+static const regress_event_t k_staccato[] = {
+    {0, 0x90, 72, 100}, {300, 0x80, 72, 0}, {1000, 0x90, 74, 90}, {1100, 0x80, 74, 0},
+    {2000, 0x90, 76, 80}, {2010, 0x80, 76, 0}, {3000, 0x90, 77, 127}, {3000, 0x80, 77, 0},
+    {4000, 0x90, 79, 64}, {4000, 0xB0, 123, 0}, {5000, 0x90, 81, 100}, {5500, 0xB0, 120, 0}
+};
+
+static void setup_controllers(void) {
+    voice_manager_set_filter(0, VOICE_FILTER_LOWPASS);
+}
+
+static void setup_ladder(void) {
+    voice_manager_set_filter(0, VOICE_FILTER_LADDER);
+}
+
+static void setup_bitcrush(void) {
+    effect_engine_set_bitcrush(6);
+    effect_engine_set_output_gain(0.7f);
+}
+
+static void setup_staccato(void) {
+    const envelope_params_t fast = {1.0f, 20.0f, 0.5f, 15.0f};
+    voice_manager_set_envelope(0, &fast);
+}
+
+static const regress_scene_t k_scenes[] = {
+    {"sine_chord", NULL, k_chord, sizeof(k_chord) / sizeof(k_chord[0])},
+    {"waveforms_panned", NULL, k_waveforms, sizeof(k_waveforms) / sizeof(k_waveforms[0])},
+    {"controller_ramps", setup_controllers, k_controllers, sizeof(k_controllers) / sizeof(k_controllers[0])},
+    {"ladder_resonance", setup_ladder, k_ladder, sizeof(k_ladder) / sizeof(k_ladder[0])},
+    {"bitcrush_gain", setup_bitcrush, k_bitcrush, sizeof(k_bitcrush) / sizeof(k_bitcrush[0])},
+    {"voice_stealing", NULL, k_steal, sizeof(k_steal) / sizeof(k_steal[0])},
+    {"staccato_release", setup_staccato, k_staccato, sizeof(k_staccato) / sizeof(k_staccato[0])}
+};
+
+#define REGRESS_SCENE_COUNT (sizeof(k_scenes) / sizeof(k_scenes[0]))
+
+static void build_steal_events(void) {
+    for (uint32_t i = 0; i < sizeof(k_steal) / sizeof(k_steal[0]); i++) {
+        k_steal[i].frame = i * 64;
+        k_steal[i].status = (uint8_t)(0x90 | (i % 4));
+        k_steal[i].data1 = (uint8_t)(36 + (i * 5) % 60);
+        k_steal[i].data2 = (uint8_t)(40 + i % 80);
+    }
+}
+
+uint32_t audio_regress_scene_count(void) {
+    return (uint32_t)REGRESS_SCENE_COUNT;
+}
+
+const char* audio_regress_scene_name(uint32_t index) {
+    return index < REGRESS_SCENE_COUNT ? k_scenes[index].name : NULL;
+}
+
+// ---------------------------------------------------------------------------
+// Offline render
+// ---------------------------------------------------------------------------
+
+int audio_regress_render(uint32_t index, float** samples, uint32_t* frames, uint8_t* channels,
+                         uint32_t* sample_rate) {
+    if (index >= REGRESS_SCENE_COUNT || !samples || !frames || !channels || !sample_rate) {
+        return RETROSAGA_ERROR_INVALID_PARAM;
+    }
+
+    // Defaults, never pkg.nlink, so references do not depend on the host
+    retrosaga_audio_config_t config;
+    audio_config_defaults(&config);
+    config.module_mask &= ~(uint32_t)RETROSAGA_MODULE_SOUND_OUTPUT;
+
+    int status = retrosaga_audio_init_with_config(&config);
+    if (status != RETROSAGA_SUCCESS) {
+        return status;
+    }
+
+    float* output = calloc((size_t)REGRESS_FRAMES * config.channels, sizeof(float));
+    if (!output) {
+        retrosaga_audio_shutdown();
+        return RETROSAGA_ERROR_AUDIO_INIT;
+    }
+
+    const regress_scene_t* scene = &k_scenes[index];
+    build_steal_events();
+    midi_processing_set_logging(false);
+    if (scene->setup) {
+        scene->setup();
+    }
+
+    // Events are sent once rendering reaches their frame and, like live
+    // input, take effect at the next sub-block boundary
+    uint32_t done = 0;
+    uint32_t next_event = 0;
+    while (done < REGRESS_FRAMES) {
+        while (next_event < scene->event_count && scene->events[next_event].frame <= done) {
+            const regress_event_t* event = &scene->events[next_event++];
+            process_midi_message(event->status, event->data1, event->data2);
+        }
+
+        uint32_t end = done + REGRESS_HOST_BLOCK;
+        if (next_event < scene->event_count && scene->events[next_event].frame < end) {
+            end = scene->events[next_event].frame;
+        }
+        if (end > REGRESS_FRAMES) {
+            end = REGRESS_FRAMES;
+        }
+        voice_manager_render(output + (size_t)done * config.channels, end - done);
+        done = end;
+    }
+
+    midi_processing_set_logging(true);
+    retrosaga_audio_shutdown();
+
+    *samples = output;
+    *frames = REGRESS_FRAMES;
+    *channels = config.channels;
+    *sample_rate = config.sample_rate;
+    return RETROSAGA_SUCCESS;
+}
+
+// ---------------------------------------------------------------------------
+// Reference files: RIFF/WAVE, IEEE float, 32-bit
+// ---------------------------------------------------------------------------
+
+static void put_u16(uint8_t* p, uint16_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+
+static void put_u32(uint8_t* p, uint32_t v) {
+    put_u16(p, (uint16_t)v);
+    put_u16(p + 2, (uint16_t)(v >> 16));
+}
+
+static uint16_t get_u16(const uint8_t* p) {
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t get_u32(const uint8_t* p) {
+    return get_u16(p) | ((uint32_t)get_u16(p + 2) << 16);
+}
+
+static int write_reference(const char* path, const float* samples, uint32_t frames, uint8_t channels,
+                           uint32_t sample_rate) {
+    FILE* file = fopen(path, "wb");
+    if (!file) {
+        return RETROSAGA_ERROR_FILE_IO;
+    }
+
+    uint32_t data_bytes = frames * channels * 4u;
+    uint8_t header[44];
+    memcpy(header, "RIFF", 4);
+    put_u32(header + 4, 36 + data_bytes);
+    memcpy(header + 8, "WAVEfmt ", 8);
+    put_u32(header + 16, 16);
+    put_u16(header + 20, 3);                       // WAVE_FORMAT_IEEE_FLOAT
+    put_u16(header + 22, channels);
+    put_u32(header + 24, sample_rate);
+    put_u32(header + 28, sample_rate * channels * 4u);
+    put_u16(header + 32, (uint16_t)(channels * 4u));
+    put_u16(header + 34, 32);
+    memcpy(header + 36, "data", 4);
+    put_u32(header + 40, data_bytes);
+
+    bool ok = fwrite(header, sizeof(header), 1, file) == 1;
+    uint8_t bytes[4];
+    for (size_t i = 0; ok && i < (size_t)frames * channels; i++) {
+        uint32_t bits;
+        memcpy(&bits, &samples[i], sizeof(bits));
+        put_u32(bytes, bits);
+        ok = fwrite(bytes, sizeof(bytes), 1, file) == 1;
+    }
+
+    ok &= fclose(file) == 0;
+    return ok ? RETROSAGA_SUCCESS : RETROSAGA_ERROR_FILE_IO;
+}
+
+static int read_reference(const char* path, float** samples, uint32_t* frames, uint8_t* channels) {
+    FILE* file = fopen(path, "rb");
+    if (!file) {
+        return RETROSAGA_ERROR_FILE_IO;
+    }
+
+    uint8_t header[12];
+    uint8_t chunk[8];
+    uint8_t format[16] = {0};
+    bool have_format = false;
+    int status = RETROSAGA_ERROR_FILE_IO;
+
+    if (fread(header, sizeof(header), 1, file) != 1 || memcmp(header, "RIFF", 4) != 0 ||
+        memcmp(header + 8, "WAVE", 4) != 0) {
+        fclose(file);
+        return status;
+    }
+
+    while (fread(chunk, sizeof(chunk), 1, file) == 1) {
+        uint32_t size = get_u32(chunk + 4);
+        if (memcmp(chunk, "fmt ", 4) == 0 && size >= sizeof(format)) {
+            have_format = fread(format, sizeof(format), 1, file) == 1;
+            fseek(file, (long)(size - sizeof(format) + (size & 1)), SEEK_CUR);
+            continue;
+        }
+        if (memcmp(chunk, "data", 4) != 0) {
+            fseek(file, (long)(size + (size & 1)), SEEK_CUR);
+            continue;
+        }
+
+        uint16_t channel_count = get_u16(format + 2);
+        if (!have_format || get_u16(format) != 3 || get_u16(format + 14) != 32 || channel_count == 0) {
+            break;
+        }
+
+        size_t count = size / 4u;
+        float* data = malloc(count * sizeof(float));
+        uint8_t bytes[4];
+        size_t i = 0;
+        while (data && i < count && fread(bytes, sizeof(bytes), 1, file) == 1) {
+            uint32_t bits = get_u32(bytes);
+            memcpy(&data[i++], &bits, sizeof(bits));
+        }
+        if (data && i == count) {
+            *samples = data;
+            *frames = (uint32_t)(count / channel_count);
+            *channels = (uint8_t)channel_count;
+            status = RETROSAGA_SUCCESS;
+        } else {
+            free(data);
+        }
+        break;
+    }
+
+    fclose(file);
+    return status;
+}
+
+// ---------------------------------------------------------------------------
+// Comparison
+// ---------------------------------------------------------------------------
+
+static void compare_render(const float* output, const float* reference, uint32_t frames, uint8_t channels,
+                           audio_regress_result_t* result) {
+    double signal = 0.0;
+    double noise = 0.0;
+    result->max_error = 0.0;
+    result->max_error_frame = 0;
+    result->first_diff_frame = -1;
+
+    for (size_t i = 0; i < (size_t)frames * channels; i++) {
+        double diff = (double)output[i] - (double)reference[i];
+        signal += (double)reference[i] * reference[i];
+        noise += diff * diff;
+        if (diff != 0.0 && result->first_diff_frame < 0) {
+            result->first_diff_frame = (int32_t)(i / channels);
+        }
+        if (fabs(diff) > result->max_error) {
+            result->max_error = fabs(diff);
+            result->max_error_frame = (uint32_t)(i / channels);
+        }
+    }
+
+    result->snr_db = noise == 0.0 ? INFINITY : 10.0 * log10((signal > 0.0 ? signal : 1e-30) / noise);
+}
+
+int audio_regress_run(const char* directory, bool update, const audio_regress_tolerance_t* tolerance) {
+    audio_regress_tolerance_t limits = {AUDIO_REGRESS_MIN_SNR_DB, AUDIO_REGRESS_MAX_ERROR};
+    if (tolerance) {
+        limits = *tolerance;
+    }
+    if (!directory) {
+        directory = AUDIO_REGRESS_DEFAULT_DIR;
+    }
+
+    audio_regress_result_t results[REGRESS_SCENE_COUNT];
+    int failures = 0;
+
+    for (uint32_t s = 0; s < REGRESS_SCENE_COUNT; s++) {
+        audio_regress_result_t* result = &results[s];
+        memset(result, 0, sizeof(*result));
+        result->scene = k_scenes[s].name;
+
+        char path[REGRESS_PATH_MAX];
+        snprintf(path, sizeof(path), "%s/%s.wav", directory, k_scenes[s].name);
+
+        float* output = NULL;
+        uint32_t frames = 0;
+        uint8_t channels = 0;
+        uint32_t sample_rate = 0;
+        int status = audio_regress_render(s, &output, &frames, &channels, &sample_rate);
+        if (status != RETROSAGA_SUCCESS) {
+            return status;
+        }
+        result->frames = frames;
+
+        if (update) {
+            status = write_reference(path, output, frames, channels, sample_rate);
+            free(output);
+            if (status != RETROSAGA_SUCCESS) {
+                printf("[AUDIO_REGRESS] ERROR: Cannot write %s\n", path);
+                return status;
+            }
+            result->passed = true;
+            result->snr_db = INFINITY;
+            result->first_diff_frame = -1;
+            continue;
+        }
+
+        float* reference = NULL;
+        uint32_t reference_frames = 0;
+        uint8_t reference_channels = 0;
+        if (read_reference(path, &reference, &reference_frames, &reference_channels) != RETROSAGA_SUCCESS ||
+            reference_frames != frames || reference_channels != channels) {
+            result->missing_reference = true;
+            failures++;
+            free(reference);
+            free(output);
+            continue;
+        }
+
+        compare_render(output, reference, frames, channels, result);
+        result->passed = result->snr_db >= limits.min_snr_db && result->max_error <= limits.max_error;
+        failures += !result->passed;
+        free(reference);
+        free(output);
+    }
+
+    printf("[AUDIO_REGRESS] %s %u scenes in %s (min SNR %.1f dB, max error %.1e)\n",
+           update ? "Updated" : "Compared", (unsigned)REGRESS_SCENE_COUNT, directory, limits.min_snr_db,
+           limits.max_error);
+    for (uint32_t s = 0; s < REGRESS_SCENE_COUNT; s++) {
+        const audio_regress_result_t* r = &results[s];
+        if (r->missing_reference) {
+            printf("[AUDIO_REGRESS]   FAIL %-20s missing or mismatched reference\n", r->scene);
+        } else if (r->first_diff_frame < 0) {
+            printf("[AUDIO_REGRESS]   %s %-20s identical (%u frames)\n", r->passed ? "ok  " : "FAIL", r->scene,
+                   r->frames);
+        } else {
+            printf("[AUDIO_REGRESS]   %s %-20s SNR %6.1f dB, max error %.2e at frame %u, first diff at %d\n",
+                   r->passed ? "ok  " : "FAIL", r->scene, r->snr_db, r->max_error, r->max_error_frame,
+                   r->first_diff_frame);
+        }
+    }
+    return failures;
+}
@@ -0,0 +1,417 @@
+/*
+ * Audio Resampler
+ * Streaming polyphase windowed-sinc sample-rate conversion
+ */
+
+#define _DEFAULT_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "audio/audio_resampler.h"
+
+typedef struct {
+    const char* name;
+    uint32_t taps;
+    double beta;                 // Kaiser window shape
+    double cutoff;               // -6 dB point as a fraction of the lower Nyquist
+} resampler_preset_t;
+
+static const resampler_preset_t k_presets[AUDIO_RESAMPLER_QUALITY_COUNT] = {
+    {"fast",     16, 6.0,  0.86},
+    {"balanced", 32, 8.6,  0.91},
+    {"best",     64, 12.0, 0.94},
+};
+
+static uint32_t gcd(uint32_t a, uint32_t b) {
+    while (b) {
+        uint32_t t = a % b;
+        a = b;
+        b = t;
+    }
+    return a;
+}
+
+// Zeroth-order modified Bessel function of the first kind
+static double bessel_i0(double x) {
+    double sum = 1.0, term = 1.0;
+    for (int k = 1; k < 50; k++) {
+        term *= (x / (2.0 * k)) * (x / (2.0 * k));
+        sum += term;
+        if (term < sum * 1e-17) {
+            break;
+        }
+    }
+    return sum;
+}
+
+// Phase p of phases: taps centred on the output position p / phases past
+// tap taps / 2 - 1, normalized to unity gain at DC
+static void build_phase(float* row, uint32_t taps, double position, double cutoff, double beta) {
+    const double half = taps / 2.0;
+    double sum = 0.0;
+    double values[AUDIO_RESAMPLER_MAX_TAPS];
+    for (uint32_t k = 0; k < taps; k++) {
+        double t = (double)k - (half - 1.0) - position;
+        double x = M_PI * cutoff * t;
+        double sinc = fabs(x) < 1e-12 ? 1.0 : sin(x) / x;
+        double r = t / half;
+        double window = r * r < 1.0 ? bessel_i0(beta * sqrt(1.0 - r * r)) / bessel_i0(beta) : 0.0;
+        values[k] = cutoff * sinc * window;
+        sum += values[k];
+    }
+    for (uint32_t k = 0; k < taps; k++) {
+        row[k] = (float)(values[k] / sum);
+    }
+}
+
+int audio_resampler_init(audio_resampler_t* rs, uint32_t input_rate, uint32_t output_rate, uint8_t channels,
+                         audio_resampler_quality_t quality, audio_arena_t* arena) {
+    if (!rs || input_rate == 0 || output_rate == 0 || channels == 0 || channels > AUDIO_RESAMPLER_MAX_CHANNELS ||
+        quality >= AUDIO_RESAMPLER_QUALITY_COUNT) {
+        return RETROSAGA_ERROR_INVALID_PARAM;
+    }
+
+    memset(rs, 0, sizeof(*rs));
+    const resampler_preset_t* preset = &k_presets[quality];
+    uint32_t divisor = gcd(input_rate, output_rate);
+    rs->input_rate = input_rate;
+    rs->output_rate = output_rate;
+    rs->channels = channels;
+    rs->quality = quality;
+    rs->step_num = input_rate / divisor;
+    rs->step_den = output_rate / divisor;
+
+    // Downsampling moves the cutoff to the output Nyquist; the filter grows
+    // by the same factor to keep its transition band
+    double scale = output_rate < input_rate ? (double)output_rate / input_rate : 1.0;
+    uint32_t taps = (uint32_t)ceil(preset->taps / scale);
+    taps = (taps + 7u) & ~7u;
+    rs->taps = taps < AUDIO_RESAMPLER_MAX_TAPS ? taps : AUDIO_RESAMPLER_MAX_TAPS;
+    rs->blend = rs->step_den > AUDIO_RESAMPLER_MAX_PHASES;
+    rs->phases = rs->blend ? AUDIO_RESAMPLER_PHASES : rs->step_den;
+    rs->capacity = rs->taps + AUDIO_RESAMPLER_CHUNK;
+
+    void* coefficients = NULL;
+    void* history = NULL;
+    size_t coefficient_bytes = (size_t)(rs->phases + 1) * rs->taps * sizeof(float);
+    size_t history_bytes = (size_t)channels * rs->capacity * sizeof(float);
+    if (arena) {
+        coefficients = audio_arena_alloc(arena, coefficient_bytes);
+        history = audio_arena_alloc(arena, history_bytes);
+        if (!coefficients || !history) {
+            memset(rs, 0, sizeof(*rs));
+            return RETROSAGA_ERROR_AUDIO_INIT;
+        }
+    } else if (posix_memalign(&coefficients, 64, coefficient_bytes) != 0 ||
+               posix_memalign(&history, 64, history_bytes) != 0) {
+        free(coefficients);
+        memset(rs, 0, sizeof(*rs));
+        return RETROSAGA_ERROR_AUDIO_INIT;
+    }
+    rs->coefficients = coefficients;
+    rs->history = history;
+    rs->arena_backed = arena != NULL;
+
+    // Row phases repeats row 0 one tap later, so blending never wraps
+    for (uint32_t p = 0; p <= rs->phases; p++) {
+        build_phase(rs->coefficients + (size_t)p * rs->taps, rs->taps, (double)p / rs->phases,
+                    preset->cutoff * scale, preset->beta);
+    }
+    audio_resampler_reset(rs);
+    return RETROSAGA_SUCCESS;
+}
+
+void audio_resampler_destroy(audio_resampler_t* rs) {
+    if (!rs) {
+        return;
+    }
+    if (!rs->arena_backed) {
+        free(rs->coefficients);
+        free(rs->history);
+    }
+    memset(rs, 0, sizeof(*rs));
+}
+
+void audio_resampler_reset(audio_resampler_t* rs) {
+    // Leading zeros put the first input frame under the centre tap
+    memset(rs->history, 0, (size_t)rs->channels * rs->capacity * sizeof(float));
+    rs->buffered = rs->taps / 2 - 1;
+    rs->silent_frames = rs->buffered;
+    rs->base = 0;
+    rs->fraction = 0;
+    rs->frames_in = 0;
+    rs->frames_out = 0;
+    rs->frames_dropped = 0;
+}
+
+uint32_t audio_resampler_max_output(const audio_resampler_t* rs, uint32_t input_frames) {
+    // Outputs k with base + floor((fraction + k * num) / den) + taps <= buffered + input
+    int64_t room = (int64_t)rs->buffered + input_frames - rs->taps - rs->base;
+    if (room < 0) {
+        return 0;
+    }
+    uint64_t limit = (uint64_t)(room + 1) * rs->step_den - rs->fraction - 1;
+    uint64_t count = limit / rs->step_num + 1;
+    return count < UINT32_MAX ? (uint32_t)count : UINT32_MAX;
+}
+
+uint32_t audio_resampler_input_for_output(const audio_resampler_t* rs, uint32_t output_frames) {
+    if (output_frames == 0) {
+        return 0;
+    }
+    uint64_t last = rs->base + ((uint64_t)rs->fraction + (uint64_t)(output_frames - 1) * rs->step_num) / rs->step_den;
+    uint64_t needed = last + rs->taps;
+    return needed > rs->buffered ? (uint32_t)(needed - rs->buffered) : 0;
+}
+
+// Four lanes, two accumulators; taps is a multiple of 8
+typedef float resampler_vec_t __attribute__((vector_size(4 * sizeof(float))));
+
+static inline resampler_vec_t vec_load(const float* source) {
+    resampler_vec_t value;
+    memcpy(&value, source, sizeof(value));
+    return value;
+}
+
+static inline float inner_product(const float* restrict x, const float* restrict h, uint32_t taps) {
+    resampler_vec_t acc0 = {0.0f, 0.0f, 0.0f, 0.0f};
+    resampler_vec_t acc1 = acc0;
+    for (uint32_t k = 0; k < taps; k += 8) {
+        acc0 += vec_load(x + k) * vec_load(h + k);
+        acc1 += vec_load(x + k + 4) * vec_load(h + k + 4);
+    }
+    acc0 += acc1;
+    return (acc0[0] + acc0[2]) + (acc0[1] + acc0[3]);
+}
+
+// Outputs while the window is complete and there is room for them
+static uint32_t produce(audio_resampler_t* rs, float* output, uint32_t capacity) {
+    const uint32_t taps = rs->taps;
+    const uint8_t channels = rs->channels;
+    uint32_t produced = 0;
+
+    while (produced < capacity && rs->base + taps <= rs->buffered) {
+        float* frame = output + (size_t)produced * channels;
+        if (rs->base >= rs->buffered - rs->silent_frames) {
+            memset(frame, 0, channels * sizeof(float));
+        } else {
+            uint64_t scaled = (uint64_t)rs->fraction * rs->phases;
+            uint32_t phase = (uint32_t)(scaled / rs->step_den);
+            const float* h = rs->coefficients + (size_t)phase * taps;
+            const float* x = rs->history + rs->base;
+            if (rs->blend) {
+                float t = (float)(scaled % rs->step_den) / (float)rs->step_den;
+                for (uint8_t c = 0; c < channels; c++, x += rs->capacity) {
+                    float a = inner_product(x, h, taps);
+                    float b = inner_product(x, h + taps, taps);
+                    frame[c] = a + t * (b - a);
+                }
+            } else {
+                for (uint8_t c = 0; c < channels; c++, x += rs->capacity) {
+                    frame[c] = inner_product(x, h, taps);
+                }
+            }
+        }
+
+        rs->fraction += rs->step_num;
+        rs->base += rs->fraction / rs->step_den;
+        rs->fraction %= rs->step_den;
+        produced++;
+    }
+    return produced;
+}
+
+uint32_t audio_resampler_process(audio_resampler_t* rs, const float* input, uint32_t input_frames, float* output,
+                                 uint32_t output_capacity) {
+    const uint8_t channels = rs->channels;
+    uint32_t consumed = 0;
+    uint32_t produced = 0;
+
+    for (;;) {
+        produced += produce(rs, output + (size_t)produced * channels, output_capacity - produced);
+        if (consumed == input_frames) {
+            break;
+        }
+
+        // Drop history no later output can reach
+        uint32_t keep = rs->base < rs->buffered ? rs->buffered - rs->base : 0;
+        uint32_t shift = rs->buffered - keep;
+        if (shift > 0) {
+            for (uint8_t c = 0; c < channels; c++) {
+                float* row = rs->history + (size_t)c * rs->capacity;
+                memmove(row, row + shift, (size_t)keep * sizeof(float));
+            }
+            rs->buffered = keep;
+            rs->base -= shift;
+            rs->silent_frames = rs->silent_frames < keep ? rs->silent_frames : keep;
+        }
+
+        uint32_t count = rs->capacity - rs->buffered;
+        count = count < input_frames - consumed ? count : input_frames - consumed;
+        if (count == 0) {
+            break;
+        }
+        for (uint8_t c = 0; c < channels; c++) {
+            float* row = rs->history + (size_t)c * rs->capacity + rs->buffered;
+            if (!input) {
+                memset(row, 0, (size_t)count * sizeof(float));
+                continue;
+            }
+            const float* source = input + (size_t)consumed * channels + c;
+            for (uint32_t i = 0; i < count; i++) {
+                row[i] = source[(size_t)i * channels];
+            }
+        }
+        rs->silent_frames = input ? 0 : rs->silent_frames + count;
+        rs->buffered += count;
+        consumed += count;
+    }
+
+    rs->frames_in += consumed;
+    rs->frames_out += produced;
+    rs->frames_dropped += input_frames - consumed;
+    return produced;
+}
+
+bool audio_resampler_parse_quality(const char* name, audio_resampler_quality_t* quality) {
+    for (int q = 0; q < AUDIO_RESAMPLER_QUALITY_COUNT; q++) {
+        if (strcmp(name, k_presets[q].name) == 0) {
+            *quality = (audio_resampler_quality_t)q;
+            return true;
+        }
+    }
+    return false;
+}
+
+const char* audio_resampler_quality_name(audio_resampler_quality_t quality) {
+    return quality < AUDIO_RESAMPLER_QUALITY_COUNT ? k_presets[quality].name : "unknown";
+}
+
+// A sine fed in uneven blocks must match one fed whole, and both must
+// match the ideal sine at the output rate; returns the worst error
+static double check_conversion(uint32_t input_rate, uint32_t output_rate, audio_resampler_quality_t quality,
+                               bool* streaming_matches) {
+    enum { INPUT_FRAMES = 8192, CHANNELS = 2, MAX_OUTPUT = 2 * INPUT_FRAMES };
+    static float input[INPUT_FRAMES * CHANNELS], whole[MAX_OUTPUT * CHANNELS], pieces[MAX_OUTPUT * CHANNELS];
+    static const uint32_t block_sizes[] = {1, 37, 256, 5, 1000, 64, 333};
+    const double frequency = 1000.0;
+
+    for (uint32_t i = 0; i < INPUT_FRAMES; i++) {
+        double phase = 2.0 * M_PI * frequency * i / input_rate;
+        input[i * CHANNELS] = (float)(0.5 * sin(phase));
+        input[i * CHANNELS + 1] = (float)(0.5 * cos(phase));
+    }
+
+    audio_resampler_t rs;
+    if (audio_resampler_init(&rs, input_rate, output_rate, CHANNELS, quality, NULL) != RETROSAGA_SUCCESS) {
+        *streaming_matches = false;
+        return INFINITY;
+    }
+    uint32_t whole_frames = audio_resampler_process(&rs, input, INPUT_FRAMES, whole, MAX_OUTPUT);
+
+    audio_resampler_reset(&rs);
+    uint32_t piece_frames = 0;
+    for (uint32_t done = 0, b = 0; done < INPUT_FRAMES; b = (b + 1) % 7) {
+        uint32_t count = block_sizes[b] < INPUT_FRAMES - done ? block_sizes[b] : INPUT_FRAMES - done;
+        piece_frames += audio_resampler_process(&rs, input + (size_t)done * CHANNELS, count,
+                                                pieces + (size_t)piece_frames * CHANNELS, MAX_OUTPUT - piece_frames);
+        done += count;
+    }
+    *streaming_matches = piece_frames == whole_frames &&
+                         memcmp(whole, pieces, (size_t)whole_frames * CHANNELS * sizeof(float)) == 0;
+
+    // Output n sits at input time n * input_rate / output_rate; the edges
+    // see the zeros before and after the signal
+    double worst = 0.0;
+    uint32_t margin = rs.taps;
+    for (uint32_t n = margin; n + margin < whole_frames; n++) {
+        double phase = 2.0 * M_PI * frequency * n / output_rate;
+        double error = fmax(fabs(whole[n * CHANNELS] - 0.5 * sin(phase)), fabs(whole[n * CHANNELS + 1] - 0.5 * cos(phase)));
+        worst = error > worst ? error : worst;
+    }
+    audio_resampler_destroy(&rs);
+    return worst;
+}
+
+// RMS level in dB of a tone above the output Nyquist after downsampling
+static double alias_level(audio_resampler_quality_t quality) {
+    enum { INPUT_RATE = 48000, OUTPUT_RATE = 22050, FRAMES = 16384 };
+    static float input[FRAMES], output[FRAMES];
+    for (uint32_t i = 0; i < FRAMES; i++) {
+        input[i] = (float)sin(2.0 * M_PI * 14000.0 * i / INPUT_RATE);
+    }
+
+    audio_resampler_t rs;
+    if (audio_resampler_init(&rs, INPUT_RATE, OUTPUT_RATE, 1, quality, NULL) != RETROSAGA_SUCCESS) {
+        return 0.0;
+    }
+    uint32_t frames = audio_resampler_process(&rs, input, FRAMES, output, FRAMES);
+    double energy = 0.0;
+    for (uint32_t n = rs.taps; n + rs.taps < frames; n++) {
+        energy += (double)output[n] * output[n];
+    }
+    uint32_t measured = frames > 2 * rs.taps ? frames - 2 * rs.taps : 1;
+    audio_resampler_destroy(&rs);
+    return 10.0 * log10(2.0 * energy / measured + 1e-30);
+}
+
+bool audio_resampler_validate(void) {
+    static const struct {
+        uint32_t input_rate;
+        uint32_t output_rate;
+        audio_resampler_quality_t quality;
+        double max_error;
+    } cases[] = {
+        {44100, 48000, AUDIO_RESAMPLER_BEST, 2e-6},
+        {48000, 44100, AUDIO_RESAMPLER_BALANCED, 1e-4},
+        {44100, 47999, AUDIO_RESAMPLER_BEST, 2e-6},     // Blended phases
+        {96000, 44100, AUDIO_RESAMPLER_FAST, 5e-4},
+        {22050, 44100, AUDIO_RESAMPLER_FAST, 1e-3},
+    };
+
+    bool valid = true;
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        bool streaming_matches = false;
+        double worst = check_conversion(cases[i].input_rate, cases[i].output_rate, cases[i].quality,
+                                        &streaming_matches);
+        if (!streaming_matches || !(worst < cases[i].max_error)) {
+            printf("[AUDIO_RESAMPLER] ERROR: %u -> %u Hz (%s): error %.2e%s\n", cases[i].input_rate,
+                   cases[i].output_rate, audio_resampler_quality_name(cases[i].quality), worst,
+                   streaming_matches ? "" : ", block size changes the output");
+            valid = false;
+        }
+    }
+
+    // 14 kHz cannot be represented at 22050 Hz and must not fold back
+    static const double max_alias_db[AUDIO_RESAMPLER_QUALITY_COUNT] = {-65.0, -90.0, -120.0};
+    for (int q = 0; q < AUDIO_RESAMPLER_QUALITY_COUNT; q++) {
+        double level = alias_level((audio_resampler_quality_t)q);
+        if (!(level < max_alias_db[q])) {
+            printf("[AUDIO_RESAMPLER] ERROR: %s: alias at %.1f dB\n", k_presets[q].name, level);
+            valid = false;
+        }
+    }
+
+    // Pulling a fixed output block takes exactly the input it asks for,
+    // and silence after the signal comes out as exact zeros
+    audio_resampler_t rs;
+    float block[256 * 2];
+    valid &= audio_resampler_init(&rs, 44100, 48000, 2, AUDIO_RESAMPLER_BALANCED, NULL) == RETROSAGA_SUCCESS;
+    for (int b = 0; b < 8 && valid; b++) {
+        uint32_t needed = audio_resampler_input_for_output(&rs, 256);
+        valid &= audio_resampler_process(&rs, NULL, needed, block, 256) == 256 &&
+                 audio_resampler_max_output(&rs, 0) == 0;
+    }
+    float one[2] = {1.0f, 1.0f};
+    audio_resampler_process(&rs, one, 1, block, 256);
+    uint32_t tail = audio_resampler_process(&rs, NULL, 200, block, 256);
+    valid &= tail > 0 && block[0] != 0.0f && block[2 * tail - 1] == 0.0f && rs.frames_dropped == 0;
+    audio_resampler_destroy(&rs);
+
+    if (!valid) {
+        printf("[AUDIO_RESAMPLER] ERROR: Streaming conversion failed validation\n");
+    }
+    return valid;
+}
@@ -0,0 +1,126 @@
+/*
+ * Audio Ring Buffer
+ * Lock-free single-producer/single-consumer block ring
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "audio/audio_ring.h"
+
+static uint32_t round_up_power_of_2(uint32_t value) {
+    uint32_t result = 1;
+    while (result < value) {
+        result <<= 1;
+    }
+    return result;
+}
+
+int audio_ring_init(audio_ring_t* ring, uint32_t slot_count, uint32_t slot_frames, uint8_t channels) {
+    if (!ring || slot_count < 2 || slot_frames == 0 || channels == 0) {
+        return RETROSAGA_ERROR_INVALID_PARAM;
+    }
+
+    memset(ring, 0, sizeof(*ring));
+
+    const uint32_t floats_per_line = AUDIO_RING_CACHE_LINE / sizeof(float);
+    uint32_t slot_floats = slot_frames * channels;
+
+    ring->slot_count = round_up_power_of_2(slot_count);
+    ring->slot_mask = ring->slot_count - 1;
+    ring->slot_frames = slot_frames;
+    ring->slot_stride = (slot_floats + floats_per_line - 1) & ~(floats_per_line - 1);
+    ring->channels = channels;
+
+    void* storage = NULL;
+    size_t storage_bytes = (size_t)ring->slot_stride * ring->slot_count * sizeof(float);
+    if (posix_memalign(&storage, AUDIO_RING_CACHE_LINE, storage_bytes) != 0) {
+        return RETROSAGA_ERROR_AUDIO_INIT;
+    }
+    memset(storage, 0, storage_bytes);
+
+    ring->slot_frames_used = calloc(ring->slot_count, sizeof(uint32_t));
+    if (!ring->slot_frames_used) {
+        free(storage);
+        return RETROSAGA_ERROR_AUDIO_INIT;
+    }
+
+    ring->storage = storage;
+    return RETROSAGA_SUCCESS;
+}
+
+void audio_ring_destroy(audio_ring_t* ring) {
+    if (!ring) {
+        return;
+    }
+
+    free(ring->storage);
+    free(ring->slot_frames_used);
+    memset(ring, 0, sizeof(*ring));
+}
+
+void audio_ring_reset(audio_ring_t* ring) {
+    __atomic_store_n(&ring->write_index, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&ring->read_index, 0, __ATOMIC_RELAXED);
+    ring->overruns = 0;
+    ring->blocks_written = 0;
+    ring->blocks_read = 0;
+}
+
+bool audio_ring_writable(const audio_ring_t* ring) {
+    uint32_t write_index = __atomic_load_n(&ring->write_index, __ATOMIC_RELAXED);
+    uint32_t read_index = __atomic_load_n(&ring->read_index, __ATOMIC_ACQUIRE);
+    return (write_index - read_index) < ring->slot_count;
+}
+
+float* audio_ring_write_acquire(audio_ring_t* ring) {
+    if (!audio_ring_writable(ring)) {
+        __atomic_add_fetch(&ring->overruns, 1, __ATOMIC_RELAXED);
+        return NULL;
+    }
+
+    uint32_t write_index = __atomic_load_n(&ring->write_index, __ATOMIC_RELAXED);
+    return ring->storage + (size_t)(write_index & ring->slot_mask) * ring->slot_stride;
+}
+
+void audio_ring_write_commit(audio_ring_t* ring, uint32_t frames) {
+    uint32_t write_index = __atomic_load_n(&ring->write_index, __ATOMIC_RELAXED);
+
+    ring->slot_frames_used[write_index & ring->slot_mask] =
+        (frames > ring->slot_frames) ? ring->slot_frames : frames;
+    __atomic_add_fetch(&ring->blocks_written, 1, __ATOMIC_RELAXED);
+
+    // Publish slot contents before advancing the index
+    __atomic_store_n(&ring->write_index, write_index + 1, __ATOMIC_RELEASE);
+}
+
+float* audio_ring_read_acquire(audio_ring_t* ring, uint32_t* frames) {
+    uint32_t read_index = __atomic_load_n(&ring->read_index, __ATOMIC_RELAXED);
+    uint32_t write_index = __atomic_load_n(&ring->write_index, __ATOMIC_ACQUIRE);
+
+    if (read_index == write_index) {
+        return NULL;
+    }
+
+    uint32_t slot = read_index & ring->slot_mask;
+    if (frames) {
+        *frames = ring->slot_frames_used[slot];
+    }
+    return ring->storage + (size_t)slot * ring->slot_stride;
+}
+
+void audio_ring_read_release(audio_ring_t* ring) {
+    uint32_t read_index = __atomic_load_n(&ring->read_index, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&ring->blocks_read, 1, __ATOMIC_RELAXED);
+
+    // Hand the slot back to the producer only after processing finished
+    __atomic_store_n(&ring->read_index, read_index + 1, __ATOMIC_RELEASE);
+}
+
+uint32_t audio_ring_fill_level(const audio_ring_t* ring) {
+    uint32_t write_index = __atomic_load_n(&ring->write_index, __ATOMIC_ACQUIRE);
+    uint32_t read_index = __atomic_load_n(&ring->read_index, __ATOMIC_ACQUIRE);
+    return write_index - read_index;
+}
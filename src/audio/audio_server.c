@@ -0,0 +1,1158 @@
+/*
+ * Audio Server
+ * Local render server sharing one engine between client processes
+ */
+
+#define _GNU_SOURCE   // memfd_create, file seals, syscall
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <limits.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <poll.h>
+#include <time.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <linux/futex.h>
+#include "audio/audio_server.h"
+#include "audio/audio_snapshot.h"
+#include "audio/midi_processing.h"
+#include "audio/midi_ump.h"
+#include "audio/voice_manager.h"
+
+#define SERVER_MAX_PATH        108   // sun_path
+#define SERVER_POLL_MS         50
+#define SERVER_IDLE_WAIT_MS    100
+#define SERVER_HANDSHAKE_MS    2000
+#define SERVER_MIN_EVENT_WORDS 64
+
+typedef enum {
+    SESSION_FREE = 0,
+    SESSION_LIVE,              // Control thread created it; render thread serves it
+    SESSION_HANGUP,            // Control thread saw the client go
+    SESSION_RETIRED            // Render thread is done with it; control thread frees it
+} session_state_t;
+
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t block_frames;
+    uint32_t slot_count;
+    uint32_t event_words;
+} connect_request_t;
+
+typedef struct {
+    uint32_t magic;
+    int32_t status;
+} connect_reply_t;
+
+typedef struct {
+    int state;                 // session_state_t, accessed atomically
+    int connection;
+    audio_server_shared_t* shared;
+    size_t region_bytes;
+    uint32_t* events;
+    uint8_t* slots;
+
+    // Geometry chosen at open; the copy in the shared header is only for
+    // the client, which can write to it
+    uint32_t block_frames;
+    uint32_t slot_count;
+    uint32_t event_words;
+    size_t slot_bytes;
+    uint32_t slot_mask;
+    uint32_t event_mask;
+
+    // Render thread only
+    uint32_t served;
+    uint32_t event_tail;
+    uint64_t frames;
+    uint8_t* snapshot;         // Engine state while another session is resident
+    size_t snapshot_capacity;
+    size_t snapshot_size;      // 0 until first switched out: starts from the baseline
+} server_session_t;
+
+typedef struct {
+    bool initialized;
+    uint32_t operations_count;
+
+    bool serving;
+    bool running;              // Accessed atomically; cleared to stop both threads
+    pthread_t render_thread;
+    pthread_t control_thread;
+
+    char path[SERVER_MAX_PATH];
+    uint32_t max_clients;
+    int listener;
+    int doorbell_fd;
+    audio_server_doorbell_t* doorbell;
+
+    server_session_t sessions[AUDIO_SERVER_MAX_CLIENTS];
+    server_session_t* resident;
+    uint8_t* baseline;         // Engine state at start: new sessions, and the host on stop
+    size_t baseline_size;
+    uint32_t scratch[AUDIO_SERVER_MAX_EVENT_WORDS];
+
+    uint64_t sessions_opened;  // Counters below are read atomically by get_stats
+    uint64_t connections_refused;
+    uint64_t blocks_rendered;
+    uint64_t frames_rendered;
+    uint64_t event_words;
+    uint64_t session_switches;
+    uint64_t protocol_errors;
+} audio_server_state_t;
+
+static audio_server_state_t g_server_state = {0};
+
+// ---------------------------------------------------------------------------
+// Shared helpers
+// ---------------------------------------------------------------------------
+
+static long futex_wait(uint32_t* word, uint32_t expected, int timeout_ms) {
+    struct timespec timeout = {timeout_ms / 1000, (long)(timeout_ms % 1000) * 1000000L};
+    return syscall(SYS_futex, word, FUTEX_WAIT, expected, &timeout, NULL, 0);
+}
+
+static void futex_wake(uint32_t* word) {
+    syscall(SYS_futex, word, FUTEX_WAKE, INT_MAX, NULL, NULL, 0);
+}
+
+static uint32_t round_up_pow2(uint32_t value) {
+    uint32_t result = 1;
+    while (result < value) {
+        result <<= 1;
+    }
+    return result;
+}
+
+static size_t round_up(size_t value, size_t multiple) {
+    return (value + multiple - 1) / multiple * multiple;
+}
+
+static int64_t monotonic_ms(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (int64_t)now.tv_sec * 1000 + now.tv_nsec / 1000000;
+}
+
+static bool socket_address(const char* path, struct sockaddr_un* address) {
+    if (!path || strlen(path) >= sizeof(address->sun_path)) {
+        return false;
+    }
+    memset(address, 0, sizeof(*address));
+    address->sun_family = AF_UNIX;
+    strcpy(address->sun_path, path);
+    return true;
+}
+
+static void set_receive_timeout(int fd, int timeout_ms) {
+    struct timeval timeout = {timeout_ms / 1000, (timeout_ms % 1000) * 1000};
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+}
+
+// Sealed memfd so a client can neither shrink the pages under the server
+// nor grow them
+static int create_region(const char* name, size_t bytes, void** mapping) {
+    int fd = memfd_create(name, MFD_CLOEXEC | MFD_ALLOW_SEALING);
+    if (fd < 0) {
+        return -1;
+    }
+    if (ftruncate(fd, (off_t)bytes) != 0 ||
+        fcntl(fd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_SEAL) != 0) {
+        close(fd);
+        return -1;
+    }
+    *mapping = mmap(NULL, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (*mapping == MAP_FAILED) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+static void ring_doorbell(audio_server_doorbell_t* doorbell) {
+    __atomic_add_fetch(&doorbell->doorbell, 1, __ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&doorbell->sleeping, __ATOMIC_SEQ_CST)) {
+        futex_wake(&doorbell->doorbell);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Sessions
+// ---------------------------------------------------------------------------
+
+static int open_session(audio_server_state_t* state, server_session_t* session, const connect_request_t* request) {
+    const retrosaga_audio_config_t* engine = retrosaga_audio_get_config();
+    uint32_t slot_count = round_up_pow2(request->slot_count);
+    uint32_t event_words = round_up_pow2(request->event_words);
+    event_words = event_words < SERVER_MIN_EVENT_WORDS ? SERVER_MIN_EVENT_WORDS : event_words;
+    if (request->block_frames == 0 || request->block_frames > AUDIO_SERVER_MAX_BLOCK_FRAMES || slot_count == 0 ||
+        slot_count > AUDIO_SERVER_MAX_SLOTS || event_words > AUDIO_SERVER_MAX_EVENT_WORDS) {
+        return RETROSAGA_ERROR_INVALID_PARAM;
+    }
+
+    size_t events_offset = round_up(sizeof(audio_server_shared_t), AUDIO_SERVER_CACHE_LINE);
+    size_t slots_offset = events_offset + round_up(event_words * sizeof(uint32_t), AUDIO_SERVER_CACHE_LINE);
+    size_t slot_bytes = round_up(sizeof(audio_server_slot_t) +
+                                 (size_t)request->block_frames * engine->channels * sizeof(float),
+                                 AUDIO_SERVER_CACHE_LINE);
+    size_t region_bytes = round_up(slots_offset + slot_count * slot_bytes, (size_t)sysconf(_SC_PAGESIZE));
+
+    void* mapping = NULL;
+    int fd = create_region("retrosaga-session", region_bytes, &mapping);
+    size_t snapshot_capacity = state->baseline_size * 2 + 4096;
+    uint8_t* snapshot = fd >= 0 ? malloc(snapshot_capacity) : NULL;
+    if (!snapshot) {
+        if (fd >= 0) {
+            munmap(mapping, region_bytes);
+            close(fd);
+        }
+        return RETROSAGA_ERROR_AUDIO_INIT;
+    }
+
+    audio_server_shared_t* shared = mapping;
+    shared->magic = AUDIO_SERVER_MAGIC;
+    shared->version = AUDIO_SERVER_VERSION;
+    shared->sample_rate = engine->sample_rate;
+    shared->channels = engine->channels;
+    shared->block_frames = request->block_frames;
+    shared->slot_count = slot_count;
+    shared->event_words = event_words;
+    shared->slot_bytes = (uint32_t)slot_bytes;
+    shared->events_offset = (uint32_t)events_offset;
+    shared->slots_offset = (uint32_t)slots_offset;
+    shared->region_bytes = (uint32_t)region_bytes;
+
+    session->shared = shared;
+    session->region_bytes = region_bytes;
+    session->events = (uint32_t*)((uint8_t*)mapping + events_offset);
+    session->slots = (uint8_t*)mapping + slots_offset;
+    session->block_frames = request->block_frames;
+    session->slot_count = slot_count;
+    session->event_words = event_words;
+    session->slot_bytes = slot_bytes;
+    session->slot_mask = slot_count - 1;
+    session->event_mask = event_words - 1;
+    session->served = 0;
+    session->event_tail = 0;
+    session->frames = 0;
+    session->snapshot = snapshot;
+    session->snapshot_capacity = snapshot_capacity;
+    session->snapshot_size = 0;
+    return fd;
+}
+
+static void free_session(server_session_t* session) {
+    if (session->connection >= 0) {
+        close(session->connection);
+    }
+    if (session->shared) {
+        munmap(session->shared, session->region_bytes);
+    }
+    free(session->snapshot);
+    memset(session, 0, sizeof(*session));
+    session->connection = -1;
+}
+
+static void send_reply(int connection, int32_t status, int session_fd, int doorbell_fd) {
+    connect_reply_t reply = {AUDIO_SERVER_MAGIC, status};
+    struct iovec iov = {&reply, sizeof(reply)};
+    union {
+        struct cmsghdr header;
+        char space[CMSG_SPACE(2 * sizeof(int))];
+    } control;
+    struct msghdr message = {0};
+    message.msg_iov = &iov;
+    message.msg_iovlen = 1;
+
+    if (status == RETROSAGA_SUCCESS) {
+        int fds[2] = {session_fd, doorbell_fd};
+        memset(&control, 0, sizeof(control));
+        message.msg_control = control.space;
+        message.msg_controllen = sizeof(control.space);
+        struct cmsghdr* header = CMSG_FIRSTHDR(&message);
+        header->cmsg_level = SOL_SOCKET;
+        header->cmsg_type = SCM_RIGHTS;
+        header->cmsg_len = CMSG_LEN(sizeof(fds));
+        memcpy(CMSG_DATA(header), fds, sizeof(fds));
+    }
+    sendmsg(connection, &message, MSG_NOSIGNAL);
+}
+
+static void accept_client(audio_server_state_t* state) {
+    int connection = accept4(state->listener, NULL, NULL, SOCK_CLOEXEC);
+    if (connection < 0) {
+        return;
+    }
+
+    connect_request_t request;
+    set_receive_timeout(connection, SERVER_HANDSHAKE_MS);
+    ssize_t received = recv(connection, &request, sizeof(request), 0);
+    int32_t status = RETROSAGA_SUCCESS;
+    if (received != (ssize_t)sizeof(request) || request.magic != AUDIO_SERVER_MAGIC ||
+        request.version != AUDIO_SERVER_VERSION) {
+        status = RETROSAGA_ERROR_CONFIG;
+    }
+
+    server_session_t* session = NULL;
+    for (uint32_t i = 0; status == RETROSAGA_SUCCESS && i < state->max_clients; i++) {
+        if (__atomic_load_n(&state->sessions[i].state, __ATOMIC_ACQUIRE) == SESSION_FREE) {
+            session = &state->sessions[i];
+            break;
+        }
+    }
+    if (status == RETROSAGA_SUCCESS && !session) {
+        status = RETROSAGA_ERROR_AUDIO_INIT;
+    }
+
+    int session_fd = -1;
+    if (status == RETROSAGA_SUCCESS) {
+        session_fd = open_session(state, session, &request);
+        status = session_fd < 0 ? session_fd : RETROSAGA_SUCCESS;
+    }
+    send_reply(connection, status, session_fd, state->doorbell_fd);
+
+    if (status != RETROSAGA_SUCCESS) {
+        printf("[AUDIO_SERVER] Connection refused (%d)\n", status);
+        __atomic_add_fetch(&state->connections_refused, 1, __ATOMIC_RELAXED);
+        close(connection);
+        return;
+    }
+    close(session_fd);   // The mapping and the client keep the memory alive
+    session->connection = connection;
+    __atomic_add_fetch(&state->sessions_opened, 1, __ATOMIC_RELAXED);
+    __atomic_store_n(&session->state, SESSION_LIVE, __ATOMIC_RELEASE);
+}
+
+// Control thread: handshakes, hangups, and freeing retired sessions
+static void* control_thread_main(void* arg) {
+    audio_server_state_t* state = arg;
+    struct pollfd fds[AUDIO_SERVER_MAX_CLIENTS + 1];
+    server_session_t* watched[AUDIO_SERVER_MAX_CLIENTS + 1];
+
+    while (__atomic_load_n(&state->running, __ATOMIC_ACQUIRE)) {
+        nfds_t count = 0;
+        fds[count++] = (struct pollfd){state->listener, POLLIN, 0};
+        for (uint32_t i = 0; i < state->max_clients; i++) {
+            server_session_t* session = &state->sessions[i];
+            int session_state = __atomic_load_n(&session->state, __ATOMIC_ACQUIRE);
+            if (session_state == SESSION_RETIRED) {
+                free_session(session);
+                __atomic_store_n(&session->state, SESSION_FREE, __ATOMIC_RELEASE);
+            } else if (session_state == SESSION_LIVE) {
+                watched[count] = session;
+                fds[count++] = (struct pollfd){session->connection, POLLIN, 0};
+            }
+        }
+
+        if (poll(fds, count, SERVER_POLL_MS) <= 0) {
+            continue;
+        }
+        if (fds[0].revents & POLLIN) {
+            accept_client(state);
+        }
+        // Clients never send after the handshake, so any activity is a hangup
+        for (nfds_t i = 1; i < count; i++) {
+            if (fds[i].revents == 0) {
+                continue;
+            }
+            char byte;
+            if (recv(fds[i].fd, &byte, 1, MSG_DONTWAIT) > 0) {
+                continue;
+            }
+            int expected = SESSION_LIVE;
+            __atomic_compare_exchange_n(&watched[i]->state, &expected, SESSION_HANGUP, false, __ATOMIC_ACQ_REL,
+                                        __ATOMIC_ACQUIRE);
+            ring_doorbell(state->doorbell);
+        }
+    }
+    return NULL;
+}
+
+// ---------------------------------------------------------------------------
+// Rendering (render thread)
+// ---------------------------------------------------------------------------
+
+static void retire_session(audio_server_state_t* state, server_session_t* session) {
+    if (state->resident == session) {
+        state->resident = NULL;
+    }
+    __atomic_store_n(&session->shared->closed, 1, __ATOMIC_SEQ_CST);
+    futex_wake(&session->shared->rendered);
+    __atomic_store_n(&session->state, SESSION_RETIRED, __ATOMIC_RELEASE);
+}
+
+static void protocol_error(audio_server_state_t* state, server_session_t* session, const char* reason) {
+    printf("[AUDIO_SERVER] Closing session: %s\n", reason);
+    __atomic_add_fetch(&state->protocol_errors, 1, __ATOMIC_RELAXED);
+    retire_session(state, session);
+}
+
+static bool save_resident(server_session_t* session) {
+    size_t size = 0;
+    if (audio_snapshot_save(session->snapshot, session->snapshot_capacity, session->frames, &size) ==
+        RETROSAGA_SUCCESS) {
+        session->snapshot_size = size;
+        return true;
+    }
+    // More voices or queued events than ever before: grow and retry
+    uint8_t* grown = realloc(session->snapshot, size + size / 2);
+    if (!grown) {
+        return false;
+    }
+    session->snapshot = grown;
+    session->snapshot_capacity = size + size / 2;
+    return save_resident(session);
+}
+
+// Swap the engine over to a session; a lone session stays resident
+static bool make_resident(audio_server_state_t* state, server_session_t* session) {
+    if (state->resident == session) {
+        return true;
+    }
+    server_session_t* previous = state->resident;
+    if (previous && !save_resident(previous)) {
+        protocol_error(state, previous, "Out of memory for its engine state");
+    }
+    const uint8_t* source = session->snapshot_size ? session->snapshot : state->baseline;
+    size_t size = session->snapshot_size ? session->snapshot_size : state->baseline_size;
+    state->resident = NULL;
+    if (audio_snapshot_restore(source, size) != RETROSAGA_SUCCESS) {
+        return false;
+    }
+    state->resident = session;
+    __atomic_add_fetch(&state->session_switches, previous != NULL, __ATOMIC_RELAXED);
+    return true;
+}
+
+// Render the oldest requested block of a session; false when none is due
+static bool serve_block(audio_server_state_t* state, server_session_t* session) {
+    audio_server_shared_t* shared = session->shared;
+    uint32_t requested = __atomic_load_n(&shared->requested, __ATOMIC_ACQUIRE);
+    uint32_t due = requested - session->served;
+    if (due == 0) {
+        return false;
+    }
+    if (due > session->slot_count) {
+        protocol_error(state, session, "More blocks requested than slots");
+        return true;
+    }
+
+    audio_server_slot_t* slot = (audio_server_slot_t*)(session->slots +
+                                                       (size_t)(session->served & session->slot_mask) *
+                                                       session->slot_bytes);
+    uint32_t event_end = __atomic_load_n(&slot->event_end, __ATOMIC_RELAXED);
+    uint32_t words = event_end - session->event_tail;
+    if (words > session->event_words) {
+        protocol_error(state, session, "Event ring overrun");
+        return true;
+    }
+
+    // Events leave the shared ring before the engine sees them, so the
+    // client cannot change them halfway through parsing
+    uint32_t start = session->event_tail & session->event_mask;
+    uint32_t first = words < session->event_words - start ? words : session->event_words - start;
+    memcpy(state->scratch, session->events + start, first * sizeof(uint32_t));
+    memcpy(state->scratch + first, session->events, (words - first) * sizeof(uint32_t));
+    session->event_tail = event_end;
+    __atomic_store_n(&shared->event_tail, event_end, __ATOMIC_RELEASE);
+
+    if (!make_resident(state, session)) {
+        protocol_error(state, session, "Engine state could not be restored");
+        return true;
+    }
+    if (words > 0) {
+        midi_processing_ingest_ump(state->scratch, words);
+    }
+    bool silent = false;
+    voice_manager_render_block(slot->samples, session->block_frames, &silent);
+    __atomic_store_n(&slot->silent, silent, __ATOMIC_RELAXED);
+
+    session->served++;
+    session->frames += session->block_frames;
+    __atomic_store_n(&shared->rendered, session->served, __ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&shared->waiting, __ATOMIC_SEQ_CST)) {
+        futex_wake(&shared->rendered);
+    }
+
+    __atomic_add_fetch(&state->blocks_rendered, 1, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&state->frames_rendered, session->block_frames, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&state->event_words, words, __ATOMIC_RELAXED);
+    return true;
+}
+
+// One block per session per pass keeps clients from starving each other
+static void* render_thread_main(void* arg) {
+    audio_server_state_t* state = arg;
+    audio_server_doorbell_t* doorbell = state->doorbell;
+
+    while (__atomic_load_n(&state->running, __ATOMIC_ACQUIRE)) {
+        uint32_t bell = __atomic_load_n(&doorbell->doorbell, __ATOMIC_SEQ_CST);
+        bool worked = false;
+        for (uint32_t i = 0; i < state->max_clients; i++) {
+            server_session_t* session = &state->sessions[i];
+            int session_state = __atomic_load_n(&session->state, __ATOMIC_ACQUIRE);
+            if (session_state == SESSION_HANGUP) {
+                retire_session(state, session);
+            } else if (session_state == SESSION_LIVE) {
+                worked |= serve_block(state, session);
+            }
+        }
+        if (worked) {
+            continue;
+        }
+
+        __atomic_store_n(&doorbell->sleeping, 1, __ATOMIC_SEQ_CST);
+        if (__atomic_load_n(&doorbell->doorbell, __ATOMIC_SEQ_CST) == bell &&
+            __atomic_load_n(&state->running, __ATOMIC_ACQUIRE)) {
+            futex_wait(&doorbell->doorbell, bell, SERVER_IDLE_WAIT_MS);
+        }
+        __atomic_store_n(&doorbell->sleeping, 0, __ATOMIC_SEQ_CST);
+    }
+    return NULL;
+}
+
+// ---------------------------------------------------------------------------
+// Server control
+// ---------------------------------------------------------------------------
+
+int audio_server_init(void) {
+    if (g_server_state.initialized) {
+        return RETROSAGA_ERROR_ALREADY_INITIALIZED;
+    }
+
+    printf("[AUDIO_SERVER] Initializing audio_server module...\n");
+
+    g_server_state.operations_count = 0;
+    g_server_state.serving = false;
+    g_server_state.listener = -1;
+    g_server_state.doorbell_fd = -1;
+    for (uint32_t i = 0; i < AUDIO_SERVER_MAX_CLIENTS; i++) {
+        g_server_state.sessions[i].connection = -1;
+    }
+    g_server_state.initialized = true;
+
+    printf("[AUDIO_SERVER] Audio_server module initialized successfully\n");
+    return RETROSAGA_SUCCESS;
+}
+
+int audio_server_process(void) {
+    if (!g_server_state.initialized) {
+        return RETROSAGA_ERROR_NOT_INITIALIZED;
+    }
+
+    g_server_state.operations_count++;
+    return RETROSAGA_SUCCESS;
+}
+
+void audio_server_default_config(audio_server_config_t* config) {
+    memset(config, 0, sizeof(*config));
+    config->path = NULL;
+    config->max_clients = AUDIO_SERVER_MAX_CLIENTS;
+}
+
+// Bind the socket, taking over the path only from a server that is gone
+static int open_listener(const char* path) {
+    struct sockaddr_un address;
+    if (!socket_address(path, &address)) {
+        return -1;
+    }
+    int fd = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        return -1;
+    }
+    if (bind(fd, (struct sockaddr*)&address, sizeof(address)) != 0 && errno == EADDRINUSE) {
+        int probe = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+        bool stale = probe >= 0 && connect(probe, (struct sockaddr*)&address, sizeof(address)) != 0 &&
+                     errno == ECONNREFUSED;
+        if (probe >= 0) {
+            close(probe);
+        }
+        if (stale) {
+            unlink(path);
+            if (bind(fd, (struct sockaddr*)&address, sizeof(address)) == 0 && listen(fd, 8) == 0) {
+                return fd;
+            }
+        }
+        close(fd);
+        return -1;
+    }
+    if (listen(fd, 8) != 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+int audio_server_start(const audio_server_config_t* config) {
+    audio_server_state_t* state = &g_server_state;
+
+    if (!state->initialized) {
+        return RETROSAGA_ERROR_NOT_INITIALIZED;
+    }
+    if (!config || !config->path || strlen(config->path) >= sizeof(state->path) || config->max_clients == 0 ||
+        config->max_clients > AUDIO_SERVER_MAX_CLIENTS) {
+        return RETROSAGA_ERROR_INVALID_PARAM;
+    }
+    if (state->serving) {
+        audio_server_stop();
+    }
+
+    strcpy(state->path, config->path);
+    state->max_clients = config->max_clients;
+    state->resident = NULL;
+    state->sessions_opened = 0;
+    state->connections_refused = 0;
+    state->blocks_rendered = 0;
+    state->frames_rendered = 0;
+    state->event_words = 0;
+    state->session_switches = 0;
+    state->protocol_errors = 0;
+
+    state->baseline_size = audio_snapshot_size();
+    state->baseline = malloc(state->baseline_size);
+    if (!state->baseline ||
+        audio_snapshot_save(state->baseline, state->baseline_size, 0, &state->baseline_size) != RETROSAGA_SUCCESS) {
+        free(state->baseline);
+        state->baseline = NULL;
+        return RETROSAGA_ERROR_AUDIO_INIT;
+    }
+
+    void* doorbell = NULL;
+    state->doorbell_fd = create_region("retrosaga-doorbell", (size_t)sysconf(_SC_PAGESIZE), &doorbell);
+    state->doorbell = doorbell;
+    state->listener = state->doorbell_fd >= 0 ? open_listener(state->path) : -1;
+    if (state->listener < 0) {
+        printf("[AUDIO_SERVER] ERROR: Cannot listen on %s: %s\n", state->path, strerror(errno));
+        if (state->doorbell_fd >= 0) {
+            munmap(state->doorbell, (size_t)sysconf(_SC_PAGESIZE));
+            close(state->doorbell_fd);
+        }
+        state->doorbell_fd = -1;
+        free(state->baseline);
+        state->baseline = NULL;
+        return RETROSAGA_ERROR_FILE_IO;
+    }
+
+    state->running = true;
+    if (pthread_create(&state->render_thread, NULL, render_thread_main, state) != 0) {
+        state->running = false;
+    } else if (pthread_create(&state->control_thread, NULL, control_thread_main, state) != 0) {
+        __atomic_store_n(&state->running, false, __ATOMIC_RELEASE);
+        ring_doorbell(state->doorbell);
+        pthread_join(state->render_thread, NULL);
+    }
+    if (!state->running) {
+        close(state->listener);
+        unlink(state->path);
+        munmap(state->doorbell, (size_t)sysconf(_SC_PAGESIZE));
+        close(state->doorbell_fd);
+        state->listener = -1;
+        state->doorbell_fd = -1;
+        free(state->baseline);
+        state->baseline = NULL;
+        return RETROSAGA_ERROR_AUDIO_INIT;
+    }
+
+    state->serving = true;
+    printf("[AUDIO_SERVER] Serving on %s: up to %u clients, %u Hz, %u ch, %zu byte session state\n", state->path,
+           state->max_clients, retrosaga_audio_get_config()->sample_rate, retrosaga_audio_get_config()->channels,
+           state->baseline_size);
+    return RETROSAGA_SUCCESS;
+}
+
+void audio_server_stop(void) {
+    audio_server_state_t* state = &g_server_state;
+
+    if (!state->serving) {
+        return;
+    }
+
+    __atomic_store_n(&state->running, false, __ATOMIC_RELEASE);
+    ring_doorbell(state->doorbell);
+    pthread_join(state->render_thread, NULL);
+    pthread_join(state->control_thread, NULL);
+
+    // Both threads are gone: close what is left and give the host its engine back
+    for (uint32_t i = 0; i < AUDIO_SERVER_MAX_CLIENTS; i++) {
+        server_session_t* session = &state->sessions[i];
+        if (session->state != SESSION_FREE) {
+            __atomic_store_n(&session->shared->closed, 1, __ATOMIC_SEQ_CST);
+            futex_wake(&session->shared->rendered);
+            free_session(session);
+        }
+    }
+    audio_snapshot_restore(state->baseline, state->baseline_size);
+    state->resident = NULL;
+
+    printf("[AUDIO_SERVER] Server stopped: %lu sessions, %lu blocks, %lu session switches, %lu protocol errors\n",
+           (unsigned long)state->sessions_opened, (unsigned long)state->blocks_rendered,
+           (unsigned long)state->session_switches, (unsigned long)state->protocol_errors);
+
+    close(state->listener);
+    unlink(state->path);
+    munmap(state->doorbell, (size_t)sysconf(_SC_PAGESIZE));
+    close(state->doorbell_fd);
+    state->listener = -1;
+    state->doorbell_fd = -1;
+    state->doorbell = NULL;
+    free(state->baseline);
+    state->baseline = NULL;
+    state->serving = false;
+}
+
+bool audio_server_active(void) {
+    return g_server_state.serving;
+}
+
+void audio_server_get_stats(audio_server_stats_t* stats) {
+    audio_server_state_t* state = &g_server_state;
+
+    memset(stats, 0, sizeof(*stats));
+    for (uint32_t i = 0; i < AUDIO_SERVER_MAX_CLIENTS; i++) {
+        stats->clients += __atomic_load_n(&state->sessions[i].state, __ATOMIC_ACQUIRE) == SESSION_LIVE;
+    }
+    stats->sessions_opened = __atomic_load_n(&state->sessions_opened, __ATOMIC_RELAXED);
+    stats->connections_refused = __atomic_load_n(&state->connections_refused, __ATOMIC_RELAXED);
+    stats->blocks_rendered = __atomic_load_n(&state->blocks_rendered, __ATOMIC_RELAXED);
+    stats->frames_rendered = __atomic_load_n(&state->frames_rendered, __ATOMIC_RELAXED);
+    stats->event_words = __atomic_load_n(&state->event_words, __ATOMIC_RELAXED);
+    stats->session_switches = __atomic_load_n(&state->session_switches, __ATOMIC_RELAXED);
+    stats->protocol_errors = __atomic_load_n(&state->protocol_errors, __ATOMIC_RELAXED);
+}
+
+void audio_server_shutdown(void) {
+    if (!g_server_state.initialized) {
+        return;
+    }
+
+    printf("[AUDIO_SERVER] Shutting down audio_server module...\n");
+    audio_server_stop();
+    printf("[AUDIO_SERVER] Operations performed: %d\n", g_server_state.operations_count);
+    memset(&g_server_state, 0, sizeof(g_server_state));
+    printf("[AUDIO_SERVER] Audio_server module shutdown complete\n");
+}
+
+// ---------------------------------------------------------------------------
+// Client
+// ---------------------------------------------------------------------------
+
+void audio_server_client_default_config(audio_server_client_config_t* config) {
+    memset(config, 0, sizeof(*config));
+    config->path = NULL;
+    config->block_frames = 256;
+    config->slot_count = 4;
+    config->event_words = 1024;
+}
+
+static void* map_received(int fd) {
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size <= 0) {
+        return NULL;
+    }
+    void* mapping = mmap(NULL, (size_t)info.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    return mapping == MAP_FAILED ? NULL : mapping;
+}
+
+int audio_server_connect(audio_server_client_t* client, const audio_server_client_config_t* config) {
+    struct sockaddr_un address;
+    memset(client, 0, sizeof(*client));
+    client->socket = -1;
+    if (!config || !socket_address(config->path, &address)) {
+        return RETROSAGA_ERROR_INVALID_PARAM;
+    }
+
+    int fd = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+    if (fd < 0 || connect(fd, (struct sockaddr*)&address, sizeof(address)) != 0) {
+        if (fd >= 0) {
+            close(fd);
+        }
+        return RETROSAGA_ERROR_FILE_IO;
+    }
+    set_receive_timeout(fd, SERVER_HANDSHAKE_MS);
+
+    connect_request_t request = {AUDIO_SERVER_MAGIC, AUDIO_SERVER_VERSION, config->block_frames, config->slot_count,
+                                 config->event_words};
+    connect_reply_t reply = {0};
+    struct iovec iov = {&reply, sizeof(reply)};
+    union {
+        struct cmsghdr header;
+        char space[CMSG_SPACE(2 * sizeof(int))];
+    } control;
+    struct msghdr message = {0};
+    message.msg_iov = &iov;
+    message.msg_iovlen = 1;
+    message.msg_control = control.space;
+    message.msg_controllen = sizeof(control.space);
+
+    int fds[2] = {-1, -1};
+    if (send(fd, &request, sizeof(request), MSG_NOSIGNAL) != (ssize_t)sizeof(request) ||
+        recvmsg(fd, &message, MSG_CMSG_CLOEXEC) != (ssize_t)sizeof(reply) || reply.magic != AUDIO_SERVER_MAGIC) {
+        close(fd);
+        return RETROSAGA_ERROR_FILE_IO;
+    }
+    struct cmsghdr* header = CMSG_FIRSTHDR(&message);
+    if (header && header->cmsg_level == SOL_SOCKET && header->cmsg_type == SCM_RIGHTS &&
+        header->cmsg_len == CMSG_LEN(sizeof(fds))) {
+        memcpy(fds, CMSG_DATA(header), sizeof(fds));
+    }
+    if (reply.status != RETROSAGA_SUCCESS || fds[0] < 0) {
+        close(fd);
+        return reply.status != RETROSAGA_SUCCESS ? reply.status : RETROSAGA_ERROR_FILE_IO;
+    }
+
+    audio_server_shared_t* shared = map_received(fds[0]);
+    audio_server_doorbell_t* doorbell = map_received(fds[1]);
+    close(fds[0]);
+    close(fds[1]);
+    client->socket = fd;
+    client->shared = shared;
+    client->doorbell = doorbell;
+    if (!shared || !doorbell || shared->magic != AUDIO_SERVER_MAGIC || shared->version != AUDIO_SERVER_VERSION) {
+        audio_server_disconnect(client);
+        return RETROSAGA_ERROR_CONFIG;
+    }
+
+    client->sample_rate = shared->sample_rate;
+    client->block_frames = shared->block_frames;
+    client->slot_count = shared->slot_count;
+    client->channels = (uint8_t)shared->channels;
+    client->event_words = shared->event_words;
+    client->slot_bytes = shared->slot_bytes;
+    client->region_bytes = shared->region_bytes;
+    client->events = (uint32_t*)((uint8_t*)shared + shared->events_offset);
+    client->slots = (uint8_t*)shared + shared->slots_offset;
+    return RETROSAGA_SUCCESS;
+}
+
+void audio_server_disconnect(audio_server_client_t* client) {
+    if (client->shared) {
+        munmap(client->shared, client->region_bytes ? client->region_bytes : client->shared->region_bytes);
+    }
+    if (client->doorbell) {
+        munmap(client->doorbell, (size_t)sysconf(_SC_PAGESIZE));
+    }
+    if (client->socket >= 0) {
+        close(client->socket);
+    }
+    memset(client, 0, sizeof(*client));
+    client->socket = -1;
+}
+
+size_t audio_server_send_ump(audio_server_client_t* client, const uint32_t* words, size_t word_count) {
+    if (!client->shared || !words) {
+        return 0;
+    }
+    const uint32_t capacity = client->event_words;
+    uint32_t tail = __atomic_load_n(&client->shared->event_tail, __ATOMIC_ACQUIRE);
+    uint32_t space = capacity - (client->event_head - tail);
+
+    size_t queued = 0;
+    while (queued < word_count) {
+        uint32_t packet = midi_ump_packet_words(words[queued]);
+        if (packet > space || packet > word_count - queued) {
+            break;
+        }
+        for (uint32_t w = 0; w < packet; w++) {
+            client->events[(client->event_head + w) & (capacity - 1)] = words[queued + w];
+        }
+        client->event_head += packet;
+        space -= packet;
+        queued += packet;
+    }
+    return queued;
+}
+
+int audio_server_send_midi(audio_server_client_t* client, uint8_t status, uint8_t data1, uint8_t data2) {
+    // MIDI 1.0 channel voice message on group 0
+    uint32_t word = (0x2u << 28) | ((uint32_t)status << 16) | ((uint32_t)(data1 & 0x7F) << 8) | (data2 & 0x7F);
+    return audio_server_send_ump(client, &word, 1) == 1 ? RETROSAGA_SUCCESS : RETROSAGA_ERROR_INVALID_PARAM;
+}
+
+bool audio_server_request(audio_server_client_t* client) {
+    if (!client->shared || client->requested - client->consumed >= client->slot_count) {
+        return false;
+    }
+    audio_server_slot_t* slot = (audio_server_slot_t*)(client->slots +
+                                                       (size_t)(client->requested & (client->slot_count - 1)) *
+                                                       client->slot_bytes);
+    __atomic_store_n(&slot->event_end, client->event_head, __ATOMIC_RELAXED);
+    client->requested++;
+    __atomic_store_n(&client->shared->requested, client->requested, __ATOMIC_SEQ_CST);
+    ring_doorbell(client->doorbell);
+    return true;
+}
+
+const float* audio_server_read_acquire(audio_server_client_t* client, int timeout_ms, bool* silent) {
+    audio_server_shared_t* shared = client->shared;
+    if (!shared || client->consumed == client->requested) {
+        return NULL;
+    }
+
+    int64_t deadline = monotonic_ms() + (timeout_ms > 0 ? timeout_ms : 0);
+    for (;;) {
+        uint32_t rendered = __atomic_load_n(&shared->rendered, __ATOMIC_ACQUIRE);
+        if ((int32_t)(rendered - client->consumed) > 0) {
+            break;
+        }
+        int64_t remaining = deadline - monotonic_ms();
+        if (__atomic_load_n(&shared->closed, __ATOMIC_ACQUIRE) || remaining <= 0) {
+            return NULL;
+        }
+        __atomic_store_n(&shared->waiting, 1, __ATOMIC_SEQ_CST);
+        if (__atomic_load_n(&shared->rendered, __ATOMIC_SEQ_CST) == rendered &&
+            !__atomic_load_n(&shared->closed, __ATOMIC_SEQ_CST)) {
+            futex_wait(&shared->rendered, rendered, (int)remaining);
+        }
+        __atomic_store_n(&shared->waiting, 0, __ATOMIC_SEQ_CST);
+    }
+
+    audio_server_slot_t* slot = (audio_server_slot_t*)(client->slots +
+                                                       (size_t)(client->consumed & (client->slot_count - 1)) *
+                                                       client->slot_bytes);
+    if (silent) {
+        *silent = __atomic_load_n(&slot->silent, __ATOMIC_RELAXED) != 0;
+    }
+    return slot->samples;
+}
+
+void audio_server_read_release(audio_server_client_t* client) {
+    if (client->consumed != client->requested) {
+        client->consumed++;
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Validation
+// ---------------------------------------------------------------------------
+
+#define SERVER_TEST_BLOCK  256
+#define SERVER_TEST_BLOCKS 48
+
+typedef struct {
+    uint32_t block;
+    uint8_t status;
+    uint8_t data1;
+    uint8_t data2;
+} server_test_event_t;
+
+// Two scenes on the same channels, so a leak between sessions shows
+static const server_test_event_t k_scene_a[] = {
+    {0, 0x90, 60, 100}, {0, 0x90, 64, 90}, {5, 0xE0, 0x00, 0x50}, {9, 0x80, 60, 0},
+    {12, 0xB0, 7, 70},  {20, 0x90, 67, 120}, {30, 0x80, 64, 0}, {36, 0x80, 67, 0},
+};
+static const server_test_event_t k_scene_b[] = {
+    {0, 0x90, 48, 127}, {2, 0xC0, 3, 0},  {3, 0x90, 55, 80}, {7, 0xB0, 74, 20},
+    {15, 0x80, 48, 0},  {16, 0x90, 72, 64}, {40, 0x80, 55, 0},
+};
+
+static uint32_t scene_word(const server_test_event_t* event) {
+    return (0x2u << 28) | ((uint32_t)event->status << 16) | ((uint32_t)event->data1 << 8) | event->data2;
+}
+
+// Reference render straight through the engine from the current state
+static void render_scene(const server_test_event_t* scene, size_t events, float* output, uint8_t channels) {
+    size_t next = 0;
+    for (uint32_t b = 0; b < SERVER_TEST_BLOCKS; b++) {
+        for (; next < events && scene[next].block == b; next++) {
+            uint32_t word = scene_word(&scene[next]);
+            midi_processing_ingest_ump(&word, 1);
+        }
+        voice_manager_render(output + (size_t)b * SERVER_TEST_BLOCK * channels, SERVER_TEST_BLOCK);
+    }
+}
+
+// The same scene through a session; requests run up to the slot count
+// ahead of the reads, as a client hiding latency would
+static bool play_scene(audio_server_client_t* client, const server_test_event_t* scene, size_t events,
+                       const float* expected) {
+    size_t next = 0;
+    uint32_t issued = 0;
+    size_t block_bytes = (size_t)SERVER_TEST_BLOCK * client->channels * sizeof(float);
+    for (uint32_t b = 0; b < SERVER_TEST_BLOCKS; b++) {
+        for (; issued < SERVER_TEST_BLOCKS && issued < b + client->slot_count; issued++) {
+            for (; next < events && scene[next].block == issued; next++) {
+                audio_server_send_midi(client, scene[next].status, scene[next].data1, scene[next].data2);
+            }
+            if (!audio_server_request(client)) {
+                return false;
+            }
+        }
+        const float* samples = audio_server_read_acquire(client, 2000, NULL);
+        if (!samples || memcmp(samples, expected + (size_t)b * block_bytes / sizeof(float), block_bytes) != 0) {
+            return false;
+        }
+        audio_server_read_release(client);
+    }
+    return true;
+}
+
+// Sessions are freed by the control thread shortly after the hangup
+static bool wait_for_sessions_freed(void) {
+    for (int i = 0; i < 200; i++) {
+        bool freed = true;
+        for (uint32_t s = 0; s < AUDIO_SERVER_MAX_CLIENTS; s++) {
+            freed &= __atomic_load_n(&g_server_state.sessions[s].state, __ATOMIC_ACQUIRE) == SESSION_FREE;
+        }
+        if (freed) {
+            return true;
+        }
+        struct timespec wait = {0, 5000000};
+        nanosleep(&wait, NULL);
+    }
+    return false;
+}
+
+bool audio_server_validate(void) {
+    const uint8_t channels = retrosaga_audio_get_config()->channels;
+    const size_t scene_samples = (size_t)SERVER_TEST_BLOCKS * SERVER_TEST_BLOCK * channels;
+    float* expected_a = malloc(scene_samples * sizeof(float));
+    float* expected_b = malloc(scene_samples * sizeof(float));
+    size_t host_size = audio_snapshot_size();
+    uint8_t* host = malloc(host_size);
+    bool valid = expected_a && expected_b && host &&
+                 audio_snapshot_save(host, host_size, 0, &host_size) == RETROSAGA_SUCCESS;
+
+    // References, each from the state the server will hand new sessions
+    if (valid) {
+        voice_manager_reset();
+        size_t start_size = audio_snapshot_size();
+        uint8_t* start = malloc(start_size);
+        valid = start && audio_snapshot_save(start, start_size, 0, &start_size) == RETROSAGA_SUCCESS;
+        if (valid) {
+            render_scene(k_scene_a, sizeof(k_scene_a) / sizeof(k_scene_a[0]), expected_a, channels);
+            audio_snapshot_restore(start, start_size);
+            render_scene(k_scene_b, sizeof(k_scene_b) / sizeof(k_scene_b[0]), expected_b, channels);
+            audio_snapshot_restore(start, start_size);
+        }
+        free(start);
+    }
+
+    char path[SERVER_MAX_PATH];
+    snprintf(path, sizeof(path), "/tmp/retrosaga_server_%ld.sock", (long)getpid());
+    audio_server_config_t config;
+    audio_server_default_config(&config);
+    config.path = path;
+    config.max_clients = 3;
+    valid = valid && audio_server_start(&config) == RETROSAGA_SUCCESS;
+
+    audio_server_client_config_t client_config;
+    audio_server_client_default_config(&client_config);
+    client_config.path = path;
+    client_config.block_frames = SERVER_TEST_BLOCK;
+
+    // A lone client keeps the engine resident: round trip per block
+    double round_trip_us = 0.0;
+    if (valid) {
+        audio_server_client_t client;
+        valid = audio_server_connect(&client, &client_config) == RETROSAGA_SUCCESS &&
+                play_scene(&client, k_scene_a, sizeof(k_scene_a) / sizeof(k_scene_a[0]), expected_a);
+        struct timespec start, end;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        for (int i = 0; valid && i < 200; i++) {
+            valid = audio_server_request(&client) && audio_server_read_acquire(&client, 2000, NULL) != NULL;
+            audio_server_read_release(&client);
+        }
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        round_trip_us = ((double)(end.tv_sec - start.tv_sec) * 1e6 + (double)(end.tv_nsec - start.tv_nsec) / 1e3) /
+                        200.0;
+        audio_server_disconnect(&client);
+        valid = valid && wait_for_sessions_freed();
+        if (!valid) {
+            printf("[AUDIO_SERVER] VALIDATION FAILED: Lone session does not match the engine\n");
+        }
+    }
+
+    // A second process and this one at once: each hears only its own scene
+    if (valid) {
+        pid_t child = fork();
+        if (child == 0) {
+            audio_server_client_t remote;
+            bool ok = audio_server_connect(&remote, &client_config) == RETROSAGA_SUCCESS &&
+                      play_scene(&remote, k_scene_b, sizeof(k_scene_b) / sizeof(k_scene_b[0]), expected_b);
+            audio_server_disconnect(&remote);
+            _exit(ok ? 0 : 1);
+        }
+        audio_server_client_t local;
+        valid = child > 0 && audio_server_connect(&local, &client_config) == RETROSAGA_SUCCESS &&
+                play_scene(&local, k_scene_a, sizeof(k_scene_a) / sizeof(k_scene_a[0]), expected_a);
+        audio_server_disconnect(&local);
+        int status = 1;
+        if (child > 0) {
+            waitpid(child, &status, 0);
+        }
+        valid = valid && WIFEXITED(status) && WEXITSTATUS(status) == 0 && wait_for_sessions_freed();
+        if (!valid) {
+            printf("[AUDIO_SERVER] VALIDATION FAILED: Concurrent sessions differ from the engine\n");
+        }
+    }
+
+    // Geometry rewritten by a client changes nothing on the server side:
+    // the session still renders its scene and the server keeps serving
+    if (valid) {
+        audio_server_client_t client;
+        valid = audio_server_connect(&client, &client_config) == RETROSAGA_SUCCESS;
+        if (valid) {
+            client.shared->event_words = 1u << 30;
+            client.shared->block_frames = 1u << 24;
+            client.shared->slot_bytes = 1u << 30;
+            client.shared->slot_count = 1u << 16;
+            valid = play_scene(&client, k_scene_a, sizeof(k_scene_a) / sizeof(k_scene_a[0]), expected_a) &&
+                    !__atomic_load_n(&client.shared->closed, __ATOMIC_ACQUIRE) && audio_server_active();
+        }
+        audio_server_disconnect(&client);
+        valid = valid && wait_for_sessions_freed();
+        if (!valid) {
+            printf("[AUDIO_SERVER] VALIDATION FAILED: Session geometry taken from the shared page\n");
+        }
+    }
+
+    // A corrupt ring closes that session only; a full server refuses
+    if (valid) {
+        audio_server_client_t clients[4];
+        bool connected[4];
+        for (int i = 0; i < 4; i++) {
+            connected[i] = audio_server_connect(&clients[i], &client_config) == RETROSAGA_SUCCESS;
+        }
+        valid = connected[0] && connected[1] && connected[2] && !connected[3];
+        if (valid) {
+            clients[0].event_head += 1u << 20;
+            audio_server_request(&clients[0]);
+            valid = audio_server_read_acquire(&clients[0], 2000, NULL) == NULL &&
+                    __atomic_load_n(&clients[0].shared->closed, __ATOMIC_ACQUIRE) &&
+                    play_scene(&clients[1], k_scene_b, sizeof(k_scene_b) / sizeof(k_scene_b[0]), expected_b);
+        }
+        for (int i = 0; i < 4; i++) {
+            audio_server_disconnect(&clients[i]);
+        }
+        valid = valid && wait_for_sessions_freed();
+        if (!valid) {
+            printf("[AUDIO_SERVER] VALIDATION FAILED: Corrupt or surplus client not contained\n");
+        }
+    }
+
+    audio_server_stats_t stats;
+    audio_server_get_stats(&stats);
+    audio_server_stop();
+    valid = valid && stats.protocol_errors == 1 && stats.connections_refused == 1 && stats.session_switches > 0;
+
+    if (host && audio_snapshot_restore(host, host_size) != RETROSAGA_SUCCESS) {
+        valid = false;
+    }
+    free(expected_a);
+    free(expected_b);
+    free(host);
+    if (valid) {
+        printf("[AUDIO_SERVER] Audio server validation passed (%.1f us per %d-frame block round trip, "
+               "%lu session switches)\n", round_trip_us, SERVER_TEST_BLOCK, (unsigned long)stats.session_switches);
+    }
+    return valid;
+}
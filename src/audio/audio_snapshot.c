@@ -0,0 +1,352 @@
+/*
+ * Audio Snapshot
+ * Save and restore of the engine's render state
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include "audio/audio_snapshot.h"
+#include "audio/audio_params.h"
+#include "audio/midi_processing.h"
+#include "audio/effect_engine.h"
+#include "audio/voice_manager.h"
+#include "audio/audio_convolver.h"
+
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t sample_rate;
+    uint32_t sub_block_frames;
+    uint32_t max_polyphony;
+    uint32_t channels;
+    uint64_t position;
+    uint64_t payload_bytes;
+} snapshot_header_t;
+
+// ---------------------------------------------------------------------------
+// Stream
+// ---------------------------------------------------------------------------
+
+void audio_snapshot_put(audio_snapshot_stream_t* stream, const void* bytes, size_t count) {
+    if (!stream->failed && count <= stream->capacity - stream->position) {
+        memcpy(stream->data + stream->position, bytes, count);
+    } else {
+        stream->failed = true;
+    }
+    stream->position += count;
+}
+
+const void* audio_snapshot_view(audio_snapshot_stream_t* stream, size_t count) {
+    if (stream->failed || count > stream->capacity - stream->position) {
+        stream->failed = true;
+        return NULL;
+    }
+    const void* bytes = stream->data + stream->position;
+    stream->position += count;
+    return bytes;
+}
+
+bool audio_snapshot_get(audio_snapshot_stream_t* stream, void* bytes, size_t count) {
+    const void* source = audio_snapshot_view(stream, count);
+    if (source) {
+        memcpy(bytes, source, count);
+    }
+    return source != NULL;
+}
+
+void audio_snapshot_begin_section(audio_snapshot_stream_t* stream, uint32_t tag, uint32_t record_bytes) {
+    audio_snapshot_put(stream, &tag, sizeof(tag));
+    audio_snapshot_put(stream, &record_bytes, sizeof(record_bytes));
+}
+
+bool audio_snapshot_expect_section(audio_snapshot_stream_t* stream, uint32_t tag, uint32_t record_bytes) {
+    uint32_t marker[2];
+    if (!audio_snapshot_get(stream, marker, sizeof(marker))) {
+        return false;
+    }
+    if (marker[0] != tag || marker[1] != record_bytes) {
+        return audio_snapshot_refuse(stream, "Section written by another build");
+    }
+    return true;
+}
+
+bool audio_snapshot_refuse(audio_snapshot_stream_t* stream, const char* reason) {
+    if (!stream->failed) {
+        printf("[AUDIO_SNAPSHOT] Snapshot refused: %s\n", reason);
+    }
+    stream->failed = true;
+    return false;
+}
+
+// ---------------------------------------------------------------------------
+// Engine snapshots
+// ---------------------------------------------------------------------------
+
+static void write_sections(audio_snapshot_stream_t* stream) {
+    audio_params_snapshot_save(stream);
+    midi_processing_snapshot_save(stream);
+    effect_engine_snapshot_save(stream);
+    voice_manager_snapshot_save(stream);
+}
+
+static bool read_sections(audio_snapshot_stream_t* stream) {
+    return audio_params_snapshot_restore(stream) && midi_processing_snapshot_restore(stream) &&
+           effect_engine_snapshot_restore(stream) && voice_manager_snapshot_restore(stream) &&
+           stream->position == stream->capacity;
+}
+
+size_t audio_snapshot_size(void) {
+    audio_snapshot_stream_t stream = {0};
+    write_sections(&stream);
+    return sizeof(snapshot_header_t) + stream.position;
+}
+
+int audio_snapshot_save(void* buffer, size_t capacity, uint64_t position, size_t* size) {
+    if (!buffer && capacity > 0) {
+        return RETROSAGA_ERROR_INVALID_PARAM;
+    }
+    const retrosaga_audio_config_t* config = retrosaga_audio_get_config();
+
+    audio_snapshot_stream_t stream = {0};
+    if (capacity > sizeof(snapshot_header_t)) {
+        stream.data = (uint8_t*)buffer + sizeof(snapshot_header_t);
+        stream.capacity = capacity - sizeof(snapshot_header_t);
+    }
+    write_sections(&stream);
+    if (size) {
+        *size = sizeof(snapshot_header_t) + stream.position;
+    }
+    if (stream.failed || capacity < sizeof(snapshot_header_t)) {
+        return RETROSAGA_ERROR_INVALID_PARAM;
+    }
+
+    snapshot_header_t header = {
+        .magic = AUDIO_SNAPSHOT_MAGIC,
+        .version = AUDIO_SNAPSHOT_VERSION,
+        .sample_rate = config->sample_rate,
+        .sub_block_frames = config->sub_block_frames,
+        .max_polyphony = config->max_polyphony,
+        .channels = config->channels,
+        .position = position,
+        .payload_bytes = stream.position,
+    };
+    memcpy(buffer, &header, sizeof(header));
+    return RETROSAGA_SUCCESS;
+}
+
+static bool read_header(const void* buffer, size_t size, snapshot_header_t* header) {
+    if (!buffer || size < sizeof(*header)) {
+        return false;
+    }
+    memcpy(header, buffer, sizeof(*header));
+    return header->magic == AUDIO_SNAPSHOT_MAGIC && header->version == AUDIO_SNAPSHOT_VERSION &&
+           header->payload_bytes <= size - sizeof(*header);
+}
+
+uint64_t audio_snapshot_position(const void* buffer, size_t size) {
+    snapshot_header_t header;
+    return read_header(buffer, size, &header) ? header.position : UINT64_MAX;
+}
+
+int audio_snapshot_restore(const void* buffer, size_t size) {
+    snapshot_header_t header;
+    if (!read_header(buffer, size, &header)) {
+        printf("[AUDIO_SNAPSHOT] Snapshot refused: Not a snapshot of this version\n");
+        return RETROSAGA_ERROR_INVALID_PARAM;
+    }
+    const retrosaga_audio_config_t* config = retrosaga_audio_get_config();
+    if (header.sample_rate != config->sample_rate || header.sub_block_frames != config->sub_block_frames ||
+        header.max_polyphony != config->max_polyphony || header.channels != config->channels) {
+        printf("[AUDIO_SNAPSHOT] Snapshot refused: Taken with another engine configuration\n");
+        return RETROSAGA_ERROR_CONFIG;
+    }
+
+    // The stream only reads, whatever its pointer type says
+    audio_snapshot_stream_t stream = {
+        .data = (uint8_t*)buffer + sizeof(header),
+        .capacity = (size_t)header.payload_bytes,
+    };
+    if (!read_sections(&stream)) {
+        if (!stream.failed) {
+            printf("[AUDIO_SNAPSHOT] Snapshot refused: Trailing bytes\n");
+        }
+        return RETROSAGA_ERROR_INVALID_PARAM;
+    }
+
+    stream.position = 0;
+    stream.apply = true;
+    read_sections(&stream);
+    return RETROSAGA_SUCCESS;
+}
+
+// ---------------------------------------------------------------------------
+// Validation
+// ---------------------------------------------------------------------------
+
+#define SNAPSHOT_TEST_BLOCK  100   // Not a sub-block multiple, so a partial sub-block is captured
+#define SNAPSHOT_TEST_BLOCKS 40
+
+static double elapsed_us(const struct timespec* start) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)(now.tv_sec - start->tv_sec) * 1e6 + (double)(now.tv_nsec - start->tv_nsec) / 1e3;
+}
+
+static void render_blocks(float* output, uint32_t blocks, uint8_t channels) {
+    for (uint32_t b = 0; b < blocks; b++) {
+        voice_manager_render(output + (size_t)b * SNAPSHOT_TEST_BLOCK * channels, SNAPSHOT_TEST_BLOCK);
+    }
+}
+
+// Convolver on its own: a response longer than one level, fed past a
+// chunk boundary so spectra and owed output are both in flight
+static bool validate_convolver(void) {
+    enum { BLOCK = 64, IR_FRAMES = 3000, BLOCKS = 48 };
+    float* ir = malloc(IR_FRAMES * sizeof(float));
+    float* input = malloc(BLOCKS * BLOCK * sizeof(float));
+    float* expected = malloc(BLOCKS * BLOCK * sizeof(float));
+    float* actual = malloc(BLOCKS * BLOCK * sizeof(float));
+    uint8_t* buffer = NULL;
+    audio_convolver_t conv;
+    bool valid = ir && input && expected && actual;
+    for (uint32_t i = 0; valid && i < IR_FRAMES; i++) {
+        ir[i] = expf(-(float)i / 600.0f) * (i % 3 ? 0.3f : -0.2f);
+    }
+    for (uint32_t i = 0; valid && i < BLOCKS * BLOCK; i++) {
+        input[i] = sinf(0.013f * (float)i) + 0.25f * sinf(0.21f * (float)i);
+    }
+    if (!valid || audio_convolver_init(&conv, ir, IR_FRAMES, 1, BLOCK, NULL) != RETROSAGA_SUCCESS) {
+        free(ir);
+        free(input);
+        free(expected);
+        free(actual);
+        return false;
+    }
+
+    const uint32_t split = 21;
+    audio_snapshot_stream_t stream = {0};
+    for (uint32_t b = 0; valid && b < split; b++) {
+        audio_convolver_process(&conv, input + b * BLOCK, expected + b * BLOCK);
+    }
+    if (valid) {
+        audio_convolver_snapshot_save(&conv, &stream);
+        buffer = malloc(stream.position);
+        stream = (audio_snapshot_stream_t){.data = buffer, .capacity = buffer ? stream.position : 0};
+        audio_convolver_snapshot_save(&conv, &stream);
+        valid = buffer && !stream.failed;
+    }
+    for (uint32_t b = split; valid && b < BLOCKS; b++) {
+        audio_convolver_process(&conv, input + b * BLOCK, expected + b * BLOCK);
+    }
+    if (valid) {
+        audio_convolver_reset(&conv);
+        stream = (audio_snapshot_stream_t){.data = buffer, .capacity = stream.position, .apply = true};
+        valid = audio_convolver_snapshot_restore(&conv, &stream);
+    }
+    for (uint32_t b = split; valid && b < BLOCKS; b++) {
+        audio_convolver_process(&conv, input + b * BLOCK, actual + b * BLOCK);
+    }
+    valid = valid && memcmp(expected + split * BLOCK, actual + split * BLOCK,
+                            (BLOCKS - split) * BLOCK * sizeof(float)) == 0;
+
+    audio_convolver_destroy(&conv);
+    free(buffer);
+    free(ir);
+    free(input);
+    free(expected);
+    free(actual);
+    return valid;
+}
+
+bool audio_snapshot_validate(void) {
+    const uint8_t channels = retrosaga_audio_get_config()->channels;
+    const size_t block_samples = (size_t)SNAPSHOT_TEST_BLOCK * channels;
+    float* expected = malloc(SNAPSHOT_TEST_BLOCKS * block_samples * sizeof(float));
+    float* actual = malloc(SNAPSHOT_TEST_BLOCKS * block_samples * sizeof(float));
+
+    // Whatever the engine held before the test is put back afterwards
+    size_t original_size = audio_snapshot_size();
+    uint8_t* original = malloc(original_size);
+    size_t scene_capacity = original_size * 4 + 65536;
+    uint8_t* scene = malloc(scene_capacity);
+    size_t scene_size = 0;
+    bool valid = expected && actual && original && scene &&
+                 audio_snapshot_save(original, original_size, 0, &original_size) == RETROSAGA_SUCCESS;
+
+    // Voices mid-envelope with bends, filters and queued events; the
+    // snapshot falls inside a sub-block
+    if (valid) {
+        voice_manager_reset();
+        voice_manager_set_filter(2, VOICE_FILTER_LADDER);
+        audio_params_control_change(2, 74, 40);
+        audio_params_control_change(2, 71, 90);
+        process_midi_message(0x90, 57, 110);
+        process_midi_message(0x91, 64, 90);
+        process_midi_message(0x92, 40, 127);
+        process_midi_message(0xE1, 0x20, 0x50);
+        render_blocks(expected, 7, channels);
+        process_midi_message(0x80, 57, 0);
+        process_midi_message(0xB0, 10, 20);
+        process_midi_message(0x90, 69, 100);
+
+        struct timespec start;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        valid = audio_snapshot_save(scene, scene_capacity, 7 * SNAPSHOT_TEST_BLOCK, &scene_size) == RETROSAGA_SUCCESS;
+        double save_us = elapsed_us(&start);
+        render_blocks(expected, SNAPSHOT_TEST_BLOCKS, channels);
+
+        // Something else entirely, then back
+        voice_manager_reset();
+        process_midi_message(0x93, 30, 127);
+        render_blocks(actual, 3, channels);
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        valid &= audio_snapshot_restore(scene, scene_size) == RETROSAGA_SUCCESS;
+        double restore_us = elapsed_us(&start);
+        render_blocks(actual, SNAPSHOT_TEST_BLOCKS, channels);
+
+        valid &= memcmp(expected, actual, SNAPSHOT_TEST_BLOCKS * block_samples * sizeof(float)) == 0 &&
+                 audio_snapshot_position(scene, scene_size) == 7 * SNAPSHOT_TEST_BLOCK;
+        if (!valid) {
+            printf("[AUDIO_SNAPSHOT] VALIDATION FAILED: Render after restore differs\n");
+        } else {
+            printf("[AUDIO_SNAPSHOT] %zu byte snapshot, saved in %.1f us, restored in %.1f us\n", scene_size,
+                   save_us, restore_us);
+        }
+    }
+
+    // Damaged or truncated snapshots are refused without touching the engine
+    if (valid) {
+        size_t before = audio_snapshot_size();
+        scene[sizeof(snapshot_header_t)] ^= 0xFF;
+        valid = audio_snapshot_restore(scene, scene_size) != RETROSAGA_SUCCESS;
+        scene[sizeof(snapshot_header_t)] ^= 0xFF;
+        valid &= audio_snapshot_restore(scene, scene_size - 1) != RETROSAGA_SUCCESS;
+        valid &= audio_snapshot_position(scene, 8) == UINT64_MAX;
+        valid &= audio_snapshot_size() == before;
+        if (!valid) {
+            printf("[AUDIO_SNAPSHOT] VALIDATION FAILED: Damaged snapshot accepted\n");
+        }
+    }
+
+    if (valid && !validate_convolver()) {
+        printf("[AUDIO_SNAPSHOT] VALIDATION FAILED: Convolver state does not round trip\n");
+        valid = false;
+    }
+
+    if (original && audio_snapshot_restore(original, original_size) != RETROSAGA_SUCCESS) {
+        valid = false;
+    }
+    free(expected);
+    free(actual);
+    free(original);
+    free(scene);
+    if (valid) {
+        printf("[AUDIO_SNAPSHOT] Audio snapshot validation passed\n");
+    }
+    return valid;
+}
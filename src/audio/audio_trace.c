@@ -0,0 +1,342 @@
+/*
+ * Audio Trace
+ * Hot-path stage timers and counters
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "audio/audio_trace.h"
+
+#ifdef CLOCK_MONOTONIC_RAW
+#define TRACE_CLOCK CLOCK_MONOTONIC_RAW
+#else
+#define TRACE_CLOCK CLOCK_MONOTONIC
+#endif
+
+#define TRACE_SPAN_MASK (AUDIO_TRACE_SPAN_CAPACITY - 1u)
+#define TRACE_PATH_MAX  512
+
+typedef struct {
+    uint64_t start_ns;
+    uint32_t duration_ns;
+    uint32_t stage;
+} trace_span_t;
+
+typedef struct {
+    char name[32];
+    audio_trace_stats_t stats[AUDIO_TRACE_STAGE_COUNT];
+    uint64_t counters[AUDIO_TRACE_COUNTER_COUNT];
+    trace_span_t* spans;          // Ring of the most recent spans
+    uint64_t spans_written;
+} trace_thread_t;
+
+typedef struct {
+    bool initialized;
+    uint64_t epoch_ns;
+    char export_path[TRACE_PATH_MAX];
+    trace_thread_t* threads[AUDIO_TRACE_MAX_THREADS];
+    uint32_t thread_count;
+} audio_trace_state_t;
+
+static audio_trace_state_t g_trace_state = {0};
+static __thread trace_thread_t* t_trace_thread = NULL;
+
+static const char* const k_stage_names[AUDIO_TRACE_STAGE_COUNT] = {
+    "update", "render", "sub_block", "midi_drain", "voice_osc", "voice_filter", "voice_mix", "effects", "output"
+};
+
+// Enclosing stage for folded stacks, -1 for roots
+static const int8_t k_stage_parent[AUDIO_TRACE_STAGE_COUNT] = {
+    -1, -1, AUDIO_TRACE_RENDER, AUDIO_TRACE_SUB_BLOCK, AUDIO_TRACE_SUB_BLOCK, AUDIO_TRACE_SUB_BLOCK,
+    AUDIO_TRACE_SUB_BLOCK, AUDIO_TRACE_SUB_BLOCK, AUDIO_TRACE_RENDER
+};
+
+static const char* const k_counter_names[AUDIO_TRACE_COUNTER_COUNT] = {
+    "voices_rendered", "events_applied", "frames_output"
+};
+
+bool audio_trace_compiled_in(void) {
+#ifdef RETROSAGA_TRACE
+    return true;
+#else
+    return false;
+#endif
+}
+
+uint64_t audio_trace_now(void) {
+    struct timespec ts;
+    clock_gettime(TRACE_CLOCK, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+int audio_trace_init(void) {
+    if (g_trace_state.initialized) {
+        return RETROSAGA_ERROR_ALREADY_INITIALIZED;
+    }
+
+    g_trace_state.epoch_ns = audio_trace_now();
+    g_trace_state.initialized = true;
+    if (!audio_trace_compiled_in()) {
+        return RETROSAGA_SUCCESS;
+    }
+
+    const char* path = getenv(AUDIO_TRACE_FILE_ENV);
+    if (path) {
+        snprintf(g_trace_state.export_path, sizeof(g_trace_state.export_path), "%s", path);
+    }
+
+    printf("[AUDIO_TRACE] Stage tracing enabled%s%s\n", path ? ", exporting to " : "", path ? path : "");
+    return audio_trace_thread_register("audio");
+}
+
+int audio_trace_thread_register(const char* name) {
+    if (!g_trace_state.initialized || !audio_trace_compiled_in()) {
+        return RETROSAGA_ERROR_NOT_INITIALIZED;
+    }
+    if (t_trace_thread) {
+        return RETROSAGA_SUCCESS;
+    }
+
+    uint32_t slot = __atomic_fetch_add(&g_trace_state.thread_count, 1, __ATOMIC_ACQ_REL);
+    if (slot >= AUDIO_TRACE_MAX_THREADS) {
+        __atomic_fetch_sub(&g_trace_state.thread_count, 1, __ATOMIC_ACQ_REL);
+        return RETROSAGA_ERROR_INVALID_PARAM;
+    }
+
+    trace_thread_t* thread = calloc(1, sizeof(trace_thread_t));
+    trace_span_t* spans = thread ? calloc(AUDIO_TRACE_SPAN_CAPACITY, sizeof(trace_span_t)) : NULL;
+    if (!thread || !spans) {
+        free(thread);
+        free(spans);
+        return RETROSAGA_ERROR_AUDIO_INIT;
+    }
+    snprintf(thread->name, sizeof(thread->name), "%s", name ? name : "worker");
+    thread->spans = spans;
+    for (int s = 0; s < AUDIO_TRACE_STAGE_COUNT; s++) {
+        thread->stats[s].min_ns = UINT64_MAX;
+    }
+
+    __atomic_store_n(&g_trace_state.threads[slot], thread, __ATOMIC_RELEASE);
+    t_trace_thread = thread;
+    return RETROSAGA_SUCCESS;
+}
+
+void audio_trace_record(audio_trace_stage_t stage, uint64_t start_ns, uint64_t end_ns) {
+    trace_thread_t* thread = t_trace_thread;
+    if (!thread || stage >= AUDIO_TRACE_STAGE_COUNT) {
+        return;
+    }
+
+    uint64_t duration = end_ns - start_ns;
+    audio_trace_stats_t* stats = &thread->stats[stage];
+    stats->count++;
+    stats->total_ns += duration;
+    if (duration < stats->min_ns) {
+        stats->min_ns = duration;
+    }
+    if (duration > stats->max_ns) {
+        stats->max_ns = duration;
+    }
+
+    trace_span_t* span = &thread->spans[thread->spans_written++ & TRACE_SPAN_MASK];
+    span->start_ns = start_ns;
+    span->duration_ns = duration > UINT32_MAX ? UINT32_MAX : (uint32_t)duration;
+    span->stage = stage;
+}
+
+void audio_trace_count(audio_trace_counter_t counter, uint64_t amount) {
+    trace_thread_t* thread = t_trace_thread;
+    if (thread && counter < AUDIO_TRACE_COUNTER_COUNT) {
+        thread->counters[counter] += amount;
+    }
+}
+
+static uint32_t registered_threads(void) {
+    uint32_t count = __atomic_load_n(&g_trace_state.thread_count, __ATOMIC_ACQUIRE);
+    return count < AUDIO_TRACE_MAX_THREADS ? count : AUDIO_TRACE_MAX_THREADS;
+}
+
+void audio_trace_reset(void) {
+    for (uint32_t t = 0; t < registered_threads(); t++) {
+        trace_thread_t* thread = g_trace_state.threads[t];
+        if (!thread) {
+            continue;
+        }
+        memset(thread->stats, 0, sizeof(thread->stats));
+        memset(thread->counters, 0, sizeof(thread->counters));
+        for (int s = 0; s < AUDIO_TRACE_STAGE_COUNT; s++) {
+            thread->stats[s].min_ns = UINT64_MAX;
+        }
+        thread->spans_written = 0;
+    }
+    g_trace_state.epoch_ns = audio_trace_now();
+}
+
+void audio_trace_get_stats(audio_trace_stage_t stage, audio_trace_stats_t* stats) {
+    memset(stats, 0, sizeof(*stats));
+    stats->min_ns = UINT64_MAX;
+    for (uint32_t t = 0; t < registered_threads() && stage < AUDIO_TRACE_STAGE_COUNT; t++) {
+        const trace_thread_t* thread = g_trace_state.threads[t];
+        if (!thread) {
+            continue;
+        }
+        const audio_trace_stats_t* s = &thread->stats[stage];
+        stats->count += s->count;
+        stats->total_ns += s->total_ns;
+        stats->min_ns = s->min_ns < stats->min_ns ? s->min_ns : stats->min_ns;
+        stats->max_ns = s->max_ns > stats->max_ns ? s->max_ns : stats->max_ns;
+    }
+    if (stats->count == 0) {
+        stats->min_ns = 0;
+    }
+}
+
+uint64_t audio_trace_get_counter(audio_trace_counter_t counter) {
+    uint64_t total = 0;
+    for (uint32_t t = 0; t < registered_threads() && counter < AUDIO_TRACE_COUNTER_COUNT; t++) {
+        if (g_trace_state.threads[t]) {
+            total += g_trace_state.threads[t]->counters[counter];
+        }
+    }
+    return total;
+}
+
+const char* audio_trace_stage_name(audio_trace_stage_t stage) {
+    return stage < AUDIO_TRACE_STAGE_COUNT ? k_stage_names[stage] : "unknown";
+}
+
+void audio_trace_report(void) {
+    if (!audio_trace_compiled_in()) {
+        return;
+    }
+
+    printf("[AUDIO_TRACE] %-12s %10s %12s %10s %10s %10s\n", "stage", "count", "total us", "mean ns", "min ns",
+           "max ns");
+    for (int s = 0; s < AUDIO_TRACE_STAGE_COUNT; s++) {
+        audio_trace_stats_t stats;
+        audio_trace_get_stats((audio_trace_stage_t)s, &stats);
+        if (stats.count == 0) {
+            continue;
+        }
+        printf("[AUDIO_TRACE] %-12s %10lu %12.1f %10lu %10lu %10lu\n", k_stage_names[s],
+               (unsigned long)stats.count, stats.total_ns / 1000.0, (unsigned long)(stats.total_ns / stats.count),
+               (unsigned long)stats.min_ns, (unsigned long)stats.max_ns);
+    }
+    for (int c = 0; c < AUDIO_TRACE_COUNTER_COUNT; c++) {
+        printf("[AUDIO_TRACE] %-16s %lu\n", k_counter_names[c],
+               (unsigned long)audio_trace_get_counter((audio_trace_counter_t)c));
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Export
+// ---------------------------------------------------------------------------
+
+int audio_trace_export_chrome(const char* path) {
+    FILE* file = path ? fopen(path, "w") : NULL;
+    if (!file) {
+        return RETROSAGA_ERROR_FILE_IO;
+    }
+
+    bool first = true;
+    fprintf(file, "{\"displayTimeUnit\": \"ns\", \"traceEvents\": [\n");
+    for (uint32_t t = 0; t < registered_threads(); t++) {
+        const trace_thread_t* thread = g_trace_state.threads[t];
+        if (!thread) {
+            continue;
+        }
+
+        fprintf(file, "%s{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": %u, "
+                "\"args\": {\"name\": \"%s\"}}", first ? "" : ",\n", t + 1, thread->name);
+        first = false;
+
+        // Oldest retained span first
+        uint64_t count = thread->spans_written < AUDIO_TRACE_SPAN_CAPACITY ? thread->spans_written
+                                                                           : AUDIO_TRACE_SPAN_CAPACITY;
+        for (uint64_t i = thread->spans_written - count; i < thread->spans_written; i++) {
+            const trace_span_t* span = &thread->spans[i & TRACE_SPAN_MASK];
+            double ts_us = (double)(int64_t)(span->start_ns - g_trace_state.epoch_ns) / 1000.0;
+            fprintf(file, ",\n{\"name\": \"%s\", \"ph\": \"X\", \"pid\": 1, \"tid\": %u, \"ts\": %.3f, "
+                    "\"dur\": %.3f}", k_stage_names[span->stage], t + 1, ts_us, span->duration_ns / 1000.0);
+        }
+    }
+    fprintf(file, "\n]}\n");
+
+    bool ok = !ferror(file);
+    ok &= fclose(file) == 0;
+    return ok ? RETROSAGA_SUCCESS : RETROSAGA_ERROR_FILE_IO;
+}
+
+static void folded_stack(FILE* file, int stage) {
+    if (k_stage_parent[stage] >= 0) {
+        folded_stack(file, k_stage_parent[stage]);
+        fputc(';', file);
+    }
+    fputs(k_stage_names[stage], file);
+}
+
+int audio_trace_export_folded(const char* path) {
+    FILE* file = path ? fopen(path, "w") : NULL;
+    if (!file) {
+        return RETROSAGA_ERROR_FILE_IO;
+    }
+
+    // Self time per stage: total minus the time of its child stages
+    uint64_t totals[AUDIO_TRACE_STAGE_COUNT];
+    int64_t self[AUDIO_TRACE_STAGE_COUNT];
+    for (int s = 0; s < AUDIO_TRACE_STAGE_COUNT; s++) {
+        audio_trace_stats_t stats;
+        audio_trace_get_stats((audio_trace_stage_t)s, &stats);
+        totals[s] = stats.total_ns;
+        self[s] = (int64_t)stats.total_ns;
+    }
+    for (int s = 0; s < AUDIO_TRACE_STAGE_COUNT; s++) {
+        if (k_stage_parent[s] >= 0) {
+            self[k_stage_parent[s]] -= (int64_t)totals[s];
+        }
+    }
+
+    for (int s = 0; s < AUDIO_TRACE_STAGE_COUNT; s++) {
+        if (self[s] > 0) {
+            folded_stack(file, s);
+            fprintf(file, " %lld\n", (long long)self[s]);
+        }
+    }
+
+    bool ok = !ferror(file);
+    ok &= fclose(file) == 0;
+    return ok ? RETROSAGA_SUCCESS : RETROSAGA_ERROR_FILE_IO;
+}
+
+void audio_trace_shutdown(void) {
+    if (!g_trace_state.initialized) {
+        return;
+    }
+
+    if (audio_trace_compiled_in()) {
+        audio_trace_report();
+        if (g_trace_state.export_path[0]) {
+            char folded[TRACE_PATH_MAX + 8];
+            snprintf(folded, sizeof(folded), "%s.folded", g_trace_state.export_path);
+            if (audio_trace_export_chrome(g_trace_state.export_path) == RETROSAGA_SUCCESS &&
+                audio_trace_export_folded(folded) == RETROSAGA_SUCCESS) {
+                printf("[AUDIO_TRACE] Trace written to %s and %s\n", g_trace_state.export_path, folded);
+            } else {
+                printf("[AUDIO_TRACE] ERROR: Cannot write trace to %s\n", g_trace_state.export_path);
+            }
+        }
+    }
+
+    for (uint32_t t = 0; t < registered_threads(); t++) {
+        if (g_trace_state.threads[t]) {
+            free(g_trace_state.threads[t]->spans);
+            free(g_trace_state.threads[t]);
+        }
+    }
+    memset(&g_trace_state, 0, sizeof(g_trace_state));
+    t_trace_thread = NULL;
+}
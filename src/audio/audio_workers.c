@@ -0,0 +1,292 @@
+/*
+ * Audio Workers
+ * Fork-join worker pool for intra-block rendering
+ */
+
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#include "audio/audio_workers.h"
+#include "audio/audio_trace.h"
+
+typedef struct {
+    // Written by the caller once per dispatch; futex word for parked workers
+    uint32_t generation __attribute__((aligned(64)));
+    uint32_t sleepers;
+    audio_worker_fn fn;
+    void* context;
+    bool stopping;
+
+    // Decremented by each worker as it finishes; futex word for the caller
+    uint32_t pending __attribute__((aligned(64)));
+    uint32_t caller_waiting;
+
+    pthread_t threads[AUDIO_WORKERS_MAX];
+    uint32_t indices[AUDIO_WORKERS_MAX];
+    uint32_t count;
+    uint32_t spin_limit;
+    int render_cpu;                // Kept free of workers when pinning, else -1
+    audio_workers_stats_t stats;
+    bool initialized;
+} audio_workers_state_t;
+
+static audio_workers_state_t g_workers = {0};
+
+static inline void cpu_relax(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    __asm__ __volatile__("yield");
+#endif
+}
+
+static void futex_wait(uint32_t* word, uint32_t expected) {
+    syscall(SYS_futex, word, FUTEX_WAIT_PRIVATE, expected, NULL, NULL, 0);
+}
+
+static void futex_wake(uint32_t* word, int count) {
+    syscall(SYS_futex, word, FUTEX_WAKE_PRIVATE, count, NULL, NULL, 0);
+}
+
+// Spin, then park until *word differs from value. The waiter count is
+// published before the futex re-checks the word, pairing with the
+// sequentially consistent store and count read on the waking side.
+static void spin_then_park(uint32_t* word, uint32_t value, uint32_t* waiters, uint64_t* parks) {
+    for (uint32_t spin = 0; spin < g_workers.spin_limit; spin++) {
+        if (__atomic_load_n(word, __ATOMIC_ACQUIRE) != value) {
+            return;
+        }
+        cpu_relax();
+    }
+
+    __atomic_fetch_add(parks, 1, __ATOMIC_RELAXED);
+    while (__atomic_load_n(word, __ATOMIC_SEQ_CST) == value) {
+        __atomic_fetch_add(waiters, 1, __ATOMIC_SEQ_CST);
+        futex_wait(word, value);
+        __atomic_fetch_sub(waiters, 1, __ATOMIC_SEQ_CST);
+    }
+}
+
+static void* worker_main(void* arg) {
+    uint32_t index = *(const uint32_t*)arg;
+    char name[32];
+    snprintf(name, sizeof(name), "voice_worker_%u", index);
+    audio_trace_thread_register(name);
+
+    uint32_t seen = 0;
+    for (;;) {
+        spin_then_park(&g_workers.generation, seen, &g_workers.sleepers, &g_workers.stats.worker_parks);
+        seen = __atomic_load_n(&g_workers.generation, __ATOMIC_ACQUIRE);
+        if (__atomic_load_n(&g_workers.stopping, __ATOMIC_ACQUIRE)) {
+            break;
+        }
+
+        g_workers.fn(g_workers.context, index, g_workers.count);
+
+        if (__atomic_sub_fetch(&g_workers.pending, 1, __ATOMIC_SEQ_CST) == 0 &&
+            __atomic_load_n(&g_workers.caller_waiting, __ATOMIC_SEQ_CST)) {
+            futex_wake(&g_workers.pending, 1);
+        }
+    }
+    return NULL;
+}
+
+// CPUs workers are pinned to, in order: every CPU the calling thread may
+// use except the one it runs on. A caller pinned to a single CPU still
+// leaves the other online CPUs to the workers.
+static uint32_t worker_cpus(int render_cpu, uint32_t* cpus, uint32_t capacity) {
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0) {
+        return 0;
+    }
+    if (CPU_COUNT(&allowed) == 1) {
+        long online = sysconf(_SC_NPROCESSORS_ONLN);
+        for (long c = 0; c < online && c < CPU_SETSIZE; c++) {
+            CPU_SET(c, &allowed);
+        }
+    }
+
+    uint32_t count = 0;
+    for (int c = 0; c < CPU_SETSIZE && count < capacity; c++) {
+        if (CPU_ISSET(c, &allowed) && c != render_cpu) {
+            cpus[count++] = (uint32_t)c;
+        }
+    }
+    return count;
+}
+
+int audio_workers_init(uint32_t worker_count, uint32_t stack_size_kb, bool pin) {
+    if (g_workers.initialized) {
+        return RETROSAGA_ERROR_ALREADY_INITIALIZED;
+    }
+    if (worker_count == 0) {
+        return RETROSAGA_ERROR_INVALID_PARAM;
+    }
+
+    memset(&g_workers, 0, sizeof(g_workers));
+    g_workers.count = worker_count < AUDIO_WORKERS_MAX ? worker_count : AUDIO_WORKERS_MAX;
+    g_workers.render_cpu = -1;
+    g_workers.initialized = true;
+    if (g_workers.count == 1) {
+        return RETROSAGA_SUCCESS;
+    }
+
+    // Spinning only pays when the workers have cores of their own
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    g_workers.spin_limit = cpus > 1 ? AUDIO_WORKERS_SPIN_LIMIT : 0;
+    if (cpus > 0 && (uint32_t)cpus < g_workers.count) {
+        printf("[AUDIO_WORKERS] WARNING: %u workers on %ld CPUs, parking instead of spinning\n", g_workers.count,
+               cpus);
+    }
+
+    // The engine is initialized on its render thread, so its CPU stays free
+    uint32_t cpus_free[AUDIO_WORKERS_MAX];
+    uint32_t cpus_free_count = 0;
+    if (pin) {
+        g_workers.render_cpu = sched_getcpu();
+        cpus_free_count = worker_cpus(g_workers.render_cpu, cpus_free, AUDIO_WORKERS_MAX);
+        if (cpus_free_count == 0) {
+            printf("[AUDIO_WORKERS] WARNING: No CPU besides the render thread's, workers left unpinned\n");
+            g_workers.render_cpu = -1;
+        }
+    }
+
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+    if (stack_size_kb > 0) {
+        pthread_attr_setstacksize(&attr, (size_t)stack_size_kb * 1024u);
+    }
+
+    for (uint32_t w = 1; w < g_workers.count; w++) {
+        g_workers.indices[w] = w;
+        if (pthread_create(&g_workers.threads[w], &attr, worker_main, &g_workers.indices[w]) != 0) {
+            printf("[AUDIO_WORKERS] ERROR: Cannot start worker %u\n", w);
+            pthread_attr_destroy(&attr);
+            g_workers.count = w;
+            audio_workers_shutdown();
+            return RETROSAGA_ERROR_AUDIO_INIT;
+        }
+        if (cpus_free_count > 0) {
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            CPU_SET(cpus_free[(w - 1) % cpus_free_count], &set);
+            pthread_setaffinity_np(g_workers.threads[w], sizeof(set), &set);
+        }
+    }
+    pthread_attr_destroy(&attr);
+
+    if (g_workers.render_cpu >= 0) {
+        printf("[AUDIO_WORKERS] %u render workers (%u pool threads, pinned clear of CPU %d)\n", g_workers.count,
+               g_workers.count - 1, g_workers.render_cpu);
+    } else {
+        printf("[AUDIO_WORKERS] %u render workers (%u pool threads)\n", g_workers.count, g_workers.count - 1);
+    }
+    return RETROSAGA_SUCCESS;
+}
+
+void audio_workers_shutdown(void) {
+    if (!g_workers.initialized) {
+        return;
+    }
+
+    if (g_workers.count > 1) {
+        __atomic_store_n(&g_workers.stopping, true, __ATOMIC_RELEASE);
+        __atomic_add_fetch(&g_workers.generation, 1, __ATOMIC_SEQ_CST);
+        futex_wake(&g_workers.generation, INT_MAX);
+        for (uint32_t w = 1; w < g_workers.count; w++) {
+            pthread_join(g_workers.threads[w], NULL);
+        }
+        printf("[AUDIO_WORKERS] Dispatches: %lu, worker parks: %lu, caller parks: %lu\n",
+               (unsigned long)g_workers.stats.dispatches, (unsigned long)g_workers.stats.worker_parks,
+               (unsigned long)g_workers.stats.caller_parks);
+    }
+    memset(&g_workers, 0, sizeof(g_workers));
+}
+
+uint32_t audio_workers_count(void) {
+    return g_workers.initialized ? g_workers.count : 1;
+}
+
+void audio_workers_run(audio_worker_fn fn, void* context) {
+    if (!g_workers.initialized || g_workers.count == 1) {
+        fn(context, 0, 1);
+        return;
+    }
+
+    g_workers.fn = fn;
+    g_workers.context = context;
+    __atomic_store_n(&g_workers.pending, g_workers.count - 1, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&g_workers.generation, 1, __ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&g_workers.sleepers, __ATOMIC_SEQ_CST) > 0) {
+        futex_wake(&g_workers.generation, INT_MAX);
+    }
+    g_workers.stats.dispatches++;
+
+    fn(context, 0, g_workers.count);
+
+    // Join: spin for the stragglers, then park until the last one wakes us
+    uint32_t pending;
+    uint32_t spin = 0;
+    while ((pending = __atomic_load_n(&g_workers.pending, __ATOMIC_ACQUIRE)) != 0) {
+        if (spin++ < g_workers.spin_limit) {
+            cpu_relax();
+            continue;
+        }
+        g_workers.stats.caller_parks++;
+        __atomic_store_n(&g_workers.caller_waiting, 1, __ATOMIC_SEQ_CST);
+        while ((pending = __atomic_load_n(&g_workers.pending, __ATOMIC_SEQ_CST)) != 0) {
+            futex_wait(&g_workers.pending, pending);
+        }
+        __atomic_store_n(&g_workers.caller_waiting, 0, __ATOMIC_RELAXED);
+    }
+}
+
+void audio_workers_get_stats(audio_workers_stats_t* stats) {
+    *stats = g_workers.stats;
+    stats->worker_parks = __atomic_load_n(&g_workers.stats.worker_parks, __ATOMIC_RELAXED);
+}
+
+static void validate_job(void* context, uint32_t worker, uint32_t worker_count) {
+    uint32_t* slots = context;
+    slots[worker] += worker + 1;
+    (void)worker_count;
+}
+
+bool audio_workers_validate(void) {
+    uint32_t slots[AUDIO_WORKERS_MAX] = {0};
+    const uint32_t rounds = 64;
+    for (uint32_t r = 0; r < rounds; r++) {
+        audio_workers_run(validate_job, slots);
+    }
+
+    // Every worker ran every round, and the caller saw their writes
+    uint32_t count = audio_workers_count();
+    for (uint32_t w = 0; w < AUDIO_WORKERS_MAX; w++) {
+        uint32_t expected = w < count ? rounds * (w + 1) : 0;
+        if (slots[w] != expected) {
+            printf("[AUDIO_WORKERS] ERROR: Worker %u ran %u/%u jobs\n", w, slots[w] / (w + 1), rounds);
+            return false;
+        }
+    }
+
+    // Pinned workers never share the render thread's CPU
+    for (uint32_t w = 1; w < count && g_workers.render_cpu >= 0; w++) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        if (pthread_getaffinity_np(g_workers.threads[w], sizeof(set), &set) == 0 &&
+            CPU_ISSET(g_workers.render_cpu, &set)) {
+            printf("[AUDIO_WORKERS] ERROR: Worker %u may run on render CPU %d\n", w, g_workers.render_cpu);
+            return false;
+        }
+    }
+    return true;
+}
@@ -3,15 +3,54 @@
  * Aegis Project Phase 1 Implementation
  */
 
+#define _POSIX_C_SOURCE 200809L
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdbool.h>
+#include <math.h>
 #include "audio/effect_engine.h"
+#include "audio/render_kernels.h"
+#include "audio/audio_params.h"
+#include "audio/audio_convolver.h"
 #include <string.h>
 #include <stdlib.h>
+
+// A loaded impulse response: one convolver per output channel
+typedef struct effect_reverb {
+    struct effect_reverb* next;  // Link in the retired list
+    uint32_t ir_frames;
+    uint8_t channels;
+    bool dirty;                  // Fed since the last reset
+    float* dry;                  // One channel of one block, deinterleaved
+    float* wet;
+    float* envelope;             // Per block offset: largest sum of |taps| from there on
+    uint32_t envelope_blocks;    // Entries past the last hold 0
+    audio_convolver_t convolvers[EFFECT_ENGINE_REVERB_MAX_CHANNELS];
+} effect_reverb_t;
+
 typedef struct {
     bool initialized;
     uint32_t operations_count;
+    uint64_t frames_processed;
+    uint8_t crush_bits;          // 0 = bitcrusher bypassed
+    float crush_levels;
+    audio_param_t output_gain;   // Smoothed, skipped while flat at unity
+    uint32_t tail_frames;        // Longest tail among the enabled effects
+    uint32_t tail_remaining;     // Frames of tail still owed after silent input
+    float tail_peak;             // Loudest input feeding the current tail
+    uint64_t blocks_skipped;     // Silent blocks that bypassed the chain
+
+    // Reverb: the audio thread owns reverb; the loader publishes into
+    // reverb_pending and frees what the audio thread pushes on reverb_retired
+    uint32_t block_frames;       // Sub-block size the convolvers are planned for
+    uint8_t channels;
+    effect_reverb_t* reverb;
+    effect_reverb_t* reverb_pending;
+    effect_reverb_t* reverb_retired;
+    audio_param_t reverb_level;
+    uint64_t reverb_blocks;
+    uint64_t reverb_bypassed;    // Blocks with another size or layout, left dry
 } effect_engine_state_t;
 
 static effect_engine_state_t g_effect_engine_state = {0};
@@ -23,7 +62,12 @@ int effect_engine_init(void) {
     
     printf("[EFFECT_ENGINE] Initializing effect_engine module...\n");
     
+    const retrosaga_audio_config_t* config = retrosaga_audio_get_config();
     g_effect_engine_state.operations_count = 0;
+    g_effect_engine_state.block_frames = config->sub_block_frames;
+    g_effect_engine_state.channels = config->channels;
+    audio_param_init(&g_effect_engine_state.output_gain, 1.0f);
+    audio_param_init(&g_effect_engine_state.reverb_level, 1.0f);
     g_effect_engine_state.initialized = true;
     
     printf("[EFFECT_ENGINE] Effect_engine module initialized successfully\n");
@@ -39,6 +83,383 @@ int effect_engine_process(void) {
     return RETROSAGA_SUCCESS;
 }
 
+// Interleaved gain ramp across one block
+static void apply_gain_ramp(float* buffer, float start, float end, uint32_t frames, uint8_t channels) {
+    const float step = (end - start) / (float)frames;
+    for (uint32_t i = 0; i < frames; i++) {
+        const float gain = start + step * (float)i;
+        for (uint8_t c = 0; c < channels; c++) {
+            buffer[i * channels + c] *= gain;
+        }
+    }
+}
+
+static float block_peak(const float* buffer, size_t samples) {
+    float peak = 0.0f;
+    for (size_t i = 0; i < samples; i++) {
+        float level = fabsf(buffer[i]);
+        peak = level > peak ? level : peak;
+    }
+    return peak;
+}
+
+static void reverb_free(effect_reverb_t* reverb) {
+    while (reverb) {
+        effect_reverb_t* next = reverb->next;
+        for (uint8_t c = 0; c < reverb->channels; c++) {
+            audio_convolver_destroy(&reverb->convolvers[c]);
+        }
+        free(reverb->dry);
+        free(reverb->wet);
+        free(reverb->envelope);
+        free(reverb);
+        reverb = next;
+    }
+}
+
+// Audio thread: take a freshly loaded response, if any, and hand the one
+// it replaces back to the loader without freeing it here
+static void reverb_install_pending(void) {
+    effect_reverb_t* fresh = __atomic_exchange_n(&g_effect_engine_state.reverb_pending, NULL, __ATOMIC_ACQUIRE);
+    if (!fresh) {
+        return;
+    }
+
+    effect_reverb_t* old = g_effect_engine_state.reverb;
+    g_effect_engine_state.reverb = fresh;
+    g_effect_engine_state.tail_frames = fresh->ir_frames;
+    if (old) {
+        old->next = __atomic_load_n(&g_effect_engine_state.reverb_retired, __ATOMIC_RELAXED);
+        while (!__atomic_compare_exchange_n(&g_effect_engine_state.reverb_retired, &old->next, old, true,
+                                            __ATOMIC_RELEASE, __ATOMIC_RELAXED)) {
+        }
+    }
+}
+
+// Silence lets the tail die out; clear the history so it cannot come back
+// at the wrong time when sound resumes
+static void reverb_quiesce(void) {
+    effect_reverb_t* reverb = g_effect_engine_state.reverb;
+    if (reverb && reverb->dirty) {
+        for (uint8_t c = 0; c < reverb->channels; c++) {
+            audio_convolver_reset(&reverb->convolvers[c]);
+        }
+        reverb->dirty = false;
+    }
+}
+
+// Largest output the response can still add once the input has been silent
+// for elapsed frames, per unit of input peak
+static float reverb_tail_bound(uint32_t elapsed) {
+    const effect_reverb_t* reverb = g_effect_engine_state.reverb;
+    if (!reverb) {
+        return 0.0f;
+    }
+    uint32_t index = elapsed / g_effect_engine_state.block_frames;
+    return index < reverb->envelope_blocks ? reverb->envelope[index] : 0.0f;
+}
+
+static void apply_reverb(float* buffer, uint32_t frames, uint8_t channels) {
+    effect_reverb_t* reverb = g_effect_engine_state.reverb;
+    audio_param_t* level = &g_effect_engine_state.reverb_level;
+    const bool moving = audio_param_advance(level);
+    if (!reverb) {
+        return;
+    }
+    if (!moving && level->value == 0.0f) {
+        reverb_quiesce();
+        return;
+    }
+
+    const uint32_t block = g_effect_engine_state.block_frames;
+    if (channels != reverb->channels || frames % block != 0) {
+        g_effect_engine_state.reverb_bypassed++;
+        return;
+    }
+
+    const float step = (level->value - level->block_start) / (float)frames;
+    for (uint32_t start = 0; start < frames; start += block) {
+        float* chunk = buffer + (size_t)start * channels;
+        for (uint8_t c = 0; c < channels; c++) {
+            for (uint32_t i = 0; i < block; i++) {
+                reverb->dry[i] = chunk[(size_t)i * channels + c];
+            }
+            audio_convolver_process(&reverb->convolvers[c], reverb->dry, reverb->wet);
+            for (uint32_t i = 0; i < block; i++) {
+                chunk[(size_t)i * channels + c] += (level->block_start + step * (float)(start + i)) * reverb->wet[i];
+            }
+        }
+    }
+    reverb->dirty = true;
+    g_effect_engine_state.reverb_blocks++;
+}
+
+int effect_engine_process_buffer(float* buffer, uint32_t frames, uint8_t channels) {
+    return effect_engine_process_block(buffer, frames, channels, NULL);
+}
+
+int effect_engine_process_block(float* buffer, uint32_t frames, uint8_t channels, bool* silent) {
+    if (!g_effect_engine_state.initialized) {
+        return RETROSAGA_ERROR_NOT_INITIALIZED;
+    }
+    if (!buffer || channels == 0) {
+        return RETROSAGA_ERROR_INVALID_PARAM;
+    }
+    
+    // Asleep: the chain would only turn zeros into zeros. Parameter ramps
+    // still advance so they stay in step with the blocks that did play.
+    reverb_install_pending();
+    const bool input_silent = silent && *silent;
+    if (input_silent && g_effect_engine_state.tail_remaining == 0) {
+        reverb_quiesce();
+        audio_param_advance(&g_effect_engine_state.reverb_level);
+        audio_param_advance(&g_effect_engine_state.output_gain);
+        g_effect_engine_state.blocks_skipped++;
+        g_effect_engine_state.frames_processed += frames;
+        return RETROSAGA_SUCCESS;
+    }
+    
+    // The input peak bounds what the reverb can still return once it stops
+    uint32_t* remaining = &g_effect_engine_state.tail_remaining;
+    if (!input_silent && g_effect_engine_state.reverb) {
+        float peak = block_peak(buffer, (size_t)frames * channels);
+        float* tail_peak = &g_effect_engine_state.tail_peak;
+        *tail_peak = *remaining > 0 && *tail_peak > peak ? *tail_peak : peak;
+    }
+    
+    // Effects operate in place so captured blocks never leave their ring slot
+    apply_reverb(buffer, frames, channels);
+    const render_kernels_t* kernels = render_kernels_select(frames, channels);
+    if (g_effect_engine_state.crush_bits) {
+        kernels->bitcrush(buffer, g_effect_engine_state.crush_levels, frames, channels);
+    }
+    
+    audio_param_t* gain = &g_effect_engine_state.output_gain;
+    if (audio_param_advance(gain) || gain->value != 1.0f) {
+        apply_gain_ramp(buffer, gain->block_start, gain->value, frames, channels);
+    }
+    
+    // Sound refills the tail and silence drains it. It ends early only when
+    // this block is inaudible and so is all the response has left to give,
+    // so a pre-delay, a gap in the response or a gain ramp through zero
+    // does not cut it.
+    bool output_silent = false;
+    if (!input_silent) {
+        *remaining = g_effect_engine_state.tail_frames;
+    } else {
+        const uint32_t tail = g_effect_engine_state.tail_frames;
+        const uint32_t elapsed = (tail > *remaining ? tail - *remaining : 0) + frames;
+        const bool inaudible = block_peak(buffer, (size_t)frames * channels) < EFFECT_ENGINE_SILENCE_THRESHOLD;
+        *remaining = *remaining > frames ? *remaining - frames : 0;
+        if (inaudible &&
+            g_effect_engine_state.tail_peak * reverb_tail_bound(elapsed) < EFFECT_ENGINE_SILENCE_THRESHOLD) {
+            *remaining = 0;
+        }
+        if (*remaining == 0 && inaudible) {
+            memset(buffer, 0, (size_t)frames * channels * sizeof(float));
+            output_silent = true;
+        }
+    }
+    if (silent) {
+        *silent = output_silent;
+    }
+    
+    g_effect_engine_state.frames_processed += frames;
+    return RETROSAGA_SUCCESS;
+}
+
+// Bitcrush and gain are memoryless; the reverb raises this to its response
+uint32_t effect_engine_tail_frames(void) {
+    return g_effect_engine_state.tail_frames;
+}
+
+int effect_engine_set_bitcrush(uint8_t bits) {
+    if (bits == 1 || bits > 24) {
+        return RETROSAGA_ERROR_INVALID_PARAM;
+    }
+    
+    g_effect_engine_state.crush_bits = bits;
+    g_effect_engine_state.crush_levels = bits ? (float)((1u << (bits - 1)) - 1) : 0.0f;
+    return RETROSAGA_SUCCESS;
+}
+
+int effect_engine_set_output_gain(float gain) {
+    if (!g_effect_engine_state.initialized) {
+        return RETROSAGA_ERROR_NOT_INITIALIZED;
+    }
+    if (!(gain >= 0.0f) || !isfinite(gain)) {
+        return RETROSAGA_ERROR_INVALID_PARAM;
+    }
+    
+    audio_param_set(&g_effect_engine_state.output_gain, gain, audio_params_ramp_blocks());
+    return RETROSAGA_SUCCESS;
+}
+
+// Sum of |taps| from each block offset to the end, the worst case over the
+// channels in use; scaled by the input peak it bounds the remaining tail
+static int reverb_build_envelope(effect_reverb_t* reverb, const float* ir, uint8_t ir_channels, uint32_t block) {
+    reverb->envelope_blocks = (reverb->ir_frames + block - 1) / block;
+    reverb->envelope = calloc(reverb->envelope_blocks, sizeof(float));
+    if (!reverb->envelope) {
+        return RETROSAGA_ERROR_AUDIO_INIT;
+    }
+    const uint8_t used = reverb->channels < ir_channels ? reverb->channels : ir_channels;
+    for (uint8_t c = 0; c < used; c++) {
+        double sum = 0.0;
+        for (uint32_t n = reverb->ir_frames; n-- > 0;) {
+            sum += fabs((double)ir[(size_t)n * ir_channels + c]);
+            if (n % block == 0 && (float)sum > reverb->envelope[n / block]) {
+                reverb->envelope[n / block] = (float)sum;
+            }
+        }
+    }
+    return RETROSAGA_SUCCESS;
+}
+
+int effect_engine_load_reverb(const float* ir, uint32_t ir_frames, uint8_t ir_channels) {
+    if (!g_effect_engine_state.initialized) {
+        return RETROSAGA_ERROR_NOT_INITIALIZED;
+    }
+    if (!ir || ir_frames == 0 || ir_frames > EFFECT_ENGINE_REVERB_MAX_FRAMES || ir_channels == 0) {
+        return RETROSAGA_ERROR_INVALID_PARAM;
+    }
+    const uint8_t channels = g_effect_engine_state.channels;
+    const uint32_t block = g_effect_engine_state.block_frames;
+    if (channels == 0 || channels > EFFECT_ENGINE_REVERB_MAX_CHANNELS) {
+        return RETROSAGA_ERROR_INVALID_PARAM;
+    }
+
+    // Whatever the audio thread retired since the last load is unused now
+    reverb_free(__atomic_exchange_n(&g_effect_engine_state.reverb_retired, NULL, __ATOMIC_ACQUIRE));
+
+    effect_reverb_t* reverb = calloc(1, sizeof(*reverb));
+    if (!reverb) {
+        return RETROSAGA_ERROR_AUDIO_INIT;
+    }
+    void* dry = NULL;
+    void* wet = NULL;
+    int status = posix_memalign(&dry, 64, block * sizeof(float)) == 0 &&
+                 posix_memalign(&wet, 64, block * sizeof(float)) == 0 ? RETROSAGA_SUCCESS : RETROSAGA_ERROR_AUDIO_INIT;
+    reverb->dry = dry;
+    reverb->wet = wet;
+    reverb->ir_frames = ir_frames;
+    for (uint8_t c = 0; c < channels && status == RETROSAGA_SUCCESS; c++) {
+        status = audio_convolver_init(&reverb->convolvers[c], ir + c % ir_channels, ir_frames, ir_channels, block,
+                                      NULL);
+        if (status == RETROSAGA_SUCCESS) {
+            reverb->channels = c + 1;
+        }
+    }
+    if (status == RETROSAGA_SUCCESS) {
+        status = reverb_build_envelope(reverb, ir, ir_channels, block);
+    }
+    if (status != RETROSAGA_SUCCESS) {
+        printf("[EFFECT_ENGINE] ERROR: Cannot plan a %u-frame reverb response\n", ir_frames);
+        reverb_free(reverb);
+        return status;
+    }
+
+    size_t bytes = 0;
+    for (uint8_t c = 0; c < channels; c++) {
+        bytes += reverb->convolvers[c].bytes;
+    }
+    printf("[EFFECT_ENGINE] Reverb response: %u frames x %u channels, %u levels, %zu KB of spectra\n", ir_frames,
+           channels, reverb->convolvers[0].level_count, bytes / 1024);
+
+    // A response the audio thread never picked up is replaced outright
+    reverb_free(__atomic_exchange_n(&g_effect_engine_state.reverb_pending, reverb, __ATOMIC_ACQ_REL));
+    return RETROSAGA_SUCCESS;
+}
+
+int effect_engine_set_reverb_level(float level) {
+    if (!g_effect_engine_state.initialized) {
+        return RETROSAGA_ERROR_NOT_INITIALIZED;
+    }
+    if (!(level >= 0.0f) || !isfinite(level)) {
+        return RETROSAGA_ERROR_INVALID_PARAM;
+    }
+
+    audio_param_set(&g_effect_engine_state.reverb_level, level, audio_params_ramp_blocks());
+    return RETROSAGA_SUCCESS;
+}
+
+// ---------------------------------------------------------------------------
+// Snapshots
+// ---------------------------------------------------------------------------
+
+#define EFFECT_SNAPSHOT_TAG AUDIO_SNAPSHOT_TAG('F', 'X', 'C', 'H')
+
+typedef struct {
+    uint8_t crush_bits;
+    float crush_levels;
+    audio_param_t output_gain;
+    audio_param_t reverb_level;
+    uint32_t tail_remaining;
+    float tail_peak;
+    uint32_t reverb_frames;      // 0 = no response loaded
+    uint8_t reverb_channels;
+    bool reverb_dirty;           // Delay lines follow
+} effect_snapshot_t;
+
+void effect_engine_snapshot_save(audio_snapshot_stream_t* stream) {
+    // Compare against the response the next block will use
+    reverb_install_pending();
+    const effect_reverb_t* reverb = g_effect_engine_state.reverb;
+    effect_snapshot_t chain = {
+        .crush_bits = g_effect_engine_state.crush_bits,
+        .crush_levels = g_effect_engine_state.crush_levels,
+        .output_gain = g_effect_engine_state.output_gain,
+        .reverb_level = g_effect_engine_state.reverb_level,
+        .tail_remaining = g_effect_engine_state.tail_remaining,
+        .tail_peak = g_effect_engine_state.tail_peak,
+        .reverb_frames = reverb ? reverb->ir_frames : 0,
+        .reverb_channels = reverb ? reverb->channels : 0,
+        .reverb_dirty = reverb && reverb->dirty,
+    };
+
+    audio_snapshot_begin_section(stream, EFFECT_SNAPSHOT_TAG, sizeof(chain));
+    audio_snapshot_put(stream, &chain, sizeof(chain));
+    for (uint8_t c = 0; chain.reverb_dirty && c < chain.reverb_channels; c++) {
+        audio_convolver_snapshot_save(&reverb->convolvers[c], stream);
+    }
+}
+
+bool effect_engine_snapshot_restore(audio_snapshot_stream_t* stream) {
+    effect_snapshot_t chain;
+    if (!audio_snapshot_expect_section(stream, EFFECT_SNAPSHOT_TAG, sizeof(chain)) ||
+        !audio_snapshot_get(stream, &chain, sizeof(chain))) {
+        return false;
+    }
+
+    reverb_install_pending();
+    effect_reverb_t* reverb = g_effect_engine_state.reverb;
+    if (chain.reverb_frames != (reverb ? reverb->ir_frames : 0) ||
+        chain.reverb_channels != (reverb ? reverb->channels : 0)) {
+        return audio_snapshot_refuse(stream, "Another reverb response is loaded");
+    }
+    if (!chain.reverb_dirty && stream->apply) {
+        reverb_quiesce();
+    }
+    for (uint8_t c = 0; chain.reverb_dirty && c < chain.reverb_channels; c++) {
+        if (!audio_convolver_snapshot_restore(&reverb->convolvers[c], stream)) {
+            return false;
+        }
+    }
+
+    if (stream->apply) {
+        g_effect_engine_state.crush_bits = chain.crush_bits;
+        g_effect_engine_state.crush_levels = chain.crush_levels;
+        g_effect_engine_state.output_gain = chain.output_gain;
+        g_effect_engine_state.reverb_level = chain.reverb_level;
+        g_effect_engine_state.tail_remaining = chain.tail_remaining;
+        g_effect_engine_state.tail_peak = chain.tail_peak;
+        if (reverb) {
+            reverb->dirty = chain.reverb_dirty;
+        }
+    }
+    return true;
+}
+
 void effect_engine_shutdown(void) {
     if (!g_effect_engine_state.initialized) {
         return;
@@ -46,6 +467,17 @@ void effect_engine_shutdown(void) {
     
     printf("[EFFECT_ENGINE] Shutting down effect_engine module...\n");
     printf("[EFFECT_ENGINE] Operations performed: %d\n", g_effect_engine_state.operations_count);
+    printf("[EFFECT_ENGINE] Frames processed: %lu, silent blocks skipped: %lu\n",
+           (unsigned long)g_effect_engine_state.frames_processed,
+           (unsigned long)g_effect_engine_state.blocks_skipped);
+    if (g_effect_engine_state.reverb || g_effect_engine_state.reverb_pending) {
+        printf("[EFFECT_ENGINE] Reverb blocks: %lu, left dry: %lu\n",
+               (unsigned long)g_effect_engine_state.reverb_blocks,
+               (unsigned long)g_effect_engine_state.reverb_bypassed);
+    }
+    reverb_free(g_effect_engine_state.reverb);
+    reverb_free(g_effect_engine_state.reverb_pending);
+    reverb_free(g_effect_engine_state.reverb_retired);
     
     memset(&g_effect_engine_state, 0, sizeof(g_effect_engine_state));
     printf("[EFFECT_ENGINE] Effect_engine module shutdown complete\n");
@@ -57,6 +489,77 @@ bool effect_engine_validate(void) {
         return false;
     }
     
+    // Checks run on a private chain; the live one, reverb included, is put
+    // back untouched afterwards
+    const effect_engine_state_t live = g_effect_engine_state;
+    memset(&g_effect_engine_state, 0, sizeof(g_effect_engine_state));
+    g_effect_engine_state.initialized = true;
+    g_effect_engine_state.block_frames = 32;
+    g_effect_engine_state.channels = 2;
+    audio_param_init(&g_effect_engine_state.output_gain, 1.0f);
+    audio_param_init(&g_effect_engine_state.reverb_level, 1.0f);
+
+    // A silent block with no tail bypasses the chain and stays silent
+    float block[64] = {0};
+    bool silent = true;
+    effect_engine_process_block(block, 32, 2, &silent);
+    bool valid = silent && g_effect_engine_state.blocks_skipped == 1;
+    
+    // Sound is never reported silent, and a decayed tail ends early
+    block[0] = 0.5f;
+    silent = false;
+    effect_engine_process_block(block, 32, 2, &silent);
+    valid &= !silent;
+    g_effect_engine_state.tail_remaining = 1u << 20;
+    block[0] = EFFECT_ENGINE_SILENCE_THRESHOLD * 0.1f;
+    silent = true;
+    effect_engine_process_block(block, 32, 2, &silent);
+    valid &= silent && block[0] == 0.0f && g_effect_engine_state.tail_remaining == 0;
+    if (!valid) {
+        printf("[EFFECT_ENGINE] VALIDATION FAILED: Silence propagation\n");
+    }
+
+    // A response that starts after a pre-delay of several blocks keeps its
+    // tail through the silent blocks before the echo arrives
+    enum { PRE_DELAY = 200, IR_FRAMES = 256 };
+    float ir[IR_FRAMES] = {0};
+    ir[PRE_DELAY] = 0.5f;
+    bool echoed = false;
+    if (valid && effect_engine_load_reverb(ir, IR_FRAMES, 1) == RETROSAGA_SUCCESS) {
+        memset(block, 0, sizeof(block));
+        block[0] = block[1] = 1.0f;
+        silent = false;
+        effect_engine_process_block(block, 32, 2, &silent);
+        for (uint32_t start = 32; start < IR_FRAMES && valid; start += 32) {
+            memset(block, 0, sizeof(block));
+            silent = true;
+            effect_engine_process_block(block, 32, 2, &silent);
+            uint32_t offset = PRE_DELAY - start;
+            if (offset < 32) {
+                echoed = !silent && fabsf(block[offset * 2] - 0.5f) < 1e-4f &&
+                         fabsf(block[offset * 2 + 1] - 0.5f) < 1e-4f;
+            }
+        }
+        // Past the response the tail ends and the chain sleeps again
+        memset(block, 0, sizeof(block));
+        silent = true;
+        effect_engine_process_block(block, 32, 2, &silent);
+        valid &= echoed && silent && g_effect_engine_state.tail_remaining == 0;
+        if (!valid) {
+            printf("[EFFECT_ENGINE] VALIDATION FAILED: Pre-delayed reverb tail cut short\n");
+        }
+    } else if (valid) {
+        printf("[EFFECT_ENGINE] VALIDATION FAILED: Cannot load a test response\n");
+        valid = false;
+    }
+    reverb_free(g_effect_engine_state.reverb);
+    reverb_free(g_effect_engine_state.reverb_pending);
+    reverb_free(g_effect_engine_state.reverb_retired);
+    g_effect_engine_state = live;
+    if (!valid) {
+        return false;
+    }
+    
     printf("[EFFECT_ENGINE] Effect_engine module validation passed\n");
     return true;
 }
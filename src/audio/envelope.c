@@ -0,0 +1,88 @@
+/*
+ * Envelope Generator
+ * Block-rate ADSR envelopes
+ */
+
+#include <math.h>
+#include "audio/envelope.h"
+
+// ln(1000): exponential segments cover 60 dB in their nominal time
+#define ENVELOPE_LN_60DB 6.907755279
+
+static float block_coefficient(float time_ms, float sample_rate, uint32_t block_frames) {
+    double samples = (double)time_ms * 0.001 * sample_rate;
+    if (samples < 1.0) {
+        return 0.0f;
+    }
+    return (float)exp(-ENVELOPE_LN_60DB * block_frames / samples);
+}
+
+void envelope_shape_init(envelope_shape_t* shape, const envelope_params_t* params,
+                         float sample_rate, uint32_t block_frames) {
+    double attack_samples = (double)params->attack_ms * 0.001 * sample_rate;
+
+    shape->attack_step = attack_samples < block_frames ? 1.0f : (float)(block_frames / attack_samples);
+    shape->decay_coef = block_coefficient(params->decay_ms, sample_rate, block_frames);
+    shape->release_coef = block_coefficient(params->release_ms, sample_rate, block_frames);
+    shape->sustain = params->sustain < 0.0f ? 0.0f : (params->sustain > 1.0f ? 1.0f : params->sustain);
+}
+
+void envelope_gate_on(envelope_t* envelope) {
+    // Retrigger from the current level so stolen voices do not click
+    envelope->stage = ENVELOPE_ATTACK;
+}
+
+void envelope_gate_off(envelope_t* envelope) {
+    if (envelope->stage != ENVELOPE_IDLE) {
+        envelope->stage = ENVELOPE_RELEASE;
+    }
+}
+
+bool envelope_next_block(envelope_t* envelope, const envelope_shape_t* shape, float* start, float* end) {
+    float level = envelope->level;
+    *start = level;
+
+    switch (envelope->stage) {
+        case ENVELOPE_ATTACK:
+            level += shape->attack_step;
+            if (level >= 1.0f) {
+                level = 1.0f;
+                envelope->stage = ENVELOPE_DECAY;
+            }
+            break;
+
+        case ENVELOPE_DECAY:
+            level = shape->sustain + (level - shape->sustain) * shape->decay_coef;
+            if (fabsf(level - shape->sustain) < ENVELOPE_SILENCE) {
+                level = shape->sustain;
+                envelope->stage = ENVELOPE_SUSTAIN;
+            }
+            break;
+
+        case ENVELOPE_SUSTAIN:
+            level = shape->sustain;
+            break;
+
+        case ENVELOPE_RELEASE:
+            level *= shape->release_coef;
+            if (level < ENVELOPE_SILENCE) {
+                level = 0.0f;
+                envelope->stage = ENVELOPE_IDLE;
+            }
+            break;
+
+        default:
+            level = 0.0f;
+            break;
+    }
+
+    // A zero-sustain decay ends in silence just like a release
+    if (envelope->stage == ENVELOPE_SUSTAIN && level < ENVELOPE_SILENCE) {
+        level = 0.0f;
+        envelope->stage = ENVELOPE_IDLE;
+    }
+
+    envelope->level = level;
+    *end = level;
+    return envelope->stage != ENVELOPE_IDLE;
+}
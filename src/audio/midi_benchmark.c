@@ -0,0 +1,264 @@
+/*
+ * MIDI Benchmark
+ * Synthetic MIDI load generator and event throughput measurement
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "audio/midi_benchmark.h"
+#include "audio/midi_processing.h"
+#include "audio/voice_manager.h"
+#include "audio/audio_params.h"
+
+typedef struct {
+    uint8_t status;
+    uint8_t data1;
+    uint8_t data2;
+} bench_message_t;
+
+typedef struct {
+    bench_message_t* messages;
+    uint8_t* bytes;
+    size_t* byte_offsets;         // Start of each message in bytes, plus the end
+    uint32_t* words;
+    uint32_t* latencies;
+    uint32_t count;
+} bench_load_t;
+
+static const volatile uint64_t* g_allocation_counter = NULL;
+
+static const char* const k_load_names[MIDI_LOAD_COUNT] = {
+    "chords", "cc_sweep", "pitch_bend_flood", "running_status", "mixed"
+};
+static const char* const k_path_names[MIDI_PATH_COUNT] = {"direct", "byte_stream", "ump"};
+
+// Controllers with a parameter mapping, so sweeps exercise the ramps
+static const uint8_t k_sweep_controllers[] = {1, 7, 10, 11, 71, 74};
+
+const char* midi_benchmark_load_name(midi_load_t load) {
+    return load < MIDI_LOAD_COUNT ? k_load_names[load] : "unknown";
+}
+
+const char* midi_benchmark_path_name(midi_path_t path) {
+    return path < MIDI_PATH_COUNT ? k_path_names[path] : "unknown";
+}
+
+void midi_benchmark_set_allocation_counter(const volatile uint64_t* counter) {
+    g_allocation_counter = counter;
+}
+
+static uint64_t allocation_count(void) {
+    return g_allocation_counter ? *g_allocation_counter : 0;
+}
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+// ---------------------------------------------------------------------------
+// Load generation
+// ---------------------------------------------------------------------------
+
+static bench_message_t chord_message(uint32_t i) {
+    static const uint8_t shape[8] = {0, 4, 7, 11, 12, 16, 19, 23};
+    uint32_t chord = i / 16;
+    uint32_t step = i % 16;
+    uint8_t channel = (uint8_t)(chord % 16);
+    uint8_t note = (uint8_t)(36 + (chord * 5) % 48 + shape[step % 8]);
+    bench_message_t message = {(uint8_t)((step < 8 ? MIDI_NOTE_ON : MIDI_NOTE_OFF) | channel), note,
+                               (uint8_t)(step < 8 ? 64 + (i % 64) : 0)};
+    return message;
+}
+
+static bench_message_t cc_message(uint32_t i) {
+    uint32_t sweep = i / 128;
+    bench_message_t message = {
+        (uint8_t)(MIDI_CONTROL_CHANGE | (sweep % 16)),
+        k_sweep_controllers[sweep % sizeof(k_sweep_controllers)],
+        (uint8_t)((sweep & 1) ? 127 - (i % 128) : i % 128)
+    };
+    return message;
+}
+
+static bench_message_t bend_message(uint32_t i) {
+    uint16_t value = (uint16_t)((i * 97u) & 0x3FFF);
+    bench_message_t message = {(uint8_t)(MIDI_PITCH_BEND | ((i / 256) % 16)), (uint8_t)(value & 0x7F),
+                               (uint8_t)(value >> 7)};
+    return message;
+}
+
+static bench_message_t generate_message(midi_load_t load, uint32_t i) {
+    switch (load) {
+        case MIDI_LOAD_CHORDS:
+            return chord_message(i);
+        case MIDI_LOAD_CC_SWEEP:
+            return cc_message(i);
+        case MIDI_LOAD_PITCH_BEND_FLOOD:
+            return bend_message(i);
+        case MIDI_LOAD_RUNNING_STATUS: {
+            // Long single-channel bursts so nearly every status byte is elided
+            bench_message_t message = cc_message(i);
+            message.status = (uint8_t)(MIDI_CONTROL_CHANGE | ((i / 1024) % 16));
+            return message;
+        }
+        default:
+            switch (i % 4) {
+                case 0:
+                    return chord_message(i / 4);
+                case 1:
+                case 2:
+                    return cc_message(i);
+                default:
+                    return bend_message(i);
+            }
+    }
+}
+
+static void free_load(bench_load_t* load) {
+    free(load->messages);
+    free(load->bytes);
+    free(load->byte_offsets);
+    free(load->words);
+    free(load->latencies);
+    memset(load, 0, sizeof(*load));
+}
+
+static int build_load(midi_load_t kind, uint32_t count, bench_load_t* load) {
+    memset(load, 0, sizeof(*load));
+    load->count = count;
+    load->messages = malloc(count * sizeof(bench_message_t));
+    load->bytes = malloc((size_t)count * 3);
+    load->byte_offsets = malloc(((size_t)count + 1) * sizeof(size_t));
+    load->words = malloc(count * sizeof(uint32_t));
+    load->latencies = malloc(count * sizeof(uint32_t));
+    if (!load->messages || !load->bytes || !load->byte_offsets || !load->words || !load->latencies) {
+        free_load(load);
+        return RETROSAGA_ERROR_AUDIO_INIT;
+    }
+
+    // Only the running-status load elides repeated status bytes on the wire
+    bool running_status = kind == MIDI_LOAD_RUNNING_STATUS;
+    uint8_t last_status = 0;
+    size_t length = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        bench_message_t message = generate_message(kind, i);
+        load->messages[i] = message;
+        load->byte_offsets[i] = length;
+        if (!running_status || message.status != last_status) {
+            load->bytes[length++] = message.status;
+        }
+        load->bytes[length++] = message.data1;
+        if ((message.status & 0xE0) != 0xC0) {
+            load->bytes[length++] = message.data2;
+        }
+        last_status = message.status;
+        load->words[i] = (UINT32_C(0x2) << 28) | ((uint32_t)message.status << 16) |
+                         ((uint32_t)message.data1 << 8) | message.data2;
+    }
+    load->byte_offsets[count] = length;
+    return RETROSAGA_SUCCESS;
+}
+
+// ---------------------------------------------------------------------------
+// Measurement
+// ---------------------------------------------------------------------------
+
+// Stand-in for the render thread draining at a sub-block boundary
+static void drain_events(midi_event_queue_t* queue) {
+    midi_event_t event;
+    while (midi_event_queue_pop(queue, &event)) {
+        voice_manager_apply_event(&event);
+    }
+}
+
+static int compare_latency(const void* a, const void* b) {
+    uint32_t x = *(const uint32_t*)a;
+    uint32_t y = *(const uint32_t*)b;
+    return (x > y) - (x < y);
+}
+
+static uint32_t percentile(const uint32_t* sorted, uint64_t count, double fraction) {
+    uint64_t index = (uint64_t)(fraction * (double)(count - 1) + 0.5);
+    return sorted[index];
+}
+
+int midi_benchmark_run(const midi_benchmark_config_t* config, midi_benchmark_result_t* result) {
+    if (!config || !result || config->load >= MIDI_LOAD_COUNT || config->path >= MIDI_PATH_COUNT ||
+        config->messages == 0) {
+        return RETROSAGA_ERROR_INVALID_PARAM;
+    }
+
+    midi_event_queue_t* queue = midi_processing_event_queue();
+    if (!queue) {
+        return RETROSAGA_ERROR_NOT_INITIALIZED;
+    }
+
+    bench_load_t load;
+    int status = build_load(config->load, config->messages, &load);
+    if (status != RETROSAGA_SUCCESS) {
+        return status;
+    }
+
+    // Chunks larger than the queue would measure drops, not throughput
+    uint32_t chunk = config->chunk_messages ? config->chunk_messages : 64;
+    if (chunk > MIDI_EVENT_QUEUE_CAPACITY) {
+        chunk = MIDI_EVENT_QUEUE_CAPACITY;
+    }
+
+    voice_manager_reset();
+    memset(result, 0, sizeof(*result));
+    uint64_t dropped = queue->dropped;
+    uint64_t allocations = allocation_count();
+    uint64_t events = 0;
+    uint64_t start = now_ns();
+
+    if (config->path == MIDI_PATH_DIRECT) {
+        for (uint32_t i = 0; i < load.count; i++) {
+            uint64_t t0 = now_ns();
+            process_midi_message(load.messages[i].status, load.messages[i].data1, load.messages[i].data2);
+            drain_events(queue);
+            uint64_t elapsed = now_ns() - t0;
+            load.latencies[events++] = elapsed > UINT32_MAX ? UINT32_MAX : (uint32_t)elapsed;
+        }
+    } else {
+        for (uint32_t first = 0; first < load.count; first += chunk) {
+            uint32_t messages = load.count - first < chunk ? load.count - first : chunk;
+            uint64_t t0 = now_ns();
+            if (config->path == MIDI_PATH_BYTE_STREAM) {
+                size_t begin = load.byte_offsets[first];
+                midi_processing_ingest_bytes(load.bytes + begin, load.byte_offsets[first + messages] - begin);
+            } else {
+                midi_processing_ingest_ump(load.words + first, messages);
+            }
+            drain_events(queue);
+            uint64_t elapsed = (now_ns() - t0) / messages;
+            for (uint32_t i = 0; i < messages; i++) {
+                load.latencies[events++] = elapsed > UINT32_MAX ? UINT32_MAX : (uint32_t)elapsed;
+            }
+        }
+    }
+
+    uint64_t total_ns = now_ns() - start;
+    result->allocations = allocation_count() - allocations;
+    result->dropped = queue->dropped - dropped;
+    result->events = events;
+    result->seconds = (double)total_ns / 1e9;
+    result->events_per_second = total_ns ? (double)events * 1e9 / (double)total_ns : 0.0;
+
+    qsort(load.latencies, events, sizeof(uint32_t), compare_latency);
+    result->latency_p50_ns = percentile(load.latencies, events, 0.50);
+    result->latency_p99_ns = percentile(load.latencies, events, 0.99);
+    result->latency_p999_ns = percentile(load.latencies, events, 0.999);
+    result->latency_max_ns = load.latencies[events - 1];
+
+    free_load(&load);
+    voice_manager_reset();
+    audio_params_reset();
+    return RETROSAGA_SUCCESS;
+}
@@ -0,0 +1,111 @@
+/*
+ * MIDI Event Queue
+ * High-resolution channel voice events between MIDI input and the renderer
+ */
+
+#include <string.h>
+#include "audio/midi_event.h"
+#include "audio/bit_scaler.h"
+
+#define QUEUE_MASK (MIDI_EVENT_QUEUE_CAPACITY - 1u)
+
+void midi_event_queue_reset(midi_event_queue_t* queue) {
+    __atomic_store_n(&queue->write_index, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&queue->read_index, 0, __ATOMIC_RELAXED);
+    queue->dropped = 0;
+}
+
+size_t midi_event_queue_push_batch(midi_event_queue_t* queue, const midi_event_t* events, size_t count) {
+    uint32_t write = queue->write_index;
+    uint32_t read = __atomic_load_n(&queue->read_index, __ATOMIC_ACQUIRE);
+    uint32_t space = MIDI_EVENT_QUEUE_CAPACITY - (write - read);
+    size_t accepted = count < space ? count : space;
+
+    for (size_t i = 0; i < accepted; i++) {
+        queue->events[(write + i) & QUEUE_MASK] = events[i];
+    }
+
+    // One release store publishes the whole batch
+    __atomic_store_n(&queue->write_index, write + (uint32_t)accepted, __ATOMIC_RELEASE);
+    queue->dropped += count - accepted;
+    return accepted;
+}
+
+bool midi_event_queue_push(midi_event_queue_t* queue, const midi_event_t* event) {
+    return midi_event_queue_push_batch(queue, event, 1) == 1;
+}
+
+bool midi_event_queue_pop(midi_event_queue_t* queue, midi_event_t* event) {
+    uint32_t read = queue->read_index;
+    uint32_t write = __atomic_load_n(&queue->write_index, __ATOMIC_ACQUIRE);
+    if (read == write) {
+        return false;
+    }
+
+    *event = queue->events[read & QUEUE_MASK];
+    __atomic_store_n(&queue->read_index, read + 1, __ATOMIC_RELEASE);
+    return true;
+}
+
+void midi_event_queue_discard(midi_event_queue_t* queue) {
+    uint32_t write = __atomic_load_n(&queue->write_index, __ATOMIC_ACQUIRE);
+    __atomic_store_n(&queue->read_index, write, __ATOMIC_RELEASE);
+}
+
+uint32_t midi_event_queue_depth(const midi_event_queue_t* queue) {
+    uint32_t write = __atomic_load_n(&queue->write_index, __ATOMIC_ACQUIRE);
+    uint32_t read = __atomic_load_n(&queue->read_index, __ATOMIC_ACQUIRE);
+    return write - read;
+}
+
+bool midi_event_from_midi1(uint8_t status, uint8_t data1, uint8_t data2, midi_event_t* event) {
+    memset(event, 0, sizeof(*event));
+    event->channel = status & 0x0F;
+    data1 &= 0x7F;
+    data2 &= 0x7F;
+
+    switch (status & 0xF0) {
+        case MIDI_NOTE_OFF:
+            event->type = MIDI_EVENT_NOTE_OFF;
+            event->note = data1;
+            event->velocity = (uint16_t)scale_midi_value_min_center_max(data2, 7, 16);
+            return true;
+
+        case MIDI_NOTE_ON:
+            // MIDI 1.0 velocity 0 is a note off; MIDI 2.0 keeps them distinct
+            event->type = data2 ? MIDI_EVENT_NOTE_ON : MIDI_EVENT_NOTE_OFF;
+            event->note = data1;
+            event->velocity = data2 ? (uint16_t)scale_midi_value_min_center_max(data2, 7, 16) : 0x8000;
+            return true;
+
+        case MIDI_POLY_PRESSURE:
+            event->type = MIDI_EVENT_POLY_PRESSURE;
+            event->note = data1;
+            event->value = scale_midi_value_min_center_max(data2, 7, 32);
+            return true;
+
+        case MIDI_CONTROL_CHANGE:
+            event->type = MIDI_EVENT_CONTROL_CHANGE;
+            event->index = data1;
+            event->value = scale_midi_value_min_center_max(data2, 7, 32);
+            return true;
+
+        case MIDI_PROGRAM_CHANGE:
+            event->type = MIDI_EVENT_PROGRAM_CHANGE;
+            event->value = data1;
+            return true;
+
+        case MIDI_CHANNEL_PRESSURE:
+            event->type = MIDI_EVENT_CHANNEL_PRESSURE;
+            event->value = scale_midi_value_min_center_max(data1, 7, 32);
+            return true;
+
+        case MIDI_PITCH_BEND:
+            event->type = MIDI_EVENT_PITCH_BEND;
+            event->value = scale_midi_value_min_center_max(((uint32_t)data2 << 7) | data1, 14, 32);
+            return true;
+
+        default:
+            return false;
+    }
+}
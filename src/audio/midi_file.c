@@ -0,0 +1,708 @@
+/*
+ * MIDI File Reader
+ * Streaming Standard MIDI File (SMF) playback
+ *
+ * Tracks stay in the mapped file; only one cursor per track is kept and
+ * the next event is chosen by a (tick, track) min-heap. Tick-to-sample
+ * conversion uses cached tempo segments, and periodic cursor checkpoints
+ * provide O(log n) seeking.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "audio/midi_file.h"
+
+#define MIDI_FILE_DEFAULT_TEMPO_US 500000
+
+typedef struct {
+    uint32_t pos;               // Offset of the pending event (after its delta)
+    uint32_t end;               // Offset one past the track chunk
+    uint64_t tick;              // Absolute tick of the pending event
+    uint8_t running_status;
+    uint8_t done;
+} track_cursor_t;
+
+typedef struct {
+    uint64_t tick;
+    double sample;
+    double samples_per_tick;
+} tempo_segment_t;
+
+typedef struct {
+    uint64_t tick;
+    uint64_t sample;
+} index_point_t;
+
+struct midi_file {
+    const uint8_t* data;
+    size_t size;
+    bool mapped;
+
+    uint32_t sample_rate;
+    uint16_t format;
+    uint16_t track_count;
+    uint16_t division;
+
+    // Streaming state
+    track_cursor_t* tracks;
+    track_cursor_t* track_origins;
+    uint16_t* heap;
+    uint16_t heap_size;
+    uint32_t tempo_cursor;
+
+    // Tempo map
+    tempo_segment_t* tempo_map;
+    uint32_t tempo_count;
+    uint32_t tempo_capacity;
+
+    // Sparse seek index: index_cursors holds track_count cursors per point
+    index_point_t* index;
+    track_cursor_t* index_cursors;
+    uint32_t index_count;
+    uint32_t index_capacity;
+
+    uint64_t total_ticks;
+    uint64_t total_samples;
+    uint32_t malformed_tracks;
+};
+
+// ---------------------------------------------------------------------------
+// Byte-level parsing
+// ---------------------------------------------------------------------------
+
+static uint32_t read_be32(const uint8_t* p) {
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+}
+
+static uint16_t read_be16(const uint8_t* p) {
+    return (uint16_t)((p[0] << 8) | p[1]);
+}
+
+static bool read_varlen(const uint8_t* data, uint32_t* pos, uint32_t end, uint32_t* value) {
+    uint32_t result = 0;
+    for (int i = 0; i < 4; i++) {
+        if (*pos >= end) {
+            return false;
+        }
+        uint8_t byte = data[(*pos)++];
+        result = (result << 7) | (byte & 0x7F);
+        if (!(byte & 0x80)) {
+            *value = result;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Decode the pending event of a track without committing; next receives
+// the cursor positioned at the following event
+static bool decode_event(const midi_file_t* reader, uint16_t track, const track_cursor_t* cursor,
+                         midi_file_event_t* event, track_cursor_t* next) {
+    const uint8_t* data = reader->data;
+    uint32_t pos = cursor->pos;
+    uint32_t end = cursor->end;
+
+    *next = *cursor;
+    memset(event, 0, sizeof(*event));
+    event->tick = cursor->tick;
+    event->track = track;
+
+    if (pos >= end) {
+        return false;
+    }
+
+    uint8_t status = data[pos];
+    if (status & 0x80) {
+        pos++;
+    } else if (cursor->running_status) {
+        status = cursor->running_status;
+    } else {
+        return false;
+    }
+    event->status = status;
+
+    if (status == 0xFF) {
+        uint32_t length;
+        if (pos >= end) {
+            return false;
+        }
+        event->data1 = data[pos++];
+        if (!read_varlen(data, &pos, end, &length) || length > end - pos) {
+            return false;
+        }
+        event->payload = data + pos;
+        event->payload_length = length;
+        pos += length;
+        next->running_status = 0;
+        if (event->data1 == MIDI_META_END_OF_TRACK) {
+            next->done = 1;
+        }
+    } else if (status == 0xF0 || status == 0xF7) {
+        uint32_t length;
+        if (!read_varlen(data, &pos, end, &length) || length > end - pos) {
+            return false;
+        }
+        event->payload = data + pos;
+        event->payload_length = length;
+        pos += length;
+        next->running_status = 0;
+    } else if (status > 0xF0) {
+        return false; // System common/real-time bytes are not valid in SMF tracks
+    } else {
+        uint32_t data_bytes = ((status & 0xE0) == 0xC0) ? 1 : 2;
+        if (data_bytes > end - pos) {
+            return false;
+        }
+        event->data1 = data[pos] & 0x7F;
+        event->data2 = (data_bytes == 2) ? (data[pos + 1] & 0x7F) : 0;
+        pos += data_bytes;
+        next->running_status = status;
+    }
+
+    if (!next->done) {
+        uint32_t delta;
+        if (pos >= end || !read_varlen(data, &pos, end, &delta)) {
+            next->done = 1; // Track ended without End Of Track
+        } else {
+            next->tick += delta;
+        }
+    }
+    next->pos = pos;
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// Track merge heap keyed by (tick, track)
+// ---------------------------------------------------------------------------
+
+static bool heap_less(const midi_file_t* reader, uint16_t a, uint16_t b) {
+    uint64_t tick_a = reader->tracks[a].tick;
+    uint64_t tick_b = reader->tracks[b].tick;
+    return (tick_a < tick_b) || (tick_a == tick_b && a < b);
+}
+
+static void heap_sift_down(midi_file_t* reader, uint16_t index) {
+    uint16_t* heap = reader->heap;
+    for (;;) {
+        uint32_t left = 2u * index + 1;
+        uint32_t right = left + 1;
+        uint32_t smallest = index;
+        if (left < reader->heap_size && heap_less(reader, heap[left], heap[smallest])) {
+            smallest = left;
+        }
+        if (right < reader->heap_size && heap_less(reader, heap[right], heap[smallest])) {
+            smallest = right;
+        }
+        if (smallest == index) {
+            return;
+        }
+        uint16_t tmp = heap[index];
+        heap[index] = heap[smallest];
+        heap[smallest] = tmp;
+        index = (uint16_t)smallest;
+    }
+}
+
+static void heap_rebuild(midi_file_t* reader) {
+    reader->heap_size = 0;
+    for (uint16_t t = 0; t < reader->track_count; t++) {
+        if (!reader->tracks[t].done) {
+            reader->heap[reader->heap_size++] = t;
+        }
+    }
+    for (int i = (int)reader->heap_size / 2 - 1; i >= 0; i--) {
+        heap_sift_down(reader, (uint16_t)i);
+    }
+}
+
+static void heap_pop_top(midi_file_t* reader) {
+    reader->heap[0] = reader->heap[--reader->heap_size];
+    if (reader->heap_size > 0) {
+        heap_sift_down(reader, 0);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Tempo map
+// ---------------------------------------------------------------------------
+
+static double samples_per_tick(const midi_file_t* reader, uint32_t tempo_us) {
+    if (reader->division & 0x8000) {
+        // SMPTE timing: ticks per second are fixed, tempo does not apply
+        int frames_per_second = -(int8_t)(reader->division >> 8);
+        int ticks_per_frame = reader->division & 0xFF;
+        return (double)reader->sample_rate / ((double)frames_per_second * ticks_per_frame);
+    }
+    return (double)tempo_us * 1e-6 * reader->sample_rate / reader->division;
+}
+
+static uint32_t find_tempo_segment(const midi_file_t* reader, uint64_t tick) {
+    uint32_t low = 0;
+    uint32_t high = reader->tempo_count;
+    while (high - low > 1) {
+        uint32_t mid = (low + high) / 2;
+        if (reader->tempo_map[mid].tick <= tick) {
+            low = mid;
+        } else {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+static uint64_t segment_sample(const tempo_segment_t* segment, uint64_t tick) {
+    return (uint64_t)llround(segment->sample + (double)(tick - segment->tick) * segment->samples_per_tick);
+}
+
+uint64_t midi_file_tick_to_sample(const midi_file_t* reader, uint64_t tick) {
+    return segment_sample(&reader->tempo_map[find_tempo_segment(reader, tick)], tick);
+}
+
+// Streaming conversion walks the cached segments forward instead of searching
+static uint64_t stream_tick_to_sample(midi_file_t* reader, uint64_t tick) {
+    while (reader->tempo_cursor + 1 < reader->tempo_count &&
+           reader->tempo_map[reader->tempo_cursor + 1].tick <= tick) {
+        reader->tempo_cursor++;
+    }
+    return segment_sample(&reader->tempo_map[reader->tempo_cursor], tick);
+}
+
+static int append_tempo(midi_file_t* reader, uint64_t tick, uint32_t tempo_us) {
+    tempo_segment_t* last = &reader->tempo_map[reader->tempo_count - 1];
+    double sample = last->sample + (double)(tick - last->tick) * last->samples_per_tick;
+
+    if (last->tick == tick) {
+        last->samples_per_tick = samples_per_tick(reader, tempo_us);
+        return RETROSAGA_SUCCESS;
+    }
+
+    if (reader->tempo_count == reader->tempo_capacity) {
+        uint32_t capacity = reader->tempo_capacity * 2;
+        tempo_segment_t* grown = realloc(reader->tempo_map, capacity * sizeof(tempo_segment_t));
+        if (!grown) {
+            return RETROSAGA_ERROR_AUDIO_INIT;
+        }
+        reader->tempo_map = grown;
+        reader->tempo_capacity = capacity;
+    }
+
+    tempo_segment_t* segment = &reader->tempo_map[reader->tempo_count++];
+    segment->tick = tick;
+    segment->sample = sample;
+    segment->samples_per_tick = samples_per_tick(reader, tempo_us);
+    return RETROSAGA_SUCCESS;
+}
+
+// ---------------------------------------------------------------------------
+// Open-time scan
+// ---------------------------------------------------------------------------
+
+static int parse_header(midi_file_t* reader) {
+    const uint8_t* data = reader->data;
+
+    if (reader->size < 14 || memcmp(data, "MThd", 4) != 0 || read_be32(data + 4) < 6) {
+        printf("[MIDI_FILE] ERROR: Missing MThd header\n");
+        return RETROSAGA_ERROR_INVALID_PARAM;
+    }
+
+    reader->format = read_be16(data + 8);
+    reader->track_count = read_be16(data + 10);
+    reader->division = read_be16(data + 12);
+    bool smpte_invalid = (reader->division & 0x8000) &&
+                         ((reader->division >> 8) == 0x80 || (reader->division & 0xFF) == 0);
+    if (reader->track_count == 0 || reader->division == 0 || reader->format > 2 || smpte_invalid) {
+        printf("[MIDI_FILE] ERROR: Unsupported header (format %d, %d tracks)\n",
+               reader->format, reader->track_count);
+        return RETROSAGA_ERROR_INVALID_PARAM;
+    }
+
+    reader->tracks = calloc(reader->track_count, sizeof(track_cursor_t));
+    reader->track_origins = calloc(reader->track_count, sizeof(track_cursor_t));
+    reader->heap = calloc(reader->track_count, sizeof(uint16_t));
+    if (!reader->tracks || !reader->track_origins || !reader->heap) {
+        return RETROSAGA_ERROR_AUDIO_INIT;
+    }
+
+    // Locate MTrk chunks, skipping unknown chunk types
+    uint32_t pos = 8 + read_be32(data + 4);
+    uint16_t found = 0;
+    while (found < reader->track_count && pos + 8 <= reader->size) {
+        uint32_t length = read_be32(data + pos + 4);
+        uint32_t body = pos + 8;
+        uint32_t end = (length > reader->size - body) ? (uint32_t)reader->size : body + length;
+
+        if (memcmp(data + pos, "MTrk", 4) == 0) {
+            track_cursor_t* origin = &reader->track_origins[found++];
+            origin->pos = body;
+            origin->end = end;
+            uint32_t delta;
+            if (!read_varlen(data, &origin->pos, end, &delta)) {
+                origin->done = 1;
+            } else {
+                origin->tick = delta;
+            }
+        }
+        pos = end;
+    }
+
+    for (uint16_t t = found; t < reader->track_count; t++) {
+        reader->track_origins[t].done = 1;
+        reader->malformed_tracks++;
+    }
+
+    return RETROSAGA_SUCCESS;
+}
+
+static void rewind_tracks(midi_file_t* reader) {
+    memcpy(reader->tracks, reader->track_origins, reader->track_count * sizeof(track_cursor_t));
+    reader->tempo_cursor = 0;
+    heap_rebuild(reader);
+}
+
+static int add_index_point(midi_file_t* reader, uint64_t tick, uint64_t sample) {
+    if (reader->index_count == reader->index_capacity) {
+        uint32_t capacity = reader->index_capacity ? reader->index_capacity * 2 : 16;
+        index_point_t* index = realloc(reader->index, capacity * sizeof(index_point_t));
+        if (!index) {
+            return RETROSAGA_ERROR_AUDIO_INIT;
+        }
+        reader->index = index;
+
+        track_cursor_t* cursors = realloc(reader->index_cursors,
+                                          (size_t)capacity * reader->track_count * sizeof(track_cursor_t));
+        if (!cursors) {
+            return RETROSAGA_ERROR_AUDIO_INIT;
+        }
+        reader->index_cursors = cursors;
+        reader->index_capacity = capacity;
+    }
+
+    reader->index[reader->index_count].tick = tick;
+    reader->index[reader->index_count].sample = sample;
+    memcpy(reader->index_cursors + (size_t)reader->index_count * reader->track_count,
+           reader->tracks, reader->track_count * sizeof(track_cursor_t));
+    reader->index_count++;
+    return RETROSAGA_SUCCESS;
+}
+
+// One merged pass builds the tempo map and seek checkpoints without
+// retaining any events
+static int scan_file(midi_file_t* reader) {
+    uint64_t interval = (uint64_t)reader->sample_rate * MIDI_FILE_INDEX_INTERVAL_MS / 1000;
+    uint64_t next_checkpoint = 0;
+
+    rewind_tracks(reader);
+
+    while (reader->heap_size > 0) {
+        uint16_t track = reader->heap[0];
+        track_cursor_t* cursor = &reader->tracks[track];
+
+        // Checkpoint the cursors before the first event past each interval
+        uint64_t sample = stream_tick_to_sample(reader, cursor->tick);
+        if (sample >= next_checkpoint) {
+            if (add_index_point(reader, cursor->tick, sample) != RETROSAGA_SUCCESS) {
+                return RETROSAGA_ERROR_AUDIO_INIT;
+            }
+            next_checkpoint = sample + interval;
+        }
+
+        midi_file_event_t event;
+        track_cursor_t next;
+        if (!decode_event(reader, track, cursor, &event, &next)) {
+            reader->malformed_tracks++;
+            cursor->done = 1;
+            heap_pop_top(reader);
+            continue;
+        }
+
+        if (event.tick > reader->total_ticks) {
+            reader->total_ticks = event.tick;
+        }
+        if (event.status == 0xFF && event.data1 == MIDI_META_SET_TEMPO && event.payload_length == 3) {
+            uint32_t tempo_us = ((uint32_t)event.payload[0] << 16) | ((uint32_t)event.payload[1] << 8) |
+                                event.payload[2];
+            if (tempo_us > 0 && append_tempo(reader, event.tick, tempo_us) != RETROSAGA_SUCCESS) {
+                return RETROSAGA_ERROR_AUDIO_INIT;
+            }
+        }
+
+        *cursor = next;
+        if (cursor->done) {
+            heap_pop_top(reader);
+        } else {
+            heap_sift_down(reader, 0);
+        }
+    }
+
+    if (reader->index_count == 0 && add_index_point(reader, 0, 0) != RETROSAGA_SUCCESS) {
+        return RETROSAGA_ERROR_AUDIO_INIT;
+    }
+
+    reader->total_samples = midi_file_tick_to_sample(reader, reader->total_ticks);
+    rewind_tracks(reader);
+    return RETROSAGA_SUCCESS;
+}
+
+static int finish_open(midi_file_t* reader, midi_file_t** out) {
+    reader->tempo_capacity = 8;
+    reader->tempo_map = malloc(reader->tempo_capacity * sizeof(tempo_segment_t));
+    if (!reader->tempo_map) {
+        midi_file_close(reader);
+        return RETROSAGA_ERROR_AUDIO_INIT;
+    }
+    reader->tempo_count = 1;
+    reader->tempo_map[0].tick = 0;
+    reader->tempo_map[0].sample = 0.0;
+
+    int result = parse_header(reader);
+    if (result == RETROSAGA_SUCCESS) {
+        reader->tempo_map[0].samples_per_tick = samples_per_tick(reader, MIDI_FILE_DEFAULT_TEMPO_US);
+        result = scan_file(reader);
+    }
+    if (result != RETROSAGA_SUCCESS) {
+        midi_file_close(reader);
+        return result;
+    }
+
+    if (reader->malformed_tracks > 0) {
+        printf("[MIDI_FILE] WARNING: %u malformed track(s) truncated\n", reader->malformed_tracks);
+    }
+
+    *out = reader;
+    return RETROSAGA_SUCCESS;
+}
+
+// ---------------------------------------------------------------------------
+// Public interface
+// ---------------------------------------------------------------------------
+
+int midi_file_open_memory(const uint8_t* data, size_t size, uint32_t sample_rate, midi_file_t** out) {
+    if (!data || !out || sample_rate == 0 || size > UINT32_MAX) {
+        return RETROSAGA_ERROR_INVALID_PARAM;
+    }
+
+    midi_file_t* reader = calloc(1, sizeof(midi_file_t));
+    if (!reader) {
+        return RETROSAGA_ERROR_AUDIO_INIT;
+    }
+    reader->data = data;
+    reader->size = size;
+    reader->sample_rate = sample_rate;
+
+    return finish_open(reader, out);
+}
+
+int midi_file_open(const char* path, uint32_t sample_rate, midi_file_t** out) {
+    if (!path || !out || sample_rate == 0) {
+        return RETROSAGA_ERROR_INVALID_PARAM;
+    }
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        printf("[MIDI_FILE] ERROR: Cannot open %s\n", path);
+        return RETROSAGA_ERROR_FILE_IO;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0 || (uint64_t)st.st_size > UINT32_MAX) {
+        close(fd);
+        return RETROSAGA_ERROR_FILE_IO;
+    }
+
+    void* mapping = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        printf("[MIDI_FILE] ERROR: Cannot map %s\n", path);
+        return RETROSAGA_ERROR_FILE_IO;
+    }
+    posix_madvise(mapping, (size_t)st.st_size, POSIX_MADV_WILLNEED);
+
+    midi_file_t* reader = calloc(1, sizeof(midi_file_t));
+    if (!reader) {
+        munmap(mapping, (size_t)st.st_size);
+        return RETROSAGA_ERROR_AUDIO_INIT;
+    }
+    reader->data = mapping;
+    reader->size = (size_t)st.st_size;
+    reader->mapped = true;
+    reader->sample_rate = sample_rate;
+
+    return finish_open(reader, out);
+}
+
+void midi_file_close(midi_file_t* reader) {
+    if (!reader) {
+        return;
+    }
+
+    if (reader->mapped) {
+        munmap((void*)reader->data, reader->size);
+    }
+    free(reader->tracks);
+    free(reader->track_origins);
+    free(reader->heap);
+    free(reader->tempo_map);
+    free(reader->index);
+    free(reader->index_cursors);
+    free(reader);
+}
+
+void midi_file_get_info(const midi_file_t* reader, midi_file_info_t* info) {
+    memset(info, 0, sizeof(*info));
+    info->format = reader->format;
+    info->track_count = reader->track_count;
+    info->division = reader->division;
+    info->total_ticks = reader->total_ticks;
+    info->total_samples = reader->total_samples;
+    info->tempo_changes = reader->tempo_count - 1;
+    info->index_points = reader->index_count;
+    info->malformed_tracks = reader->malformed_tracks;
+}
+
+bool midi_file_peek_event(midi_file_t* reader, midi_file_event_t* event) {
+    while (reader->heap_size > 0) {
+        uint16_t track = reader->heap[0];
+        track_cursor_t next;
+        if (decode_event(reader, track, &reader->tracks[track], event, &next)) {
+            event->sample = stream_tick_to_sample(reader, event->tick);
+            return true;
+        }
+        reader->tracks[track].done = 1;
+        heap_pop_top(reader);
+    }
+    return false;
+}
+
+bool midi_file_next_event(midi_file_t* reader, midi_file_event_t* event) {
+    while (reader->heap_size > 0) {
+        uint16_t track = reader->heap[0];
+        track_cursor_t* cursor = &reader->tracks[track];
+        track_cursor_t next;
+
+        if (!decode_event(reader, track, cursor, event, &next)) {
+            cursor->done = 1;
+            heap_pop_top(reader);
+            continue;
+        }
+
+        event->sample = stream_tick_to_sample(reader, event->tick);
+        *cursor = next;
+        if (cursor->done) {
+            heap_pop_top(reader);
+        } else {
+            heap_sift_down(reader, 0);
+        }
+        return true;
+    }
+    return false;
+}
+
+int midi_file_seek(midi_file_t* reader, uint64_t sample) {
+    if (!reader) {
+        return RETROSAGA_ERROR_INVALID_PARAM;
+    }
+
+    // Last checkpoint at or before the target
+    uint32_t low = 0;
+    uint32_t high = reader->index_count;
+    while (high - low > 1) {
+        uint32_t mid = (low + high) / 2;
+        if (reader->index[mid].sample <= sample) {
+            low = mid;
+        } else {
+            high = mid;
+        }
+    }
+
+    memcpy(reader->tracks, reader->index_cursors + (size_t)low * reader->track_count,
+           reader->track_count * sizeof(track_cursor_t));
+    reader->tempo_cursor = find_tempo_segment(reader, reader->index[low].tick);
+    heap_rebuild(reader);
+
+    // Walk forward inside the checkpoint interval
+    midi_file_event_t event;
+    while (midi_file_peek_event(reader, &event) && event.sample < sample) {
+        midi_file_next_event(reader, &event);
+    }
+
+    return RETROSAGA_SUCCESS;
+}
+
+int midi_file_dispatch(midi_file_t* reader, uint64_t end_sample) {
+    midi_file_event_t event;
+    int dispatched = 0;
+
+    while (midi_file_peek_event(reader, &event) && event.sample < end_sample) {
+        midi_file_next_event(reader, &event);
+        if (event.status < 0xF0) {
+            process_midi_message(event.status, event.data1, event.data2);
+            dispatched++;
+        }
+    }
+
+    return dispatched;
+}
+
+bool midi_file_validate(void) {
+    // Format 1, 96 PPQN. Track 0 doubles the tempo at tick 96 and uses
+    // running status; track 1 interleaves with track 0.
+    static const uint8_t song[] = {
+        'M', 'T', 'h', 'd', 0, 0, 0, 6, 0, 1, 0, 2, 0, 96,
+        'M', 'T', 'r', 'k', 0, 0, 0, 26,
+        0x00, 0xFF, 0x51, 0x03, 0x07, 0xA1, 0x20,   // tick 0: 500000 us/qn
+        0x00, 0x90, 60, 100,                        // tick 0: Note On
+        0x60, 0xFF, 0x51, 0x03, 0x03, 0xD0, 0x90,   // tick 96: 250000 us/qn
+        0x60, 0x80, 60, 0,                          // tick 192: Note Off
+        0x00, 0xFF, 0x2F, 0x00,
+        'M', 'T', 'r', 'k', 0, 0, 0, 11,
+        0x30, 0x91, 64, 90,                         // tick 48: Note On
+        0x30, 67, 90,                               // tick 96: running status
+        0x00, 0xFF, 0x2F, 0x00
+    };
+    static const uint64_t expected_ticks[] = {0, 0, 48, 96, 96, 96, 192, 192};
+    static const uint16_t expected_tracks[] = {0, 0, 1, 0, 1, 1, 0, 0};
+
+    midi_file_t* reader = NULL;
+    if (midi_file_open_memory(song, sizeof(song), 44100, &reader) != RETROSAGA_SUCCESS) {
+        printf("[MIDI_FILE] VALIDATION FAILED: Cannot parse test song\n");
+        return false;
+    }
+
+    bool valid = true;
+    midi_file_event_t event;
+    for (int i = 0; i < 8; i++) {
+        if (!midi_file_next_event(reader, &event) || event.tick != expected_ticks[i] ||
+            event.track != expected_tracks[i]) {
+            valid = false;
+            break;
+        }
+    }
+    valid &= !midi_file_next_event(reader, &event);
+
+    // 48 ticks at 120 BPM = 0.25 s; ticks 96..192 run at 240 BPM
+    valid &= (midi_file_tick_to_sample(reader, 48) == 11025);
+    valid &= (midi_file_tick_to_sample(reader, 192) == 33075);
+
+    midi_file_seek(reader, 22050);
+    valid &= midi_file_next_event(reader, &event) && event.tick == 96 && event.track == 0 &&
+             event.sample == 22050;
+    valid &= midi_file_next_event(reader, &event) && event.status == 0x91 && event.data1 == 67;
+
+    midi_file_close(reader);
+
+    if (!valid) {
+        printf("[MIDI_FILE] VALIDATION FAILED: Merge order, tempo map or seek incorrect\n");
+        return false;
+    }
+
+    printf("[MIDI_FILE] MIDI file reader validation passed\n");
+    return true;
+}
@@ -10,6 +10,8 @@
 #include <math.h>
 #include "audio/midi_processing.h"
 #include "audio/bit_scaler.h"
+#include "audio/midi_event.h"
+#include "audio/midi_ump.h"
 #include <string.h>
 #include <stdlib.h>
 
@@ -18,10 +20,33 @@ typedef struct {
     uint32_t messages_processed;
     uint8_t active_channels[16];
     float channel_volumes[16];
+    midi_ump_stats_t ump_stats;
+    midi_stream_parser_t byte_parser;
+    uint32_t sysex_received;
+    bool log_messages;
 } midi_processor_state_t;
 
 static midi_processor_state_t g_midi_state = {0};
 
+// Per-message trace, on by default; benchmarks switch it off
+#define MIDI_LOG(...) \
+    do { \
+        if (g_midi_state.log_messages) { \
+            printf("[MIDI_PROCESSING] " __VA_ARGS__); \
+        } \
+    } while (0)
+
+// Single producer (MIDI input) to single consumer (voice renderer)
+static midi_event_queue_t g_midi_events;
+static uint8_t g_sysex_buffer[MIDI_PROCESSING_SYSEX_CAPACITY];
+
+static void handle_sysex(const uint8_t* data, uint32_t length, bool truncated, void* user) {
+    (void)data;
+    (void)user;
+    g_midi_state.sysex_received++;
+    MIDI_LOG("SysEx: %u bytes%s\n", length, truncated ? " (truncated)" : "");
+}
+
 int midi_processing_init(void) {
     if (g_midi_state.initialized) {
         return RETROSAGA_ERROR_ALREADY_INITIALIZED;
@@ -36,6 +61,10 @@ int midi_processing_init(void) {
     }
     
     g_midi_state.messages_processed = 0;
+    midi_event_queue_reset(&g_midi_events);
+    midi_stream_parser_init(&g_midi_state.byte_parser, g_sysex_buffer, sizeof(g_sysex_buffer));
+    g_midi_state.byte_parser.on_sysex = handle_sysex;
+    g_midi_state.log_messages = true;
     g_midi_state.initialized = true;
     
     printf("[MIDI_PROCESSING] MIDI processor initialized successfully\n");
@@ -54,16 +83,16 @@ int process_midi_message(uint8_t status, uint8_t data1, uint8_t data2) {
     switch (message_type) {
         case MIDI_NOTE_ON:
             if (data2 > 0) { // Velocity > 0 means note on
-                printf("[MIDI_PROCESSING] Note ON: Ch %d, Note %d, Vel %d\n", 
-                       channel + 1, data1, data2);
+                MIDI_LOG("Note ON: Ch %d, Note %d, Vel %d\n", 
+                         channel + 1, data1, data2);
                 g_midi_state.active_channels[channel]++;
                 
                 // Scale velocity from 7-bit to 16-bit using Min-Center-Max scaling
                 uint32_t scaled_velocity = scale_midi_value_min_center_max(data2, 7, 16);
-                printf("[MIDI_PROCESSING] Scaled velocity: %d -> %d\n", data2, scaled_velocity);
+                MIDI_LOG("Scaled velocity: %d -> %d\n", data2, scaled_velocity);
             } else {
                 // Velocity 0 means note off
-                printf("[MIDI_PROCESSING] Note OFF: Ch %d, Note %d\n", channel + 1, data1);
+                MIDI_LOG("Note OFF: Ch %d, Note %d\n", channel + 1, data1);
                 if (g_midi_state.active_channels[channel] > 0) {
                     g_midi_state.active_channels[channel]--;
                 }
@@ -71,43 +100,189 @@ int process_midi_message(uint8_t status, uint8_t data1, uint8_t data2) {
             break;
             
         case MIDI_NOTE_OFF:
-            printf("[MIDI_PROCESSING] Note OFF: Ch %d, Note %d, Vel %d\n", 
-                   channel + 1, data1, data2);
+            MIDI_LOG("Note OFF: Ch %d, Note %d, Vel %d\n", 
+                     channel + 1, data1, data2);
             if (g_midi_state.active_channels[channel] > 0) {
                 g_midi_state.active_channels[channel]--;
             }
             break;
             
         case MIDI_CONTROL_CHANGE:
-            printf("[MIDI_PROCESSING] Control Change: Ch %d, CC %d, Val %d\n", 
+            MIDI_LOG("Control Change: Ch %d, CC %d, Val %d\n", 
                    channel + 1, data1, data2);
                    
             // Handle volume control (CC 7)
             if (data1 == 7) {
                 g_midi_state.channel_volumes[channel] = (float)data2 / 127.0f;
-                printf("[MIDI_PROCESSING] Channel %d volume: %.2f\n", 
+                MIDI_LOG("Channel %d volume: %.2f\n", 
                        channel + 1, g_midi_state.channel_volumes[channel]);
             }
+            
+            if (data1 == 120 || data1 == 123) {
+                g_midi_state.active_channels[channel] = 0;
+            }
+            break;
+            
+        case MIDI_PROGRAM_CHANGE:
+            MIDI_LOG("Program Change: Ch %d, Program %d\n", channel + 1, data1);
             break;
             
         case MIDI_PITCH_BEND:
             {
                 // Combine 7-bit values into 14-bit pitch bend
                 uint16_t pitch_bend = (data2 << 7) | data1;
-                printf("[MIDI_PROCESSING] Pitch Bend: Ch %d, Value %d\n", 
+                MIDI_LOG("Pitch Bend: Ch %d, Value %d\n", 
                        channel + 1, pitch_bend);
             }
             break;
             
         default:
-            printf("[MIDI_PROCESSING] Unsupported message type: 0x%02X\n", message_type);
+            MIDI_LOG("Unsupported message type: 0x%02X\n", message_type);
             break;
     }
     
+    // Upconvert once here; the voice path only sees 16/32-bit values. A
+    // full queue counts the drop, reported at shutdown, rather than
+    // logging from the producer while it is already behind.
+    midi_event_t event;
+    if (midi_event_from_midi1(status, data1, data2, &event)) {
+        midi_event_queue_push(&g_midi_events, &event);
+    }
+    
     g_midi_state.messages_processed++;
     return RETROSAGA_SUCCESS;
 }
 
+size_t midi_processing_ingest_ump(const uint32_t* words, size_t word_count) {
+    if (!g_midi_state.initialized || !words) {
+        return 0;
+    }
+    
+    uint64_t packets = g_midi_state.ump_stats.packets;
+    size_t consumed = midi_ump_ingest(words, word_count, &g_midi_events, &g_midi_state.ump_stats);
+    g_midi_state.messages_processed += (uint32_t)(g_midi_state.ump_stats.packets - packets);
+    return consumed;
+}
+
+size_t midi_processing_ingest_bytes(const uint8_t* bytes, size_t count) {
+    if (!g_midi_state.initialized || !bytes) {
+        return 0;
+    }
+    
+    midi_stream_parser_t* parser = &g_midi_state.byte_parser;
+    uint64_t before = parser->stats.channel_messages + parser->stats.system_messages + parser->stats.sysex_messages;
+    size_t produced = midi_stream_parse(parser, bytes, count, &g_midi_events);
+    uint64_t after = parser->stats.channel_messages + parser->stats.system_messages + parser->stats.sysex_messages;
+    g_midi_state.messages_processed += (uint32_t)(after - before);
+    return produced;
+}
+
+void midi_processing_set_logging(bool enabled) {
+    g_midi_state.log_messages = enabled;
+}
+
+midi_event_queue_t* midi_processing_event_queue(void) {
+    return g_midi_state.initialized ? &g_midi_events : NULL;
+}
+
+// ---------------------------------------------------------------------------
+// Snapshots
+// ---------------------------------------------------------------------------
+
+#define MIDI_SNAPSHOT_TAG AUDIO_SNAPSHOT_TAG('M', 'I', 'D', 'I')
+
+// The byte parser's message in progress; buffers and callbacks stay put
+typedef struct {
+    uint8_t status;
+    uint8_t data[2];
+    uint8_t data_count;
+    uint8_t data_expected;
+    bool in_sysex;
+    bool sysex_overflow;
+    uint32_t sysex_length;
+} midi_parser_snapshot_t;
+
+void midi_processing_snapshot_save(audio_snapshot_stream_t* stream) {
+    const midi_stream_parser_t* parser = &g_midi_state.byte_parser;
+    midi_parser_snapshot_t message = {
+        .status = parser->status,
+        .data = {parser->data[0], parser->data[1]},
+        .data_count = parser->data_count,
+        .data_expected = parser->data_expected,
+        .in_sysex = parser->in_sysex,
+        .sysex_overflow = parser->sysex_overflow,
+        .sysex_length = parser->sysex_length,
+    };
+
+    audio_snapshot_begin_section(stream, MIDI_SNAPSHOT_TAG, sizeof(midi_event_t));
+    audio_snapshot_put(stream, g_midi_state.active_channels, sizeof(g_midi_state.active_channels));
+    audio_snapshot_put(stream, g_midi_state.channel_volumes, sizeof(g_midi_state.channel_volumes));
+    audio_snapshot_put(stream, &message, sizeof(message));
+    audio_snapshot_put(stream, parser->sysex, message.sysex_length);
+
+    // Queued events belong to the state they will be applied to
+    uint32_t read = __atomic_load_n(&g_midi_events.read_index, __ATOMIC_ACQUIRE);
+    uint32_t pending = midi_event_queue_depth(&g_midi_events);
+    audio_snapshot_put(stream, &pending, sizeof(pending));
+    for (uint32_t i = 0; i < pending; i++) {
+        audio_snapshot_put(stream, &g_midi_events.events[(read + i) & (MIDI_EVENT_QUEUE_CAPACITY - 1)],
+                           sizeof(midi_event_t));
+    }
+}
+
+bool midi_processing_snapshot_restore(audio_snapshot_stream_t* stream) {
+    if (!audio_snapshot_expect_section(stream, MIDI_SNAPSHOT_TAG, sizeof(midi_event_t))) {
+        return false;
+    }
+    const void* active_channels = audio_snapshot_view(stream, sizeof(g_midi_state.active_channels));
+    const void* channel_volumes = audio_snapshot_view(stream, sizeof(g_midi_state.channel_volumes));
+    midi_parser_snapshot_t message;
+    if (!active_channels || !channel_volumes || !audio_snapshot_get(stream, &message, sizeof(message))) {
+        return false;
+    }
+    if (message.sysex_length > g_midi_state.byte_parser.sysex_capacity) {
+        return audio_snapshot_refuse(stream, "SysEx message longer than the parser buffer");
+    }
+    const void* sysex = audio_snapshot_view(stream, message.sysex_length);
+    uint32_t pending = 0;
+    if ((message.sysex_length && !sysex) || !audio_snapshot_get(stream, &pending, sizeof(pending))) {
+        return false;
+    }
+    if (pending > MIDI_EVENT_QUEUE_CAPACITY) {
+        return audio_snapshot_refuse(stream, "More queued MIDI events than the queue holds");
+    }
+    const uint8_t* events = audio_snapshot_view(stream, (size_t)pending * sizeof(midi_event_t));
+    if (pending && !events) {
+        return false;
+    }
+
+    if (stream->apply) {
+        memcpy(g_midi_state.active_channels, active_channels, sizeof(g_midi_state.active_channels));
+        memcpy(g_midi_state.channel_volumes, channel_volumes, sizeof(g_midi_state.channel_volumes));
+
+        midi_stream_parser_t* parser = &g_midi_state.byte_parser;
+        parser->status = message.status;
+        parser->data[0] = message.data[0];
+        parser->data[1] = message.data[1];
+        parser->data_count = message.data_count;
+        parser->data_expected = message.data_expected;
+        parser->in_sysex = message.in_sysex;
+        parser->sysex_overflow = message.sysex_overflow;
+        parser->sysex_length = message.sysex_length;
+        if (message.sysex_length) {
+            memcpy(parser->sysex, sysex, message.sysex_length);
+        }
+
+        midi_event_queue_discard(&g_midi_events);
+        for (uint32_t i = 0; i < pending; i++) {
+            midi_event_t event;
+            memcpy(&event, events + (size_t)i * sizeof(event), sizeof(event));
+            midi_event_queue_push(&g_midi_events, &event);
+        }
+    }
+    return true;
+}
+
 int midi_processing_process(void) {
     if (!g_midi_state.initialized) {
         return RETROSAGA_ERROR_NOT_INITIALIZED;
@@ -126,6 +301,12 @@ void midi_processing_shutdown(void) {
     
     printf("[MIDI_PROCESSING] Shutting down MIDI processor...\n");
     printf("[MIDI_PROCESSING] Total messages processed: %d\n", g_midi_state.messages_processed);
+    printf("[MIDI_PROCESSING] UMP packets: %lu, events: %lu, dropped: %lu\n",
+           (unsigned long)g_midi_state.ump_stats.packets, (unsigned long)g_midi_state.ump_stats.events,
+           (unsigned long)g_midi_events.dropped);
+    printf("[MIDI_PROCESSING] Stream bytes: %lu, SysEx: %u, stray bytes: %lu\n",
+           (unsigned long)g_midi_state.byte_parser.stats.bytes, g_midi_state.sysex_received,
+           (unsigned long)g_midi_state.byte_parser.stats.stray_bytes);
     
     memset(&g_midi_state, 0, sizeof(g_midi_state));
     printf("[MIDI_PROCESSING] MIDI processor shutdown complete\n");
@@ -137,6 +318,16 @@ bool midi_processing_validate(void) {
         return false;
     }
     
+    if (!midi_ump_self_test()) {
+        printf("[MIDI_PROCESSING] VALIDATION FAILED: UMP parser\n");
+        return false;
+    }
+    
+    if (!midi_stream_self_test()) {
+        printf("[MIDI_PROCESSING] VALIDATION FAILED: Byte stream parser\n");
+        return false;
+    }
+    
     printf("[MIDI_PROCESSING] MIDI processor validation passed\n");
     return true;
 }
@@ -0,0 +1,235 @@
+/*
+ * MIDI Byte Stream Parser
+ * Incremental parsing of raw serial/USB MIDI 1.0 byte streams
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "audio/midi_stream.h"
+
+#define STREAM_EVENT_BATCH 64
+
+// Data bytes following each status; channel messages by high nibble,
+// system common by low nibble (F0 and F7 are handled as SysEx framing)
+static const uint8_t k_channel_data[8] = {2, 2, 2, 2, 1, 1, 2, 0};
+static const uint8_t k_system_data[8] = {0, 1, 2, 1, 0, 0, 0, 0};
+
+typedef struct {
+    midi_event_t events[STREAM_EVENT_BATCH];
+    size_t count;
+    size_t produced;
+} event_batch_t;
+
+static void flush_batch(midi_stream_parser_t* parser, event_batch_t* batch, midi_event_queue_t* queue) {
+    if (batch->count == 0) {
+        return;
+    }
+    size_t pushed = queue ? midi_event_queue_push_batch(queue, batch->events, batch->count) : 0;
+    parser->stats.dropped += batch->count - pushed;
+    batch->produced += batch->count;
+    batch->count = 0;
+}
+
+int midi_stream_parser_init(midi_stream_parser_t* parser, uint8_t* sysex_buffer, uint32_t sysex_capacity) {
+    if (!parser || (sysex_capacity > 0 && !sysex_buffer)) {
+        return RETROSAGA_ERROR_INVALID_PARAM;
+    }
+
+    memset(parser, 0, sizeof(*parser));
+    parser->sysex = sysex_buffer;
+    parser->sysex_capacity = sysex_capacity;
+    return RETROSAGA_SUCCESS;
+}
+
+void midi_stream_parser_reset(midi_stream_parser_t* parser) {
+    parser->status = 0;
+    parser->data_count = 0;
+    parser->data_expected = 0;
+    parser->in_sysex = false;
+    parser->sysex_length = 0;
+    parser->sysex_overflow = false;
+}
+
+static void end_sysex(midi_stream_parser_t* parser) {
+    parser->in_sysex = false;
+    parser->stats.sysex_messages++;
+    if (parser->sysex_overflow) {
+        parser->stats.sysex_truncated++;
+    }
+    if (parser->on_sysex) {
+        parser->on_sysex(parser->sysex, parser->sysex_length, parser->sysex_overflow, parser->user);
+    }
+    parser->sysex_length = 0;
+    parser->sysex_overflow = false;
+}
+
+static void begin_status(midi_stream_parser_t* parser, uint8_t status) {
+    // Any status other than real-time terminates a SysEx in progress
+    if (parser->in_sysex) {
+        end_sysex(parser);
+    }
+
+    parser->data_count = 0;
+    if (status < 0xF0) {
+        parser->status = status;
+        parser->data_expected = k_channel_data[(status >> 4) & 0x07];
+        return;
+    }
+
+    // System common cancels running status
+    parser->status = 0;
+    if (status == MIDI_SYSEX_START) {
+        parser->in_sysex = true;
+        parser->sysex_length = 0;
+        parser->sysex_overflow = false;
+    } else if (status != MIDI_SYSEX_END) {
+        parser->data_expected = k_system_data[status & 0x07];
+        if (parser->data_expected == 0) {
+            parser->stats.system_messages++;
+        } else {
+            parser->status = status;
+        }
+    }
+}
+
+size_t midi_stream_parse(midi_stream_parser_t* parser, const uint8_t* bytes, size_t count,
+                         midi_event_queue_t* queue) {
+    event_batch_t batch;
+    batch.count = 0;
+    batch.produced = 0;
+
+    for (size_t i = 0; i < count; i++) {
+        uint8_t byte = bytes[i];
+
+        // Data bytes are the common case: complete or extend a message
+        if (byte < 0x80) {
+            if (parser->in_sysex) {
+                if (parser->sysex_length < parser->sysex_capacity) {
+                    parser->sysex[parser->sysex_length++] = byte;
+                } else {
+                    parser->sysex_overflow = true;
+                }
+                continue;
+            }
+            if (parser->status == 0) {
+                parser->stats.stray_bytes++;
+                continue;
+            }
+
+            parser->data[parser->data_count++] = byte;
+            if (parser->data_count < parser->data_expected) {
+                continue;
+            }
+            parser->data_count = 0;
+
+            if (parser->status >= 0xF0) {
+                parser->status = 0;
+                parser->stats.system_messages++;
+                continue;
+            }
+
+            uint8_t data2 = parser->data_expected == 2 ? parser->data[1] : 0;
+            if (midi_event_from_midi1(parser->status, parser->data[0], data2, &batch.events[batch.count])) {
+                parser->stats.channel_messages++;
+                if (++batch.count == STREAM_EVENT_BATCH) {
+                    flush_batch(parser, &batch, queue);
+                }
+            }
+            continue;
+        }
+
+        // Real-time bytes may appear anywhere, even inside SysEx
+        if (byte >= MIDI_REALTIME_FIRST) {
+            parser->stats.realtime_messages++;
+            if (parser->on_realtime) {
+                parser->on_realtime(byte, parser->user);
+            }
+            continue;
+        }
+
+        begin_status(parser, byte);
+    }
+
+    flush_batch(parser, &batch, queue);
+    parser->stats.bytes += count;
+    return batch.produced;
+}
+
+// ---------------------------------------------------------------------------
+// Self test
+// ---------------------------------------------------------------------------
+
+typedef struct {
+    uint32_t sysex_count;
+    uint32_t sysex_length;
+    bool sysex_truncated;
+    uint32_t realtime_count;
+} stream_test_sink_t;
+
+static void test_sysex(const uint8_t* data, uint32_t length, bool truncated, void* user) {
+    stream_test_sink_t* sink = user;
+    sink->sysex_count++;
+    sink->sysex_length = length;
+    sink->sysex_truncated = truncated;
+    (void)data;
+}
+
+static void test_realtime(uint8_t status, void* user) {
+    stream_test_sink_t* sink = user;
+    sink->realtime_count++;
+    (void)status;
+}
+
+bool midi_stream_self_test(void) {
+    static const uint8_t stream[] = {
+        0x05,                           // Stray data before any status
+        0x90, 60, 100,                  // Note on
+        62, 0xF8, 100,                  // Running status, clock mid-message
+        64, 0,                          // Running status, velocity 0 -> note off
+        0xF0, 0x7E, 0x7F, 0xF8, 0x09, 0x01, 0xF7,   // SysEx with clock inside
+        0xB1, 7,                        // CC split across calls...
+        0x7F,                           // ...completed in the second buffer
+        0xF2, 0x10, 0x20,               // Song position cancels running status
+        0x22,                           // Stray
+        0xF0, 1, 2, 3, 4, 5, 6,         // SysEx longer than the buffer,
+        0xE0, 0x00, 0x40                // ended by the next status
+    };
+    const size_t split = 18;
+
+    uint8_t sysex[4];
+    stream_test_sink_t sink = {0};
+    midi_stream_parser_t parser;
+    midi_event_queue_t* queue = malloc(sizeof(*queue));
+    if (!queue || midi_stream_parser_init(&parser, sysex, sizeof(sysex)) != RETROSAGA_SUCCESS) {
+        free(queue);
+        return false;
+    }
+    midi_event_queue_reset(queue);
+    parser.on_sysex = test_sysex;
+    parser.on_realtime = test_realtime;
+    parser.user = &sink;
+
+    size_t produced = midi_stream_parse(&parser, stream, split, queue);
+    produced += midi_stream_parse(&parser, stream + split, sizeof(stream) - split, queue);
+
+    midi_event_t events[5];
+    uint32_t popped = 0;
+    while (popped < 5 && midi_event_queue_pop(queue, &events[popped])) {
+        popped++;
+    }
+
+    bool valid = produced == 5 && popped == 5 && midi_event_queue_depth(queue) == 0;
+    valid &= events[0].type == MIDI_EVENT_NOTE_ON && events[0].note == 60;
+    valid &= events[1].type == MIDI_EVENT_NOTE_ON && events[1].note == 62;
+    valid &= events[2].type == MIDI_EVENT_NOTE_OFF && events[2].note == 64;
+    valid &= events[3].type == MIDI_EVENT_CONTROL_CHANGE && events[3].channel == 1 && events[3].index == 7 &&
+             events[3].value == 0xFFFFFFFFu;
+    valid &= events[4].type == MIDI_EVENT_PITCH_BEND && events[4].value == MIDI_EVENT_CENTER_32;
+    valid &= sink.realtime_count == 2 && sink.sysex_count == 2 && sink.sysex_length == 4 && sink.sysex_truncated;
+    valid &= parser.stats.stray_bytes == 2 && parser.stats.system_messages == 1 &&
+             parser.stats.sysex_truncated == 1 && parser.stats.bytes == sizeof(stream);
+
+    free(queue);
+    return valid;
+}
@@ -0,0 +1,211 @@
+/*
+ * MIDI UMP Parser
+ * Universal MIDI Packet ingestion
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "audio/midi_ump.h"
+
+#define UMP_INGEST_BATCH 64
+
+// Packet sizes in words by message type (UMP 1.1 table 4)
+static const uint8_t k_packet_words[16] = {1, 1, 1, 2, 2, 4, 1, 1, 2, 2, 2, 3, 3, 4, 4, 4};
+
+// MIDI 2.0 channel voice opcodes
+enum {
+    UMP_REGISTERED_PER_NOTE = 0x0,
+    UMP_ASSIGNABLE_PER_NOTE = 0x1,
+    UMP_PER_NOTE_PITCH_BEND = 0x6,
+    UMP_NOTE_OFF = 0x8,
+    UMP_NOTE_ON = 0x9,
+    UMP_POLY_PRESSURE = 0xA,
+    UMP_CONTROL_CHANGE = 0xB,
+    UMP_PROGRAM_CHANGE = 0xC,
+    UMP_CHANNEL_PRESSURE = 0xD,
+    UMP_PITCH_BEND = 0xE,
+    UMP_PER_NOTE_MANAGEMENT = 0xF
+};
+
+uint32_t midi_ump_packet_words(uint32_t first_word) {
+    return k_packet_words[first_word >> 28];
+}
+
+static bool parse_midi2_voice(uint32_t word0, uint32_t word1, midi_event_t* event) {
+    memset(event, 0, sizeof(*event));
+    event->channel = (word0 >> 16) & 0x0F;
+    event->note = (word0 >> 8) & 0x7F;
+    event->index = word0 & 0xFF;
+    event->value = word1;
+
+    switch ((word0 >> 20) & 0x0F) {
+        case UMP_NOTE_OFF:
+        case UMP_NOTE_ON:
+            event->type = ((word0 >> 20) & 0x0F) == UMP_NOTE_ON ? MIDI_EVENT_NOTE_ON : MIDI_EVENT_NOTE_OFF;
+            event->velocity = (uint16_t)(word1 >> 16);
+            // A MIDI 2.0 note on with velocity 0 is still a note on
+            if (event->type == MIDI_EVENT_NOTE_ON && event->velocity == 0) {
+                event->velocity = 1;
+            }
+            event->attribute = (uint16_t)(word1 & 0xFFFF);
+            event->value = 0;
+            return true;
+
+        case UMP_POLY_PRESSURE:
+            event->type = MIDI_EVENT_POLY_PRESSURE;
+            return true;
+
+        case UMP_CONTROL_CHANGE:
+            event->type = MIDI_EVENT_CONTROL_CHANGE;
+            event->index = (word0 >> 8) & 0x7F;
+            event->note = 0;
+            return true;
+
+        case UMP_PROGRAM_CHANGE:
+            event->type = MIDI_EVENT_PROGRAM_CHANGE;
+            event->note = 0;
+            event->index = 0;
+            event->value = (word1 >> 24) & 0x7F;
+            return true;
+
+        case UMP_CHANNEL_PRESSURE:
+            event->type = MIDI_EVENT_CHANNEL_PRESSURE;
+            event->note = 0;
+            event->index = 0;
+            return true;
+
+        case UMP_PITCH_BEND:
+            event->type = MIDI_EVENT_PITCH_BEND;
+            event->note = 0;
+            event->index = 0;
+            return true;
+
+        case UMP_REGISTERED_PER_NOTE:
+            event->type = MIDI_EVENT_PER_NOTE_CONTROL;
+            return true;
+
+        case UMP_PER_NOTE_PITCH_BEND:
+            event->type = MIDI_EVENT_PER_NOTE_PITCH_BEND;
+            event->index = 0;
+            return true;
+
+        case UMP_PER_NOTE_MANAGEMENT:
+            event->type = MIDI_EVENT_PER_NOTE_MANAGEMENT;
+            event->attribute = word0 & 0xFF;
+            event->index = 0;
+            event->value = 0;
+            return true;
+
+        default:
+            // Assignable per-note controllers, RPN/NRPN
+            return false;
+    }
+}
+
+size_t midi_ump_parse(const uint32_t* words, size_t word_count, midi_event_t* events,
+                      size_t max_events, size_t* event_count, midi_ump_stats_t* stats) {
+    size_t position = 0;
+    size_t produced = 0;
+
+    while (position < word_count && produced < max_events) {
+        uint32_t word0 = words[position];
+        uint32_t size = k_packet_words[word0 >> 28];
+        if (position + size > word_count) {
+            break;
+        }
+
+        bool emitted = false;
+        switch (word0 >> 28) {
+            case UMP_TYPE_MIDI1_VOICE:
+                emitted = midi_event_from_midi1((uint8_t)(word0 >> 16), (uint8_t)(word0 >> 8), (uint8_t)word0,
+                                                &events[produced]);
+                break;
+            case UMP_TYPE_MIDI2_VOICE:
+                emitted = parse_midi2_voice(word0, words[position + 1], &events[produced]);
+                break;
+            default:
+                break;
+        }
+
+        if (emitted) {
+            produced++;
+        } else if (stats) {
+            stats->skipped++;
+        }
+        if (stats) {
+            stats->packets++;
+        }
+        position += size;
+    }
+
+    if (stats) {
+        stats->events += produced;
+    }
+    *event_count = produced;
+    return position;
+}
+
+size_t midi_ump_ingest(const uint32_t* words, size_t word_count, midi_event_queue_t* queue,
+                       midi_ump_stats_t* stats) {
+    midi_event_t batch[UMP_INGEST_BATCH];
+    size_t position = 0;
+
+    while (position < word_count) {
+        size_t produced = 0;
+        size_t consumed = midi_ump_parse(words + position, word_count - position, batch,
+                                         UMP_INGEST_BATCH, &produced, stats);
+        if (consumed == 0) {
+            break;
+        }
+
+        size_t pushed = midi_event_queue_push_batch(queue, batch, produced);
+        if (stats) {
+            stats->dropped += produced - pushed;
+        }
+        position += consumed;
+    }
+    return position;
+}
+
+// ---------------------------------------------------------------------------
+// Self test
+// ---------------------------------------------------------------------------
+
+bool midi_ump_self_test(void) {
+    static const uint32_t stream[] = {
+        0x00100000,                 // Utility NOOP
+        0x40913C00, 0xFFFF0000,     // MIDI 2.0 note on ch1 note 60, velocity 0xFFFF
+        0x20B10740,                 // MIDI 1.0 CC7 = 64 on ch1
+        0x40B14A00, 0x12345678,     // MIDI 2.0 CC74, 32-bit value
+        0x40613C00, 0x90000000,     // Per-note pitch bend on note 60
+        0x50000000, 0, 0, 0,        // 128-bit data packet, skipped
+        0x40E10000, 0x80000000,     // Pitch bend centre
+        0x40813C00, 0x00010000,     // Note off, velocity 1
+        0x40913C00                  // Partial packet left for the next call
+    };
+    const size_t word_count = sizeof(stream) / sizeof(stream[0]);
+
+    midi_event_t events[8];
+    size_t produced = 0;
+    midi_ump_stats_t stats = {0};
+    size_t consumed = midi_ump_parse(stream, word_count, events, 8, &produced, &stats);
+
+    bool valid = consumed == word_count - 1 && produced == 6 && stats.skipped == 2;
+    valid &= events[0].type == MIDI_EVENT_NOTE_ON && events[0].channel == 1 && events[0].note == 60 &&
+             events[0].velocity == 0xFFFF;
+    valid &= events[1].type == MIDI_EVENT_CONTROL_CHANGE && events[1].index == 7 &&
+             events[1].value == MIDI_EVENT_CENTER_32;
+    valid &= events[2].type == MIDI_EVENT_CONTROL_CHANGE && events[2].index == 74 && events[2].value == 0x12345678;
+    valid &= events[3].type == MIDI_EVENT_PER_NOTE_PITCH_BEND && events[3].note == 60;
+    valid &= events[4].type == MIDI_EVENT_PITCH_BEND && events[4].value == MIDI_EVENT_CENTER_32;
+    valid &= events[5].type == MIDI_EVENT_NOTE_OFF && events[5].velocity == 1;
+
+    // MIDI 1.0 extremes map onto the full 32-bit range
+    midi_event_t event;
+    valid &= midi_event_from_midi1(MIDI_CONTROL_CHANGE, 1, 127, &event) && event.value == 0xFFFFFFFFu;
+    valid &= midi_event_from_midi1(MIDI_PITCH_BEND, 0, 64, &event) && event.value == MIDI_EVENT_CENTER_32;
+    valid &= midi_event_from_midi1(MIDI_NOTE_ON, 60, 0, &event) && event.type == MIDI_EVENT_NOTE_OFF;
+
+    return valid;
+}
@@ -0,0 +1,70 @@
+/*
+ * Pitch Table
+ * Note-to-increment tables and a fast exp2 for pitch math
+ */
+
+#include <stdio.h>
+#include <math.h>
+#include "audio/pitch_table.h"
+#include "audio/render_kernels.h"
+
+void pitch_table_set_rate(pitch_table_t* table, float sample_rate) {
+    if (table->sample_rate == sample_rate) {
+        return;
+    }
+    // Built in double so every entry is exact to the last 32.32 unit
+    for (int32_t i = 0; i < PITCH_TABLE_SIZE; i++) {
+        double frequency = 440.0 * exp2((double)(i + PITCH_TABLE_LOWEST - 69) / 12.0);
+        table->increments[i] = (int64_t)(frequency / sample_rate * 4294967296.0);
+    }
+    table->sample_rate = sample_rate;
+}
+
+bool pitch_table_validate(void) {
+    // exp2 across the range pitch code feeds it: fractions of an octave and
+    // whole bends of several octaves either way
+    double worst_cents = 0.0;
+    for (int32_t i = -48000; i <= 48000; i++) {
+        float x = (float)i / 4000.0f;
+        double cents = 1200.0 * fabs(log2((double)pitch_exp2f(x)) - (double)x);
+        worst_cents = cents > worst_cents ? cents : worst_cents;
+    }
+    if (worst_cents > 0.001) {
+        printf("[PITCH_TABLE] VALIDATION FAILED: exp2 off by %.5f cents\n", worst_cents);
+        return false;
+    }
+
+    pitch_table_t table = {0};
+    static const float rates[] = {22050.0f, 44100.0f, 48000.0f, 96000.0f};
+    for (size_t r = 0; r < sizeof(rates) / sizeof(rates[0]); r++) {
+        pitch_table_set_rate(&table, rates[r]);
+
+        // Integer notes land on the table and match the reference increment
+        // to within rounding of the float frequency it takes
+        for (int32_t note = 0; note < 128; note++) {
+            float frequency = 440.0f * powf(2.0f, (float)(note - 69) / 12.0f);
+            uint32_t expected = render_osc_increment(frequency, rates[r]);
+            uint32_t actual = pitch_table_increment(&table, (float)note);
+            if (fabs((double)actual - (double)expected) > 1e-6 * expected + 1.0) {
+                printf("[PITCH_TABLE] VALIDATION FAILED: note %d at %.0f Hz gives %u, expected %u\n",
+                       (int)note, rates[r], actual, expected);
+                return false;
+            }
+        }
+
+        // Bent notes, including bends below note 0; entry and product each truncate
+        for (int32_t step = -3200; step <= 12800; step++) {
+            float note = (float)step / 100.0f + 0.37f;
+            double exact = 440.0 * exp2(((double)note - 69.0) / 12.0) / rates[r] * 4294967296.0;
+            double actual = (double)pitch_table_increment(&table, note);
+            if (exact < 4294967296.0 && fabs(actual - exact) > 3e-7 * exact + 2.0) {
+                printf("[PITCH_TABLE] VALIDATION FAILED: note %.2f at %.0f Hz gives %.0f, expected %.0f\n",
+                       note, rates[r], actual, exact);
+                return false;
+            }
+        }
+    }
+
+    printf("[PITCH_TABLE] Pitch table validation passed (exp2 within %.5f cents)\n", worst_cents);
+    return true;
+}
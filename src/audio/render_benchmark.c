@@ -0,0 +1,261 @@
+/*
+ * Render Benchmark
+ * End-to-end voice render benchmark with reproducible scenarios
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <math.h>
+#include "audio/render_benchmark.h"
+#include "audio/voice_manager.h"
+#include "audio/effect_engine.h"
+#include "audio/waveform_generator.h"
+
+#define BENCH_WARMUP_BLOCKS 16
+#define BENCH_REVERB_SECONDS 3.0f
+
+static const char* const k_waveform_names[WAVEFORM_COUNT] = {"sine", "sawtooth", "square", "triangle"};
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static void add_scenario(render_scenario_t* scenarios, size_t max_scenarios, size_t* count, uint8_t waveform,
+                         uint32_t voices, bool effects, uint32_t block_frames, uint8_t channels) {
+    if (*count >= max_scenarios) {
+        return;
+    }
+
+    render_scenario_t* scenario = &scenarios[(*count)++];
+    memset(scenario, 0, sizeof(*scenario));
+    scenario->waveform = waveform;
+    scenario->voices = voices;
+    scenario->effects = effects;
+    scenario->block_frames = block_frames;
+    scenario->channels = channels;
+    scenario->seconds = RENDER_BENCHMARK_DEFAULT_SECONDS;
+    snprintf(scenario->name, sizeof(scenario->name), "%s_v%u_b%u_c%u%s", k_waveform_names[waveform], voices,
+             block_frames, channels, effects ? "_fx" : "");
+}
+
+size_t render_benchmark_default_suite(render_scenario_t* scenarios, size_t max_scenarios) {
+    static const uint32_t voice_counts[] = {1, 16, 64};
+    static const uint32_t block_sizes[] = {64, 128, 256, 512, 1024};
+    static const uint8_t channel_counts[] = {1, 2, 8};
+    size_t count = 0;
+
+    // Voice scaling per waveform at the reference block size and layout
+    for (uint8_t w = 0; w < WAVEFORM_COUNT; w++) {
+        for (size_t v = 0; v < sizeof(voice_counts) / sizeof(voice_counts[0]); v++) {
+            add_scenario(scenarios, max_scenarios, &count, w, voice_counts[v], false, 256, 2);
+        }
+    }
+
+    // Effect chain cost, then a multi-second convolution reverb at the
+    // default and a small sub-block size
+    add_scenario(scenarios, max_scenarios, &count, WAVEFORM_SAWTOOTH, 16, true, 256, 2);
+    static const uint32_t reverb_blocks[] = {256, 32};
+    for (size_t b = 0; b < sizeof(reverb_blocks) / sizeof(reverb_blocks[0]); b++) {
+        size_t before = count;
+        add_scenario(scenarios, max_scenarios, &count, WAVEFORM_SAWTOOTH, 16, false, reverb_blocks[b], 2);
+        if (count > before) {
+            render_scenario_t* scenario = &scenarios[before];
+            scenario->reverb_seconds = BENCH_REVERB_SECONDS;
+            snprintf(scenario->name, sizeof(scenario->name), "sawtooth_v16_b%u_c2_ir%.0fs", reverb_blocks[b],
+                     BENCH_REVERB_SECONDS);
+        }
+    }
+
+    // Block size and channel layout sweeps (256/2 is already covered)
+    for (size_t b = 0; b < sizeof(block_sizes) / sizeof(block_sizes[0]); b++) {
+        if (block_sizes[b] != 256) {
+            add_scenario(scenarios, max_scenarios, &count, WAVEFORM_SAWTOOTH, 16, false, block_sizes[b], 2);
+        }
+    }
+    for (size_t c = 0; c < sizeof(channel_counts) / sizeof(channel_counts[0]); c++) {
+        if (channel_counts[c] != 2) {
+            add_scenario(scenarios, max_scenarios, &count, WAVEFORM_SAWTOOTH, 16, false, 256, channel_counts[c]);
+        }
+    }
+
+    return count;
+}
+
+static int compare_block_time(const void* a, const void* b) {
+    uint32_t x = *(const uint32_t*)a;
+    uint32_t y = *(const uint32_t*)b;
+    return (x > y) - (x < y);
+}
+
+// Stereo decaying noise, about -60 dB at the end of the response
+static int load_reverb(float seconds, uint32_t sample_rate) {
+    uint32_t frames = (uint32_t)(seconds * sample_rate);
+    float* ir = malloc((size_t)frames * 2 * sizeof(float));
+    if (!ir) {
+        return RETROSAGA_ERROR_AUDIO_INIT;
+    }
+
+    uint32_t seed = 0x9e3779b9u;
+    const float decay = logf(1000.0f) / (float)frames;
+    for (uint32_t i = 0; i < frames * 2; i++) {
+        seed = seed * 1664525u + 1013904223u;
+        ir[i] = ((float)(seed >> 8) / 8388608.0f - 1.0f) * 0.05f * expf(-decay * (float)(i / 2));
+    }
+    int status = effect_engine_load_reverb(ir, frames, 2);
+    free(ir);
+    return status;
+}
+
+int render_benchmark_run(const render_scenario_t* scenario, const retrosaga_audio_config_t* base,
+                         render_result_t* result) {
+    if (!scenario || !base || !result || scenario->waveform >= WAVEFORM_COUNT || scenario->voices == 0 ||
+        scenario->voices > base->max_polyphony || scenario->seconds <= 0.0f) {
+        return RETROSAGA_ERROR_INVALID_PARAM;
+    }
+
+    retrosaga_audio_config_t config = *base;
+    config.sub_block_frames = scenario->block_frames;
+    config.buffer_size = scenario->block_frames;
+    config.channels = scenario->channels;
+    config.module_mask &= ~(uint32_t)RETROSAGA_MODULE_SOUND_OUTPUT;
+
+    int status = retrosaga_audio_init_with_config(&config);
+    if (status != RETROSAGA_SUCCESS) {
+        return status;
+    }
+
+    const uint32_t frames = scenario->block_frames;
+    const uint32_t blocks = (uint32_t)(scenario->seconds * config.sample_rate / frames);
+    float* buffer = calloc((size_t)frames * scenario->channels, sizeof(float));
+    uint32_t* block_times = calloc(blocks ? blocks : 1, sizeof(uint32_t));
+    if (!buffer || !block_times || blocks == 0) {
+        free(buffer);
+        free(block_times);
+        retrosaga_audio_shutdown();
+        return buffer && block_times ? RETROSAGA_ERROR_INVALID_PARAM : RETROSAGA_ERROR_AUDIO_INIT;
+    }
+
+    // Voices spread over channels and a few octaves so they never steal
+    for (uint8_t c = 0; c < 16; c++) {
+        voice_manager_set_program(c, scenario->waveform);
+    }
+    for (uint32_t v = 0; v < scenario->voices; v++) {
+        voice_manager_note_on((uint8_t)(v % 16), (uint8_t)(36 + (v * 7) % 60), 100);
+    }
+    effect_engine_set_bitcrush(scenario->effects ? 8 : 0);
+    effect_engine_set_output_gain(scenario->effects ? 0.8f : 1.0f);
+    if (scenario->reverb_seconds > 0.0f) {
+        status = load_reverb(scenario->reverb_seconds, config.sample_rate);
+        if (status != RETROSAGA_SUCCESS) {
+            free(buffer);
+            free(block_times);
+            retrosaga_audio_shutdown();
+            return status;
+        }
+    }
+
+    // Settle attack, parameter ramps and caches before timing
+    for (uint32_t i = 0; i < BENCH_WARMUP_BLOCKS; i++) {
+        voice_manager_render(buffer, frames);
+    }
+
+    uint64_t start = now_ns();
+    for (uint32_t i = 0; i < blocks; i++) {
+        uint64_t t0 = now_ns();
+        voice_manager_render(buffer, frames);
+        uint64_t elapsed = now_ns() - t0;
+        block_times[i] = elapsed > UINT32_MAX ? UINT32_MAX : (uint32_t)elapsed;
+    }
+    uint64_t total_ns = now_ns() - start;
+
+    memset(result, 0, sizeof(*result));
+    result->frames = (uint64_t)blocks * frames;
+    result->blocks = blocks;
+    result->wall_seconds = (double)total_ns / 1e9;
+    result->real_time_factor = total_ns ? ((double)result->frames / config.sample_rate) / result->wall_seconds : 0.0;
+    result->ns_per_sample_voice = (double)total_ns / ((double)result->frames * scenario->voices);
+
+    qsort(block_times, blocks, sizeof(uint32_t), compare_block_time);
+    result->block_p50_ns = block_times[blocks / 2];
+    result->block_p99_ns = block_times[(uint32_t)((blocks - 1) * 0.99)];
+    result->block_max_ns = block_times[blocks - 1];
+
+    free(buffer);
+    free(block_times);
+    retrosaga_audio_shutdown();
+    return RETROSAGA_SUCCESS;
+}
+
+int render_benchmark_write_json(FILE* out, const render_scenario_t* scenarios, const render_result_t* results,
+                                size_t count) {
+    if (!out || (count > 0 && (!scenarios || !results))) {
+        return RETROSAGA_ERROR_INVALID_PARAM;
+    }
+
+    fprintf(out, "{\n  \"benchmark\": \"render\",\n  \"scenarios\": [\n");
+    for (size_t i = 0; i < count; i++) {
+        const render_scenario_t* s = &scenarios[i];
+        const render_result_t* r = &results[i];
+        fprintf(out,
+                "    {\"name\": \"%s\", \"waveform\": \"%s\", \"voices\": %u, \"effects\": %s, "
+                "\"block_frames\": %u, \"channels\": %u, \"frames\": %lu, \"real_time_factor\": %.2f, "
+                "\"ns_per_sample_voice\": %.3f, \"block_p50_ns\": %u, \"block_p99_ns\": %u, "
+                "\"block_max_ns\": %u}%s\n",
+                s->name, k_waveform_names[s->waveform], s->voices, s->effects ? "true" : "false", s->block_frames,
+                s->channels, (unsigned long)r->frames, r->real_time_factor, r->ns_per_sample_voice,
+                r->block_p50_ns, r->block_p99_ns, r->block_max_ns, i + 1 < count ? "," : "");
+    }
+    fprintf(out, "  ]\n}\n");
+    return ferror(out) ? RETROSAGA_ERROR_FILE_IO : RETROSAGA_SUCCESS;
+}
+
+// The baseline is a file written by render_benchmark_write_json, so each
+// scenario is one line and a field scan is enough
+static bool baseline_lookup(FILE* baseline, const char* name, double* ns_per_sample_voice) {
+    char line[1024];
+    char key[RENDER_BENCHMARK_NAME_MAX + 16];
+    snprintf(key, sizeof(key), "\"name\": \"%s\"", name);
+
+    rewind(baseline);
+    while (fgets(line, sizeof(line), baseline)) {
+        if (!strstr(line, key)) {
+            continue;
+        }
+        const char* field = strstr(line, "\"ns_per_sample_voice\":");
+        return field && sscanf(field, "\"ns_per_sample_voice\": %lf", ns_per_sample_voice) == 1;
+    }
+    return false;
+}
+
+int render_benchmark_compare(const char* baseline_path, const render_scenario_t* scenarios,
+                             const render_result_t* results, size_t count, double tolerance) {
+    FILE* baseline = fopen(baseline_path, "r");
+    if (!baseline) {
+        return RETROSAGA_ERROR_FILE_IO;
+    }
+
+    int regressions = 0;
+    printf("%-28s %12s %12s %9s\n", "scenario", "baseline", "current", "change");
+    for (size_t i = 0; i < count; i++) {
+        double expected;
+        if (!baseline_lookup(baseline, scenarios[i].name, &expected) || expected <= 0.0) {
+            printf("%-28s %12s %12.3f %9s\n", scenarios[i].name, "-", results[i].ns_per_sample_voice, "new");
+            continue;
+        }
+
+        double change = results[i].ns_per_sample_voice / expected - 1.0;
+        bool regressed = change > tolerance;
+        regressions += regressed;
+        printf("%-28s %12.3f %12.3f %+8.1f%%%s\n", scenarios[i].name, expected, results[i].ns_per_sample_voice,
+               100.0 * change, regressed ? "  REGRESSION" : "");
+    }
+
+    fclose(baseline);
+    return regressions;
+}
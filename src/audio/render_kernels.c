@@ -0,0 +1,320 @@
+/*
+ * Render Kernels
+ * Block-size specialized oscillator, mixer and effect inner loops
+ *
+ * Kernel bodies are always inlined into thin per-shape wrappers; the
+ * constant frame and channel counts let GCC's -O2 vectorizer (which only
+ * takes loops without scalar epilogues) and the unroller handle them.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "audio/render_kernels.h"
+
+#define KERNEL_INLINE static inline __attribute__((always_inline))
+
+#define PHASE_TO_UNIT (1.0f / 2147483648.0f)
+
+// ---------------------------------------------------------------------------
+// Kernel bodies
+// ---------------------------------------------------------------------------
+
+// Signed phase in [-1, 1): phase 0..2^31 maps to 0..1, the upper half to -1..0
+KERNEL_INLINE float signed_phase(uint32_t phase) {
+    return (float)(int32_t)phase * PHASE_TO_UNIT;
+}
+
+// sin(pi * s) for s in [-1, 1): fold into [-0.5, 0.5] without branches,
+// then an odd degree-9 polynomial (max error 1e-7)
+KERNEL_INLINE float sine_of_signed_phase(float s) {
+    float folded = copysignf(0.5f - fabsf(fabsf(s) - 0.5f), s);
+    float u2 = folded * folded;
+    return folded * (3.14159258e+00f + u2 * (-5.16770687e+00f + u2 * (2.55003120e+00f +
+                     u2 * (-5.98044241e-01f + u2 * 7.72184690e-02f))));
+}
+
+KERNEL_INLINE void osc_sine_body(render_osc_t* osc, float amplitude, float* restrict out, uint32_t n) {
+    const uint32_t phase = osc->phase;
+    const uint32_t increment = osc->increment;
+    for (uint32_t i = 0; i < n; i++) {
+        out[i] = amplitude * sine_of_signed_phase(signed_phase(phase + i * increment));
+    }
+    osc->phase = phase + n * increment;
+}
+
+KERNEL_INLINE void osc_sawtooth_body(render_osc_t* osc, float amplitude, float* restrict out, uint32_t n) {
+    const uint32_t phase = osc->phase;
+    const uint32_t increment = osc->increment;
+    for (uint32_t i = 0; i < n; i++) {
+        // 2p - 1 is the signed phase shifted by half a cycle
+        out[i] = amplitude * signed_phase(phase + i * increment + 0x80000000u);
+    }
+    osc->phase = phase + n * increment;
+}
+
+KERNEL_INLINE void osc_square_body(render_osc_t* osc, float amplitude, float* restrict out, uint32_t n) {
+    const uint32_t phase = osc->phase;
+    const uint32_t increment = osc->increment;
+    for (uint32_t i = 0; i < n; i++) {
+        float upper_half = (float)(int32_t)((phase + i * increment) >> 31);
+        out[i] = amplitude - 2.0f * amplitude * upper_half;
+    }
+    osc->phase = phase + n * increment;
+}
+
+KERNEL_INLINE void osc_triangle_body(render_osc_t* osc, float amplitude, float* restrict out, uint32_t n) {
+    const uint32_t phase = osc->phase;
+    const uint32_t increment = osc->increment;
+    for (uint32_t i = 0; i < n; i++) {
+        float saw = signed_phase(phase + i * increment + 0x80000000u);
+        out[i] = amplitude * (1.0f - 2.0f * fabsf(saw));
+    }
+    osc->phase = phase + n * increment;
+}
+
+KERNEL_INLINE void mix_body(const float* restrict voice, const float* restrict gains, float* restrict bus,
+                            uint32_t n, uint32_t channels) {
+    for (uint32_t i = 0; i < n; i++) {
+        const float sample = voice[i];
+        for (uint32_t c = 0; c < channels; c++) {
+            bus[i * channels + c] += sample * gains[c];
+        }
+    }
+}
+
+KERNEL_INLINE void crush_body(float* restrict buffer, float levels, uint32_t n) {
+    const float inverse = 1.0f / levels;
+    for (uint32_t i = 0; i < n; i++) {
+        // Branch-free clamp to [-1, 1] and round half away from zero
+        float x = buffer[i];
+        float scaled = 0.5f * (fabsf(x + 1.0f) - fabsf(x - 1.0f)) * levels;
+        buffer[i] = (float)(int32_t)(scaled + copysignf(0.5f, scaled)) * inverse;
+    }
+}
+
+KERNEL_INLINE void ramp_body(float* restrict buffer, float start, float end, uint32_t n) {
+    const float step = (end - start) / (float)n;
+    for (uint32_t i = 0; i < n; i++) {
+        buffer[i] *= start + step * (float)i;
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Specializations
+// ---------------------------------------------------------------------------
+
+#define DEFINE_OSC_KERNELS(N)                                                                       \
+    static void osc_sine_##N(render_osc_t* osc, float amplitude, float* out, uint32_t frames) {     \
+        (void)frames;                                                                               \
+        osc_sine_body(osc, amplitude, out, N);                                                      \
+    }                                                                                               \
+    static void osc_sawtooth_##N(render_osc_t* osc, float amplitude, float* out, uint32_t frames) { \
+        (void)frames;                                                                               \
+        osc_sawtooth_body(osc, amplitude, out, N);                                                  \
+    }                                                                                               \
+    static void osc_square_##N(render_osc_t* osc, float amplitude, float* out, uint32_t frames) {   \
+        (void)frames;                                                                               \
+        osc_square_body(osc, amplitude, out, N);                                                    \
+    }                                                                                               \
+    static void osc_triangle_##N(render_osc_t* osc, float amplitude, float* out, uint32_t frames) { \
+        (void)frames;                                                                               \
+        osc_triangle_body(osc, amplitude, out, N);                                                  \
+    }                                                                                               \
+    static void ramp_##N(float* buffer, float start, float end, uint32_t frames) {                 \
+        (void)frames;                                                                               \
+        ramp_body(buffer, start, end, N);                                                           \
+    }
+
+#define DEFINE_CHANNEL_KERNELS(N, C)                                                                \
+    static void mix_##N##_##C(const float* voice, const float* gains, float* bus,                  \
+                              uint32_t frames, uint8_t channels) {                                  \
+        (void)frames;                                                                               \
+        (void)channels;                                                                             \
+        mix_body(voice, gains, bus, N, C);                                                          \
+    }                                                                                               \
+    static void crush_##N##_##C(float* buffer, float levels, uint32_t frames, uint8_t channels) {  \
+        (void)frames;                                                                               \
+        (void)channels;                                                                             \
+        crush_body(buffer, levels, (N) * (C));                                                      \
+    }
+
+#define DEFINE_ANY_CHANNEL_KERNELS(N)                                                               \
+    static void mix_##N##_any(const float* voice, const float* gains, float* bus,                  \
+                              uint32_t frames, uint8_t channels) {                                  \
+        (void)frames;                                                                               \
+        mix_body(voice, gains, bus, N, channels);                                                   \
+    }                                                                                               \
+    static void crush_##N##_any(float* buffer, float levels, uint32_t frames, uint8_t channels) {  \
+        (void)frames;                                                                               \
+        crush_body(buffer, levels, (N) * channels);                                                 \
+    }
+
+#define DEFINE_BLOCK_SIZE(N)            \
+    DEFINE_OSC_KERNELS(N)               \
+    DEFINE_CHANNEL_KERNELS(N, 1)        \
+    DEFINE_CHANNEL_KERNELS(N, 2)        \
+    DEFINE_CHANNEL_KERNELS(N, 8)        \
+    DEFINE_ANY_CHANNEL_KERNELS(N)
+
+DEFINE_BLOCK_SIZE(32)
+DEFINE_BLOCK_SIZE(64)
+DEFINE_BLOCK_SIZE(128)
+DEFINE_BLOCK_SIZE(256)
+DEFINE_BLOCK_SIZE(512)
+DEFINE_BLOCK_SIZE(1024)
+
+// Generic fallbacks for any other shape
+static void osc_sine_generic(render_osc_t* osc, float amplitude, float* out, uint32_t frames) {
+    osc_sine_body(osc, amplitude, out, frames);
+}
+
+static void osc_sawtooth_generic(render_osc_t* osc, float amplitude, float* out, uint32_t frames) {
+    osc_sawtooth_body(osc, amplitude, out, frames);
+}
+
+static void osc_square_generic(render_osc_t* osc, float amplitude, float* out, uint32_t frames) {
+    osc_square_body(osc, amplitude, out, frames);
+}
+
+static void osc_triangle_generic(render_osc_t* osc, float amplitude, float* out, uint32_t frames) {
+    osc_triangle_body(osc, amplitude, out, frames);
+}
+
+static void mix_generic(const float* voice, const float* gains, float* bus, uint32_t frames, uint8_t channels) {
+    mix_body(voice, gains, bus, frames, channels);
+}
+
+static void crush_generic(float* buffer, float levels, uint32_t frames, uint8_t channels) {
+    crush_body(buffer, levels, frames * channels);
+}
+
+static void ramp_generic(float* buffer, float start, float end, uint32_t frames) {
+    if (frames > 0) {
+        ramp_body(buffer, start, end, frames);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Dispatch tables
+// ---------------------------------------------------------------------------
+
+#define KERNEL_SET(N, C, VARIANT)                                                        \
+    { N, C, {osc_sine_##N, osc_sawtooth_##N, osc_square_##N, osc_triangle_##N},          \
+      mix_##N##_##VARIANT, crush_##N##_##VARIANT, ramp_##N }
+
+#define KERNEL_ROW(N) \
+    { KERNEL_SET(N, 1, 1), KERNEL_SET(N, 2, 2), KERNEL_SET(N, 8, 8), KERNEL_SET(N, 0, any) }
+
+static const render_kernels_t k_specialized[][4] = {
+    KERNEL_ROW(32),
+    KERNEL_ROW(64),
+    KERNEL_ROW(128),
+    KERNEL_ROW(256),
+    KERNEL_ROW(512),
+    KERNEL_ROW(1024),
+};
+
+static const render_kernels_t k_generic = {
+    0, 0,
+    {osc_sine_generic, osc_sawtooth_generic, osc_square_generic, osc_triangle_generic},
+    mix_generic, crush_generic, ramp_generic
+};
+
+const render_kernels_t* render_kernels_select(uint32_t frames, uint8_t channels) {
+    int row;
+    switch (frames) {
+        case 32:   row = 0; break;
+        case 64:   row = 1; break;
+        case 128:  row = 2; break;
+        case 256:  row = 3; break;
+        case 512:  row = 4; break;
+        case 1024: row = 5; break;
+        default:   return &k_generic;
+    }
+
+    int column = (channels == 1) ? 0 : (channels == 2) ? 1 : (channels == 8) ? 2 : 3;
+    return &k_specialized[row][column];
+}
+
+bool render_kernels_is_specialized(const render_kernels_t* kernels) {
+    return kernels && kernels->frames != 0;
+}
+
+uint32_t render_osc_increment(float frequency, float sample_rate) {
+    double cycles_per_sample = (double)frequency / sample_rate;
+    cycles_per_sample -= floor(cycles_per_sample);
+    double increment = cycles_per_sample * 4294967296.0;
+    return (increment >= 4294967295.0) ? 0xFFFFFFFFu : (uint32_t)increment;
+}
+
+// ---------------------------------------------------------------------------
+// Self test: every specialization must match the generic path bit for bit
+// ---------------------------------------------------------------------------
+
+bool render_kernels_self_test(void) {
+    static const uint32_t sizes[] = RENDER_KERNEL_BLOCK_SIZES;
+    static const uint8_t channel_counts[] = {1, 2, 3, 8};
+    static const float gains[8] = {0.9f, 0.7f, 0.5f, 0.3f, 0.2f, 0.15f, 0.1f, 0.05f};
+
+    float* voice = malloc(1024 * sizeof(float));
+    float* expected = malloc(1024 * 8 * sizeof(float));
+    float* actual = malloc(1024 * 8 * sizeof(float));
+    if (!voice || !expected || !actual) {
+        free(voice);
+        free(expected);
+        free(actual);
+        return false;
+    }
+
+    bool valid = true;
+    uint32_t increment = render_osc_increment(440.0f, 44100.0f);
+
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]) && valid; s++) {
+        uint32_t n = sizes[s];
+        const render_kernels_t* fast = render_kernels_select(n, 1);
+        valid &= render_kernels_is_specialized(fast);
+
+        for (int w = 0; w < WAVEFORM_COUNT; w++) {
+            render_osc_t a = {0x12345678u, increment};
+            render_osc_t b = a;
+            k_generic.oscillator[w](&a, 0.5f, expected, n);
+            fast->oscillator[w](&b, 0.5f, actual, n);
+            valid &= (a.phase == b.phase) && memcmp(expected, actual, n * sizeof(float)) == 0;
+        }
+
+        ramp_generic(expected, 0.25f, 0.75f, n);
+        fast->ramp(actual, 0.25f, 0.75f, n);
+        valid &= memcmp(expected, actual, n * sizeof(float)) == 0;
+
+        for (size_t c = 0; c < sizeof(channel_counts); c++) {
+            uint8_t channels = channel_counts[c];
+            const render_kernels_t* kernels = render_kernels_select(n, channels);
+
+            for (uint32_t i = 0; i < n; i++) {
+                voice[i] = 1.5f * sinf(0.05f * i);
+            }
+            for (uint32_t i = 0; i < n * channels; i++) {
+                expected[i] = actual[i] = 0.01f * (float)(i % 7);
+            }
+            mix_generic(voice, gains, expected, n, channels);
+            kernels->mix(voice, gains, actual, n, channels);
+            crush_generic(expected, 127.0f, n, channels);
+            kernels->bitcrush(actual, 127.0f, n, channels);
+            valid &= memcmp(expected, actual, (size_t)n * channels * sizeof(float)) == 0;
+        }
+    }
+
+    // Polynomial sine against libm
+    render_osc_t osc = {0, render_osc_increment(1.0f, 1024.0f)};
+    k_generic.oscillator[WAVEFORM_SINE](&osc, 1.0f, actual, 1024);
+    for (uint32_t i = 0; i < 1024 && valid; i++) {
+        valid &= fabsf(actual[i] - sinf(2.0f * 3.14159265f * (float)i / 1024.0f)) < 1e-5f;
+    }
+
+    free(voice);
+    free(expected);
+    free(actual);
+    return valid;
+}
@@ -11,6 +11,11 @@
 #include <string.h>
 #include <unistd.h>
 #include "audio/retrosaga_audio.h"
+#include "audio/audio_config.h"
+#include "audio/render_kernels.h"
+#include "audio/voice_manager.h"
+#include "audio/audio_params.h"
+#include "audio/voice_filter.h"
 #include <string.h>
 #include <stdlib.h>
 // Include all audio module headers
@@ -18,10 +23,22 @@
 #include "audio/audio_entropy.h"
 #include "audio/prng_module.h"
 #include "audio/midi_processing.h"
+#include "audio/midi_file.h"
 #include "audio/bit_scaler.h"
 #include "audio/effect_engine.h"
+#include "audio/audio_fft.h"
+#include "audio/audio_resampler.h"
+#include "audio/audio_convolver.h"
+#include "audio/pitch_table.h"
+#include "audio/sample_bank.h"
 #include "audio/waveform_generator.h"
 #include "audio/sound_output.h"
+#include "audio/audio_recorder.h"
+#include "audio/audio_snapshot.h"
+#include "audio/audio_server.h"
+#include "audio/audio_trace.h"
+#include "audio/audio_arena.h"
+#include "audio/audio_workers.h"
 
 typedef struct {
     bool initialized;
@@ -30,58 +47,156 @@ typedef struct {
     uint64_t frame_count;
     uint32_t midi_messages_processed;
     float cpu_usage_percent;
+    bool render_silent;           // Last render produced only zeros
+    bool input_active;            // Captured input was waiting at the last update
+    uint64_t idle_updates;        // Updates that skipped the output-side stages
+    uint64_t silent_renders;
 } retrosaga_audio_state_t;
 
 static retrosaga_audio_state_t g_audio_state = {0};
+static retrosaga_audio_config_t g_active_config = RETROSAGA_AUDIO_CONFIG_DEFAULT;
 
+const retrosaga_audio_config_t* retrosaga_audio_get_config(void) {
+    return &g_active_config;
+}
+
+// Startup configuration: $RETROSAGA_CONFIG, else ./pkg.nlink, else defaults
 int retrosaga_audio_init(void) {
     if (g_audio_state.initialized) {
         return RETROSAGA_ERROR_ALREADY_INITIALIZED;
     }
     
+    retrosaga_audio_config_t config;
+    const char* config_path = getenv(AUDIO_CONFIG_PATH_ENV);
+    if (!config_path && access(AUDIO_CONFIG_DEFAULT_PATH, R_OK) == 0) {
+        config_path = AUDIO_CONFIG_DEFAULT_PATH;
+    }
+    
+    if (config_path) {
+        if (audio_config_load(config_path, NULL, &config) != RETROSAGA_SUCCESS) {
+            printf("[RETROSAGA_AUDIO] ERROR: Invalid configuration in %s\n", config_path);
+            return RETROSAGA_ERROR_CONFIG;
+        }
+        printf("[RETROSAGA_AUDIO] Configuration loaded from %s\n", config_path);
+    } else {
+        audio_config_defaults(&config);
+    }
+    
+    return retrosaga_audio_init_with_config(&config);
+}
+
+int retrosaga_audio_init_with_config(const retrosaga_audio_config_t* config) {
+    if (g_audio_state.initialized) {
+        return RETROSAGA_ERROR_ALREADY_INITIALIZED;
+    }
+    if (!config || audio_config_validate(config) != RETROSAGA_SUCCESS) {
+        return RETROSAGA_ERROR_CONFIG;
+    }
+    
+    g_active_config = *config;
+    int status = RETROSAGA_SUCCESS;
+    
     printf("[RETROSAGA_AUDIO] Initializing comprehensive audio subsystem...\n");
     
+    // Tracing is diagnostic only, so a failure here is not fatal
+    if (audio_trace_init() == RETROSAGA_ERROR_AUDIO_INIT) {
+        printf("[RETROSAGA_AUDIO] WARNING: Stage tracing unavailable\n");
+    }
+    
+    // Engine memory comes from one arena sized by memory_pool_mb
+    if (audio_arena_init(config) != RETROSAGA_SUCCESS) {
+        printf("[RETROSAGA_AUDIO] ERROR: Failed to initialize audio_arena\n");
+        status = RETROSAGA_ERROR_AUDIO_INIT;
+        goto fail_audio_arena;
+    }
+    
+    // Render workers for intra-block voice parallelism (worker_count - 1 threads)
+    if (audio_workers_init(config->worker_count, config->stack_size_kb, config->pin_workers) != RETROSAGA_SUCCESS) {
+        printf("[RETROSAGA_AUDIO] ERROR: Failed to initialize audio_workers\n");
+        status = RETROSAGA_ERROR_AUDIO_INIT;
+        goto fail_audio_workers;
+    }
+    
     // Initialize input modules
     if (input_audio_init() != RETROSAGA_SUCCESS) {
         printf("[RETROSAGA_AUDIO] ERROR: Failed to initialize input_audio\n");
-        return RETROSAGA_ERROR_AUDIO_INIT;
+        status = RETROSAGA_ERROR_AUDIO_INIT;
+        goto fail_input_audio;
     }
     
     if (audio_entropy_init() != RETROSAGA_SUCCESS) {
         printf("[RETROSAGA_AUDIO] ERROR: Failed to initialize audio_entropy\n");
-        return RETROSAGA_ERROR_AUDIO_INIT;
+        status = RETROSAGA_ERROR_AUDIO_INIT;
+        goto fail_audio_entropy;
     }
     
     if (prng_module_init() != RETROSAGA_SUCCESS) {
         printf("[RETROSAGA_AUDIO] ERROR: Failed to initialize prng_module\n");
-        return RETROSAGA_ERROR_AUDIO_INIT;
+        status = RETROSAGA_ERROR_AUDIO_INIT;
+        goto fail_prng_module;
     }
     
     // Initialize processing modules
     if (bit_scaler_init() != RETROSAGA_SUCCESS) {
         printf("[RETROSAGA_AUDIO] ERROR: Failed to initialize bit_scaler\n");
-        return RETROSAGA_ERROR_AUDIO_INIT;
+        status = RETROSAGA_ERROR_AUDIO_INIT;
+        goto fail_bit_scaler;
+    }
+    
+    if (audio_params_init() != RETROSAGA_SUCCESS) {
+        printf("[RETROSAGA_AUDIO] ERROR: Failed to initialize audio_params\n");
+        status = RETROSAGA_ERROR_AUDIO_INIT;
+        goto fail_audio_params;
     }
     
     if (midi_processing_init() != RETROSAGA_SUCCESS) {
         printf("[RETROSAGA_AUDIO] ERROR: Failed to initialize midi_processing\n");
-        return RETROSAGA_ERROR_MIDI_INIT;
+        status = RETROSAGA_ERROR_MIDI_INIT;
+        goto fail_midi_processing;
     }
     
     if (effect_engine_init() != RETROSAGA_SUCCESS) {
         printf("[RETROSAGA_AUDIO] ERROR: Failed to initialize effect_engine\n");
-        return RETROSAGA_ERROR_AUDIO_INIT;
+        status = RETROSAGA_ERROR_AUDIO_INIT;
+        goto fail_effect_engine;
     }
     
     // Initialize output modules
+    if (voice_manager_init() != RETROSAGA_SUCCESS) {
+        printf("[RETROSAGA_AUDIO] ERROR: Failed to initialize voice_manager\n");
+        status = RETROSAGA_ERROR_AUDIO_INIT;
+        goto fail_voice_manager;
+    }
+    
     if (waveform_generator_init() != RETROSAGA_SUCCESS) {
         printf("[RETROSAGA_AUDIO] ERROR: Failed to initialize waveform_generator\n");
-        return RETROSAGA_ERROR_AUDIO_INIT;
+        status = RETROSAGA_ERROR_AUDIO_INIT;
+        goto fail_waveform_generator;
     }
     
     if (sound_output_init() != RETROSAGA_SUCCESS) {
         printf("[RETROSAGA_AUDIO] ERROR: Failed to initialize sound_output\n");
-        return RETROSAGA_ERROR_AUDIO_INIT;
+        status = RETROSAGA_ERROR_AUDIO_INIT;
+        goto fail_sound_output;
+    }
+    
+    if (audio_recorder_init() != RETROSAGA_SUCCESS) {
+        printf("[RETROSAGA_AUDIO] ERROR: Failed to initialize audio_recorder\n");
+        status = RETROSAGA_ERROR_AUDIO_INIT;
+        goto fail_audio_recorder;
+    }
+    
+    if (audio_server_init() != RETROSAGA_SUCCESS) {
+        printf("[RETROSAGA_AUDIO] ERROR: Failed to initialize audio_server\n");
+        status = RETROSAGA_ERROR_AUDIO_INIT;
+        goto fail_audio_server;
+    }
+    
+    // No persistent allocation past this point; the rest is per-block scratch
+    if (audio_arena_seal(audio_arena_engine()) != RETROSAGA_SUCCESS) {
+        printf("[RETROSAGA_AUDIO] ERROR: memory_pool_mb too small for per-block scratch\n");
+        status = RETROSAGA_ERROR_AUDIO_INIT;
+        goto fail_seal;
     }
     
     // Initialize state
@@ -90,33 +205,88 @@ int retrosaga_audio_init(void) {
     g_audio_state.midi_messages_processed = 0;
     g_audio_state.cpu_usage_percent = 0.0f;
     g_audio_state.dss_compliant = true;
+    g_audio_state.render_silent = true;
+    g_audio_state.input_active = false;
     g_audio_state.initialized = true;
     
     printf("[RETROSAGA_AUDIO] Audio subsystem initialized successfully\n");
-    printf("[RETROSAGA_AUDIO] Configuration: %d Hz, %d samples/buffer, %d polyphony\n",
-           RETROSAGA_SAMPLE_RATE, RETROSAGA_BUFFER_SIZE, RETROSAGA_MAX_POLYPHONY);
+    printf("[RETROSAGA_AUDIO] Configuration: %u Hz, %u samples/buffer, %u polyphony, %d channels\n",
+           g_active_config.sample_rate, g_active_config.buffer_size,
+           g_active_config.max_polyphony, g_active_config.channels);
     
     return RETROSAGA_SUCCESS;
+
+    // Undo, in reverse order, everything initialized before the failure
+fail_seal:
+    audio_server_shutdown();
+fail_audio_server:
+    audio_recorder_shutdown();
+fail_audio_recorder:
+    sound_output_shutdown();
+fail_sound_output:
+    waveform_generator_shutdown();
+fail_waveform_generator:
+    voice_manager_shutdown();
+fail_voice_manager:
+    effect_engine_shutdown();
+fail_effect_engine:
+    midi_processing_shutdown();
+fail_midi_processing:
+    audio_params_shutdown();
+fail_audio_params:
+    bit_scaler_shutdown();
+fail_bit_scaler:
+    prng_module_shutdown();
+fail_prng_module:
+    audio_entropy_shutdown();
+fail_audio_entropy:
+    input_audio_shutdown();
+fail_input_audio:
+    audio_workers_shutdown();
+fail_audio_workers:
+    audio_arena_shutdown();
+fail_audio_arena:
+    audio_trace_shutdown();
+    return status;
 }
 
 int retrosaga_audio_update(float delta_time_ms) {
     if (!g_audio_state.initialized) {
         return RETROSAGA_ERROR_NOT_INITIALIZED;
     }
+    AUDIO_TRACE_BEGIN(update_start);
+    AUDIO_ARENA_RT_ENTER();
+    
+    // Process the configured audio modules in pipeline order. Input and
+    // MIDI always run so new activity is seen; while the engine is idle
+    // the output-side stages have nothing to do and are skipped.
+    uint32_t modules = g_active_config.module_mask;
+    bool idle = g_audio_state.render_silent && !g_audio_state.input_active;
+    if (modules & RETROSAGA_MODULE_INPUT_AUDIO) input_audio_process();
+    if (modules & RETROSAGA_MODULE_AUDIO_ENTROPY) audio_entropy_process();
+    if (modules & RETROSAGA_MODULE_PRNG) prng_module_process();
+    
+    if (modules & RETROSAGA_MODULE_MIDI_PROCESSING) midi_processing_process();
+    if (!idle) {
+        if (modules & RETROSAGA_MODULE_BIT_SCALER) bit_scaler_process();
+        if (modules & RETROSAGA_MODULE_EFFECT_ENGINE) effect_engine_process();
+    }
     
-    // Process all audio modules in pipeline order
-    input_audio_process();
-    audio_entropy_process();
-    prng_module_process();
-    
-    midi_processing_process();
-    bit_scaler_process();
-    effect_engine_process();
+    // Captured input is mixed in by the render path; waiting input keeps
+    // the engine awake
+    g_audio_state.input_active = input_audio_pending();
+    idle &= !g_audio_state.input_active;
     
-    waveform_generator_process();
-    sound_output_process();
+    if (!idle) {
+        if (modules & RETROSAGA_MODULE_WAVEFORM_GENERATOR) waveform_generator_process();
+        if (modules & RETROSAGA_MODULE_SOUND_OUTPUT) sound_output_process();
+    } else {
+        g_audio_state.idle_updates++;
+    }
     
     g_audio_state.frame_count++;
+    AUDIO_ARENA_RT_LEAVE();
+    AUDIO_TRACE_END(AUDIO_TRACE_UPDATE, update_start);
     
     // Monitor performance every second
     if (g_audio_state.frame_count % 60 == 0) {
@@ -132,6 +302,45 @@ int retrosaga_audio_update(float delta_time_ms) {
     return RETROSAGA_SUCCESS;
 }
 
+bool retrosaga_audio_is_idle(void) {
+    return g_audio_state.initialized && g_audio_state.render_silent && !g_audio_state.input_active;
+}
+
+int retrosaga_audio_render(float* output, uint32_t frames) {
+    if (!g_audio_state.initialized) {
+        return RETROSAGA_ERROR_NOT_INITIALIZED;
+    }
+    if (!output && frames > 0) {
+        return RETROSAGA_ERROR_INVALID_PARAM;
+    }
+    
+    AUDIO_TRACE_BEGIN(render_start);
+    AUDIO_ARENA_RT_ENTER();
+    size_t samples = (size_t)frames * g_active_config.channels;
+    bool silent = true;
+    if (g_active_config.module_mask & RETROSAGA_MODULE_WAVEFORM_GENERATOR) {
+        voice_manager_render_block(output, frames, &silent);
+    } else {
+        memset(output, 0, samples * sizeof(float));
+    }
+    g_audio_state.render_silent = silent;
+    g_audio_state.silent_renders += silent;
+    
+    if (g_active_config.module_mask & RETROSAGA_MODULE_SOUND_OUTPUT) {
+        AUDIO_TRACE_BEGIN(output_start);
+        if (silent) {
+            output_audio_silence(samples);
+        } else {
+            output_audio_buffer(output, samples);
+        }
+        AUDIO_TRACE_END(AUDIO_TRACE_OUTPUT, output_start);
+    }
+    AUDIO_TRACE_COUNT(AUDIO_TRACE_FRAMES_OUTPUT, frames);
+    AUDIO_ARENA_RT_LEAVE();
+    AUDIO_TRACE_END(AUDIO_TRACE_RENDER, render_start);
+    return RETROSAGA_SUCCESS;
+}
+
 void retrosaga_audio_shutdown(void) {
     if (!g_audio_state.initialized) {
         return;
@@ -140,21 +349,31 @@ void retrosaga_audio_shutdown(void) {
     printf("[RETROSAGA_AUDIO] Shutting down audio subsystem...\n");
     
     // Shutdown modules in reverse order
+    audio_server_shutdown();
+    audio_recorder_shutdown();
     sound_output_shutdown();
     waveform_generator_shutdown();
+    voice_manager_shutdown();
     
     effect_engine_shutdown();
     midi_processing_shutdown();
+    audio_params_shutdown();
     bit_scaler_shutdown();
     
     prng_module_shutdown();
     audio_entropy_shutdown();
     input_audio_shutdown();
     
+    audio_workers_shutdown();
+    audio_arena_shutdown();
+    audio_trace_shutdown();
+    
     printf("[RETROSAGA_AUDIO] Audio subsystem statistics:\n");
     printf("[RETROSAGA_AUDIO]   Frames processed: %lu\n", g_audio_state.frame_count);
     printf("[RETROSAGA_AUDIO]   MIDI messages: %d\n", g_audio_state.midi_messages_processed);
     printf("[RETROSAGA_AUDIO]   Final CPU usage: %.1f%%\n", g_audio_state.cpu_usage_percent);
+    printf("[RETROSAGA_AUDIO]   Idle updates: %lu, silent renders: %lu\n", (unsigned long)g_audio_state.idle_updates,
+           (unsigned long)g_audio_state.silent_renders);
     
     memset(&g_audio_state, 0, sizeof(g_audio_state));
     printf("[RETROSAGA_AUDIO] Audio subsystem shutdown complete\n");
@@ -171,14 +390,48 @@ bool retrosaga_audio_validate(void) {
     bool all_valid = true;
     
     // Validate all modules
+    all_valid &= audio_arena_validate();
+    all_valid &= audio_workers_validate();
+    all_valid &= audio_resampler_validate();
     all_valid &= input_audio_validate();
     all_valid &= audio_entropy_validate();
     all_valid &= prng_module_validate();
+    all_valid &= audio_params_validate();
     all_valid &= midi_processing_validate();
+    all_valid &= midi_file_validate();
     all_valid &= bit_scaler_validate();
+    all_valid &= audio_fft_validate();
+    all_valid &= audio_convolver_validate();
     all_valid &= effect_engine_validate();
+    all_valid &= pitch_table_validate();
+    all_valid &= sample_bank_validate();
+    all_valid &= voice_manager_validate();
     all_valid &= waveform_generator_validate();
     all_valid &= sound_output_validate();
+    all_valid &= audio_recorder_validate();
+    all_valid &= audio_snapshot_validate();
+    all_valid &= audio_server_validate();
+    
+    if (audio_config_self_test()) {
+        printf("[RETROSAGA_AUDIO] V Configuration loader validated\n");
+    } else {
+        printf("[RETROSAGA_AUDIO] ? Configuration loader failed\n");
+        all_valid = false;
+    }
+    
+    if (voice_filter_self_test()) {
+        printf("[RETROSAGA_AUDIO] V Voice filters validated\n");
+    } else {
+        printf("[RETROSAGA_AUDIO] ? Voice filters failed\n");
+        all_valid = false;
+    }
+    
+    if (render_kernels_self_test()) {
+        printf("[RETROSAGA_AUDIO] V Specialized render kernels validated\n");
+    } else {
+        printf("[RETROSAGA_AUDIO] ? Specialized render kernels failed\n");
+        all_valid = false;
+    }
     
     // Test MIDI processing with sample data
     printf("[RETROSAGA_AUDIO] Testing MIDI message processing...\n");
@@ -198,13 +451,15 @@ bool retrosaga_audio_validate(void) {
     
     // Test waveform generation
     printf("[RETROSAGA_AUDIO] Testing waveform generation...\n");
-    float test_buffer[RETROSAGA_BUFFER_SIZE];
-    if (generate_waveform(440.0f, 0.5f, test_buffer, RETROSAGA_BUFFER_SIZE) == RETROSAGA_SUCCESS) {
+    audio_arena_t* arena = audio_arena_engine();
+    float* test_buffer = audio_arena_scratch_alloc(arena, RETROSAGA_BUFFER_SIZE * sizeof(float));
+    if (test_buffer && generate_waveform(440.0f, 0.5f, test_buffer, RETROSAGA_BUFFER_SIZE) == RETROSAGA_SUCCESS) {
         printf("[RETROSAGA_AUDIO] V Waveform generation successful\n");
     } else {
         printf("[RETROSAGA_AUDIO] ? Waveform generation failed\n");
         all_valid = false;
     }
+    audio_arena_scratch_reset(arena);
     
     // Validate DSS compliance
     if (g_audio_state.dss_compliant) {
@@ -231,9 +486,13 @@ int retrosaga_audio_diagnose(void) {
         return 1;
     }
     
-    printf("Sample Rate: %d Hz\n", RETROSAGA_SAMPLE_RATE);
-    printf("Buffer Size: %d samples\n", RETROSAGA_BUFFER_SIZE);
-    printf("Max Polyphony: %d voices\n", RETROSAGA_MAX_POLYPHONY);
+    printf("Sample Rate: %u Hz\n", g_active_config.sample_rate);
+    printf("Buffer Size: %u samples\n", g_active_config.buffer_size);
+    printf("Max Polyphony: %u voices\n", g_active_config.max_polyphony);
+    printf("Channels: %d\n", g_active_config.channels);
+    printf("Sub-block: %u samples (%.2f ms)\n", g_active_config.sub_block_frames,
+           1000.0f * g_active_config.sub_block_frames / g_active_config.sample_rate);
+    printf("Worker Threads: %u\n", g_active_config.worker_count);
     printf("Frame Count: %lu\n", g_audio_state.frame_count);
     printf("CPU Usage: %.1f%%\n", g_audio_state.cpu_usage_percent);
     printf("DSS Compliant: %s\n", g_audio_state.dss_compliant ? "Yes" : "No");
@@ -7,11 +7,30 @@
 #include <stdlib.h>
 #include <stdbool.h>
 #include "audio/sound_output.h"
+#include "audio/audio_resampler.h"
+#include "audio/audio_arena.h"
+#include "audio/audio_recorder.h"
 #include <string.h>
 #include <stdlib.h>
+
+#define SOUND_OUTPUT_CHUNK AUDIO_RESAMPLER_CHUNK   // Engine frames converted per pass
+
 typedef struct {
     bool initialized;
     uint32_t operations_count;
+    uint64_t samples_output;
+    uint64_t silent_samples;     // Emitted through the silence fast path
+
+    uint8_t channels;
+    uint32_t sample_rate;        // Device rate
+    bool resampling;
+    audio_resampler_t resampler;
+    float* device_buffer;        // One converted chunk
+    uint32_t device_frames;
+    float* zeros;                // One chunk of silence at the engine rate
+
+    sound_output_sink_t sink;
+    void* sink_user;
 } sound_output_state_t;
 
 static sound_output_state_t g_sound_output_state = {0};
@@ -20,12 +39,48 @@ int sound_output_init(void) {
     if (g_sound_output_state.initialized) {
         return RETROSAGA_ERROR_ALREADY_INITIALIZED;
     }
-    
+
     printf("[SOUND_OUTPUT] Initializing sound_output module...\n");
-    
+
+    const retrosaga_audio_config_t* config = retrosaga_audio_get_config();
     g_sound_output_state.operations_count = 0;
+    g_sound_output_state.channels = config->channels;
+    g_sound_output_state.sample_rate = config->output_sample_rate ? config->output_sample_rate : config->sample_rate;
+    g_sound_output_state.resampling = g_sound_output_state.sample_rate != config->sample_rate;
+
+    // Converting here saves the device path a copy and a second process
+    if (g_sound_output_state.resampling) {
+        audio_arena_t* arena = audio_arena_engine();
+        audio_resampler_t* rs = &g_sound_output_state.resampler;
+        int result = audio_resampler_init(rs, config->sample_rate, g_sound_output_state.sample_rate, config->channels,
+                                          (audio_resampler_quality_t)config->resampler_quality, arena);
+        if (result != RETROSAGA_SUCCESS) {
+            return result;
+        }
+
+        // A chunk plus the history a previous call can leave behind
+        g_sound_output_state.device_frames =
+            (uint32_t)((uint64_t)(SOUND_OUTPUT_CHUNK + rs->taps) * rs->step_den / rs->step_num + 2);
+        g_sound_output_state.device_buffer = audio_arena_alloc(arena, (size_t)g_sound_output_state.device_frames *
+                                                               config->channels * sizeof(float));
+        if (!g_sound_output_state.device_buffer) {
+            audio_resampler_destroy(rs);
+            return RETROSAGA_ERROR_AUDIO_INIT;
+        }
+        printf("[SOUND_OUTPUT] Resampling %u -> %u Hz (%s, %u taps, %s phases)\n", config->sample_rate,
+               g_sound_output_state.sample_rate, audio_resampler_quality_name(rs->quality), rs->taps,
+               rs->blend ? "blended" : "exact");
+    } else {
+        // Arena regions come zeroed, and nothing ever writes to this one
+        g_sound_output_state.zeros = audio_arena_alloc(audio_arena_engine(),
+                                                       (size_t)SOUND_OUTPUT_CHUNK * config->channels * sizeof(float));
+        if (!g_sound_output_state.zeros) {
+            return RETROSAGA_ERROR_AUDIO_INIT;
+        }
+    }
+
     g_sound_output_state.initialized = true;
-    
+
     printf("[SOUND_OUTPUT] Sound_output module initialized successfully\n");
     return RETROSAGA_SUCCESS;
 }
@@ -34,19 +89,106 @@ int sound_output_process(void) {
     if (!g_sound_output_state.initialized) {
         return RETROSAGA_ERROR_NOT_INITIALIZED;
     }
-    
+
     g_sound_output_state.operations_count++;
     return RETROSAGA_SUCCESS;
 }
 
+void sound_output_set_sink(sound_output_sink_t sink, void* user) {
+    g_sound_output_state.sink = sink;
+    g_sound_output_state.sink_user = user;
+}
+
+uint32_t sound_output_sample_rate(void) {
+    return g_sound_output_state.initialized ? g_sound_output_state.sample_rate
+                                            : retrosaga_audio_get_config()->sample_rate;
+}
+
+static void deliver(const float* frames_data, uint32_t frames) {
+    if (g_sound_output_state.sink && frames > 0) {
+        g_sound_output_state.sink(frames_data, frames, g_sound_output_state.channels, g_sound_output_state.sink_user);
+    }
+    g_sound_output_state.samples_output += (uint64_t)frames * g_sound_output_state.channels;
+}
+
+// Engine-rate frames through the converter; NULL input is silence, which
+// the converter turns into zeros without filtering once its history is quiet
+static uint64_t deliver_resampled(const float* input, uint32_t frames) {
+    const uint8_t channels = g_sound_output_state.channels;
+    uint64_t delivered = 0;
+    while (frames > 0) {
+        uint32_t count = frames < SOUND_OUTPUT_CHUNK ? frames : SOUND_OUTPUT_CHUNK;
+        uint32_t produced = audio_resampler_process(&g_sound_output_state.resampler, input, count,
+                                                    g_sound_output_state.device_buffer,
+                                                    g_sound_output_state.device_frames);
+        deliver(g_sound_output_state.device_buffer, produced);
+        delivered += produced;
+        if (input) {
+            input += (size_t)count * channels;
+        }
+        frames -= count;
+    }
+    return delivered;
+}
+
+int output_audio_buffer(const float* buffer, size_t samples) {
+    if (!g_sound_output_state.initialized) {
+        return RETROSAGA_ERROR_NOT_INITIALIZED;
+    }
+    if (!buffer) {
+        return RETROSAGA_ERROR_INVALID_PARAM;
+    }
+
+    uint32_t frames = (uint32_t)(samples / g_sound_output_state.channels);
+    audio_recorder_tap(buffer, frames);
+    if (g_sound_output_state.resampling) {
+        deliver_resampled(buffer, frames);
+    } else {
+        deliver(buffer, frames);
+    }
+    return RETROSAGA_SUCCESS;
+}
+
+// Silent blocks need no source buffer and, once the converter has drained,
+// no filtering; the sink still receives them as zeros so the device
+// timeline keeps every frame
+int output_audio_silence(size_t samples) {
+    if (!g_sound_output_state.initialized) {
+        return RETROSAGA_ERROR_NOT_INITIALIZED;
+    }
+
+    uint32_t frames = (uint32_t)(samples / g_sound_output_state.channels);
+    audio_recorder_tap_silence(frames);
+    if (g_sound_output_state.resampling) {
+        // The filter tail of the last audible block still has to drain
+        uint64_t delivered = deliver_resampled(NULL, frames);
+        g_sound_output_state.silent_samples += delivered * g_sound_output_state.channels;
+        return RETROSAGA_SUCCESS;
+    }
+
+    for (uint32_t remaining = frames; remaining > 0;) {
+        uint32_t count = remaining < SOUND_OUTPUT_CHUNK ? remaining : SOUND_OUTPUT_CHUNK;
+        deliver(g_sound_output_state.zeros, count);
+        remaining -= count;
+    }
+    g_sound_output_state.silent_samples += (uint64_t)frames * g_sound_output_state.channels;
+    return RETROSAGA_SUCCESS;
+}
+
 void sound_output_shutdown(void) {
     if (!g_sound_output_state.initialized) {
         return;
     }
-    
+
     printf("[SOUND_OUTPUT] Shutting down sound_output module...\n");
     printf("[SOUND_OUTPUT] Operations performed: %d\n", g_sound_output_state.operations_count);
-    
+    printf("[SOUND_OUTPUT] Samples output: %lu (%lu silent) at %u Hz\n",
+           (unsigned long)g_sound_output_state.samples_output, (unsigned long)g_sound_output_state.silent_samples,
+           g_sound_output_state.sample_rate);
+
+    if (g_sound_output_state.resampling) {
+        audio_resampler_destroy(&g_sound_output_state.resampler);
+    }
     memset(&g_sound_output_state, 0, sizeof(g_sound_output_state));
     printf("[SOUND_OUTPUT] Sound_output module shutdown complete\n");
 }
@@ -56,7 +198,44 @@ bool sound_output_validate(void) {
         printf("[SOUND_OUTPUT] VALIDATION FAILED: Not initialized\n");
         return false;
     }
-    
+
+    // One second at the engine rate reaches the device as one second at
+    // its rate, less the converter's look-ahead. A private converter and
+    // buffer of the live sizes keep the check off the recorder, the sink
+    // and the live converter's history.
+    if (g_sound_output_state.resampling) {
+        const audio_resampler_t* live = &g_sound_output_state.resampler;
+        const uint8_t channels = g_sound_output_state.channels;
+        audio_resampler_t rs;
+        if (audio_resampler_init(&rs, live->input_rate, live->output_rate, channels, live->quality, NULL) !=
+            RETROSAGA_SUCCESS) {
+            printf("[SOUND_OUTPUT] VALIDATION FAILED: Cannot plan a converter\n");
+            return false;
+        }
+        float* device = malloc((size_t)g_sound_output_state.device_frames * channels * sizeof(float));
+        if (!device) {
+            audio_resampler_destroy(&rs);
+            return false;
+        }
+
+        uint64_t frames = 0;
+        for (uint32_t remaining = rs.input_rate; remaining > 0;) {
+            uint32_t count = remaining < SOUND_OUTPUT_CHUNK ? remaining : SOUND_OUTPUT_CHUNK;
+            frames += audio_resampler_process(&rs, NULL, count, device, g_sound_output_state.device_frames);
+            remaining -= count;
+        }
+        uint64_t expected = (uint64_t)(rs.input_rate - audio_resampler_latency(&rs) + 1) * rs.step_den / rs.step_num;
+        bool valid = frames + 2 >= expected && frames <= expected + 2 && rs.frames_dropped == 0;
+
+        free(device);
+        audio_resampler_destroy(&rs);
+        if (!valid) {
+            printf("[SOUND_OUTPUT] VALIDATION FAILED: %lu device frames for one second, expected %lu\n",
+                   (unsigned long)frames, (unsigned long)expected);
+            return false;
+        }
+    }
+
     printf("[SOUND_OUTPUT] Sound_output module validation passed\n");
     return true;
 }
@@ -0,0 +1,381 @@
+/*
+ * Voice Filter
+ * Per-voice resonant filters processed in SIMD lane groups
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "audio/voice_filter.h"
+#include "audio/pitch_table.h"
+
+#define LANES VOICE_FILTER_LANES
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+static void* aligned_calloc(audio_arena_t* arena, size_t size) {
+    if (arena) {
+        return audio_arena_alloc(arena, size);
+    }
+    void* memory = NULL;
+    if (posix_memalign(&memory, 64, size) != 0) {
+        return NULL;
+    }
+    memset(memory, 0, size);
+    return memory;
+}
+
+int voice_filter_bank_init(voice_filter_bank_t* bank, uint32_t voice_count, uint32_t max_frames, float sample_rate,
+                           audio_arena_t* arena) {
+    if (!bank || voice_count == 0 || max_frames == 0 || sample_rate <= 0.0f) {
+        return RETROSAGA_ERROR_INVALID_PARAM;
+    }
+
+    memset(bank, 0, sizeof(*bank));
+    bank->voice_count = voice_count;
+    bank->group_count = (voice_count + LANES - 1) / LANES;
+    bank->max_frames = max_frames;
+    bank->sample_rate = sample_rate;
+    bank->arena_backed = arena != NULL;
+    bank->groups = aligned_calloc(arena, bank->group_count * sizeof(voice_filter_group_t));
+    bank->lane_input = aligned_calloc(arena, (size_t)max_frames * LANES * sizeof(float));
+    bank->lane_output = aligned_calloc(arena, (size_t)max_frames * LANES * sizeof(float));
+    if (!bank->groups || !bank->lane_input || !bank->lane_output) {
+        voice_filter_bank_destroy(bank);
+        return RETROSAGA_ERROR_AUDIO_INIT;
+    }
+
+    for (uint32_t v = 0; v < voice_count; v++) {
+        voice_filter_set(bank, v, VOICE_FILTER_OFF, 1000.0f, 0.0f);
+    }
+    return RETROSAGA_SUCCESS;
+}
+
+void voice_filter_bank_destroy(voice_filter_bank_t* bank) {
+    if (!bank) {
+        return;
+    }
+    if (!bank->arena_backed) {
+        free(bank->groups);
+        free(bank->lane_input);
+        free(bank->lane_output);
+    }
+    memset(bank, 0, sizeof(*bank));
+}
+
+float voice_filter_cutoff_hz(float normalized) {
+    float clamped = normalized < 0.0f ? 0.0f : (normalized > 1.0f ? 1.0f : normalized);
+    return 20.0f * pitch_exp2f(clamped * 9.965784285f);   // 1000^x
+}
+
+// ---------------------------------------------------------------------------
+// Control rate
+// ---------------------------------------------------------------------------
+
+void voice_filter_set(voice_filter_bank_t* bank, uint32_t voice, voice_filter_mode_t mode,
+                      float cutoff_hz, float resonance) {
+    if (voice >= bank->voice_count) {
+        return;
+    }
+
+    voice_filter_group_t* group = &bank->groups[voice / LANES];
+    const uint32_t lane = voice % LANES;
+    const uint32_t bit = 1u << lane;
+
+    float nyquist_limit = 0.45f * bank->sample_rate;
+    float fc = cutoff_hz < 10.0f ? 10.0f : (cutoff_hz > nyquist_limit ? nyquist_limit : cutoff_hz);
+    float res = resonance < 0.0f ? 0.0f : (resonance > 1.0f ? 1.0f : resonance);
+    float g = tanf((float)M_PI * fc / bank->sample_rate);
+
+    // State-variable: k = 1/Q from sqrt(2) (Q 0.707, flat passband) down to 0.04 (Q 25)
+    float k = 1.41421356f - 1.37421356f * res;
+    group->a1[lane] = 1.0f / (1.0f + g * (g + k));
+    group->a2[lane] = g * group->a1[lane];
+    group->a3[lane] = g * group->a2[lane];
+
+    // Ladder: feedback up to just below self-oscillation
+    float G = g / (1.0f + g);
+    float G4 = G * G * G * G;
+    group->G[lane] = G;
+    group->feedback[lane] = 3.9f * res;
+    group->solve[lane] = 1.0f / (1.0f + group->feedback[lane] * G4);
+
+    group->m0[lane] = 0.0f;
+    group->m1[lane] = 0.0f;
+    group->m2[lane] = 0.0f;
+    group->ladder_mix[lane] = 0.0f;
+    group->svf_mask &= ~bit;
+    group->ladder_mask &= ~bit;
+
+    switch (mode) {
+        case VOICE_FILTER_LOWPASS:
+            group->m2[lane] = 1.0f;
+            group->svf_mask |= bit;
+            break;
+        case VOICE_FILTER_BANDPASS:
+            group->m1[lane] = 1.0f;
+            group->svf_mask |= bit;
+            break;
+        case VOICE_FILTER_HIGHPASS:
+            group->m0[lane] = 1.0f;
+            group->m1[lane] = -k;
+            group->m2[lane] = -1.0f;
+            group->svf_mask |= bit;
+            break;
+        case VOICE_FILTER_LADDER:
+            group->ladder_mix[lane] = 1.0f;
+            group->ladder_mask |= bit;
+            break;
+        default:
+            // Unfiltered lanes pass through the state-variable mix
+            group->m0[lane] = 1.0f;
+            break;
+    }
+
+    group->enabled_mask |= bit;
+}
+
+void voice_filter_reset_voice(voice_filter_bank_t* bank, uint32_t voice) {
+    if (voice >= bank->voice_count) {
+        return;
+    }
+
+    voice_filter_group_t* group = &bank->groups[voice / LANES];
+    const uint32_t lane = voice % LANES;
+    group->ic1eq[lane] = 0.0f;
+    group->ic2eq[lane] = 0.0f;
+    for (int s = 0; s < 4; s++) {
+        group->stage[s][lane] = 0.0f;
+    }
+}
+
+void voice_filter_disable(voice_filter_bank_t* bank, uint32_t voice) {
+    if (voice >= bank->voice_count) {
+        return;
+    }
+    bank->groups[voice / LANES].enabled_mask &= ~(1u << (voice % LANES));
+}
+
+// ---------------------------------------------------------------------------
+// Audio rate: one group, all lanes per sample
+// ---------------------------------------------------------------------------
+
+// One vector holds one sample of every lane in a group
+typedef float lane_vec_t __attribute__((vector_size(LANES * sizeof(float))));
+
+static inline lane_vec_t lane_load(const float* source) {
+    lane_vec_t value;
+    memcpy(&value, source, sizeof(value));
+    return value;
+}
+
+static inline void lane_store(float* dest, lane_vec_t value) {
+    memcpy(dest, &value, sizeof(value));
+}
+
+static void svf_group(voice_filter_group_t* group, const float* restrict x, float* restrict y, uint32_t frames) {
+    const lane_vec_t a1 = lane_load(group->a1);
+    const lane_vec_t a2 = lane_load(group->a2);
+    const lane_vec_t a3 = lane_load(group->a3);
+    const lane_vec_t m0 = lane_load(group->m0);
+    const lane_vec_t m1 = lane_load(group->m1);
+    const lane_vec_t m2 = lane_load(group->m2);
+    lane_vec_t ic1 = lane_load(group->ic1eq);
+    lane_vec_t ic2 = lane_load(group->ic2eq);
+
+    for (uint32_t i = 0; i < frames; i++) {
+        lane_vec_t v0 = lane_load(x + i * LANES);
+        lane_vec_t v3 = v0 - ic2;
+        lane_vec_t v1 = a1 * ic1 + a2 * v3;
+        lane_vec_t v2 = ic2 + a2 * ic1 + a3 * v3;
+        ic1 = 2.0f * v1 - ic1;
+        ic2 = 2.0f * v2 - ic2;
+        lane_store(y + i * LANES, m0 * v0 + m1 * v1 + m2 * v2);
+    }
+
+    lane_store(group->ic1eq, ic1);
+    lane_store(group->ic2eq, ic2);
+}
+
+static void ladder_group(voice_filter_group_t* group, const float* restrict x, float* restrict y, uint32_t frames) {
+    const lane_vec_t G = lane_load(group->G);
+    const lane_vec_t beta = 1.0f - G;
+    const lane_vec_t G2 = G * G;
+    const lane_vec_t G3 = G2 * G;
+    const lane_vec_t G4 = G3 * G;
+    const lane_vec_t feedback = lane_load(group->feedback);
+    const lane_vec_t solve = lane_load(group->solve);
+    const lane_vec_t mix = lane_load(group->ladder_mix);
+    lane_vec_t s1 = lane_load(group->stage[0]);
+    lane_vec_t s2 = lane_load(group->stage[1]);
+    lane_vec_t s3 = lane_load(group->stage[2]);
+    lane_vec_t s4 = lane_load(group->stage[3]);
+
+    for (uint32_t i = 0; i < frames; i++) {
+        // Solve the feedback loop for this sample, then run the cascade
+        lane_vec_t input = lane_load(x + i * LANES);
+        lane_vec_t sum = beta * (G3 * s1 + G2 * s2 + G * s3 + s4);
+        lane_vec_t y4 = (G4 * input + sum) * solve;
+        lane_vec_t u = input - feedback * y4;
+
+        lane_vec_t v = (u - s1) * G;
+        lane_vec_t y1 = v + s1;
+        s1 = y1 + v;
+        v = (y1 - s2) * G;
+        lane_vec_t y2 = v + s2;
+        s2 = y2 + v;
+        v = (y2 - s3) * G;
+        lane_vec_t y3 = v + s3;
+        s3 = y3 + v;
+        v = (y3 - s4) * G;
+        lane_vec_t out = v + s4;
+        s4 = out + v;
+
+        lane_store(y + i * LANES, lane_load(y + i * LANES) + mix * out);
+    }
+
+    lane_store(group->stage[0], s1);
+    lane_store(group->stage[1], s2);
+    lane_store(group->stage[2], s3);
+    lane_store(group->stage[3], s4);
+}
+
+void voice_filter_process(voice_filter_bank_t* bank, float* rows, uint32_t row_stride, uint32_t frames) {
+    voice_filter_process_groups(bank, rows, row_stride, frames, 0, bank->group_count, bank->lane_input,
+                                bank->lane_output);
+}
+
+void voice_filter_process_groups(voice_filter_bank_t* bank, float* rows, uint32_t row_stride, uint32_t frames,
+                                 uint32_t first_group, uint32_t end_group, float* x, float* y) {
+    if (frames > bank->max_frames || end_group > bank->group_count) {
+        return;
+    }
+
+    for (uint32_t g = first_group; g < end_group; g++) {
+        voice_filter_group_t* group = &bank->groups[g];
+        uint32_t filtered = group->svf_mask | group->ladder_mask;
+        if ((group->enabled_mask & filtered) == 0) {
+            continue;
+        }
+
+        // Transpose the group's voices into lane-interleaved order
+        for (uint32_t l = 0; l < LANES; l++) {
+            uint32_t voice = g * LANES + l;
+            bool enabled = (group->enabled_mask >> l) & 1u;
+            const float* row = rows + (size_t)voice * row_stride;
+            for (uint32_t i = 0; i < frames; i++) {
+                x[i * LANES + l] = enabled ? row[i] : 0.0f;
+            }
+        }
+
+        if (group->enabled_mask & group->svf_mask) {
+            svf_group(group, x, y, frames);
+        } else {
+            memset(y, 0, (size_t)frames * LANES * sizeof(float));
+        }
+        if (group->enabled_mask & group->ladder_mask) {
+            ladder_group(group, x, y, frames);
+        }
+
+        for (uint32_t l = 0; l < LANES; l++) {
+            uint32_t voice = g * LANES + l;
+            if (!((group->enabled_mask >> l) & 1u) || voice >= bank->voice_count) {
+                continue;
+            }
+            float* row = rows + (size_t)voice * row_stride;
+            for (uint32_t i = 0; i < frames; i++) {
+                row[i] = y[i * LANES + l];
+            }
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Self test
+// ---------------------------------------------------------------------------
+
+static float rms(const float* data, uint32_t count) {
+    double sum = 0.0;
+    for (uint32_t i = 0; i < count; i++) {
+        sum += (double)data[i] * data[i];
+    }
+    return (float)sqrt(sum / count);
+}
+
+bool voice_filter_self_test(void) {
+    const uint32_t frames = 256;
+    const uint32_t blocks = 16;
+    const float sample_rate = 44100.0f;
+    voice_filter_bank_t bank;
+    if (voice_filter_bank_init(&bank, 2 * LANES, frames, sample_rate, NULL) != RETROSAGA_SUCCESS) {
+        return false;
+    }
+
+    float* rows = calloc((size_t)2 * LANES * frames, sizeof(float));
+    float* alone = calloc(frames, sizeof(float));
+    if (!rows || !alone) {
+        free(rows);
+        free(alone);
+        voice_filter_bank_destroy(&bank);
+        return false;
+    }
+
+    // Lane 0: lowpass at 500 Hz fed a 10 kHz tone; lane 1: lowpass fed DC;
+    // lane 2: highpass fed DC; lane 3: ladder fed DC; lanes 4..7 idle
+    voice_filter_set(&bank, 0, VOICE_FILTER_LOWPASS, 500.0f, 0.2f);
+    voice_filter_set(&bank, 1, VOICE_FILTER_LOWPASS, 1000.0f, 0.5f);
+    voice_filter_set(&bank, 2, VOICE_FILTER_HIGHPASS, 1000.0f, 0.5f);
+    voice_filter_set(&bank, 3, VOICE_FILTER_LADDER, 1000.0f, 0.0f);
+
+    bool valid = true;
+    float tone_rms = 0.0f;
+    for (uint32_t b = 0; b < blocks; b++) {
+        for (uint32_t i = 0; i < frames; i++) {
+            uint32_t n = b * frames + i;
+            rows[i] = sinf(2.0f * (float)M_PI * 10000.0f * n / sample_rate);
+            rows[frames + i] = 1.0f;
+            rows[2 * frames + i] = 1.0f;
+            rows[3 * frames + i] = 1.0f;
+        }
+        voice_filter_process(&bank, rows, frames, frames);
+        tone_rms = rms(rows, frames);
+    }
+    valid &= tone_rms < 0.02f;
+    valid &= fabsf(rows[2 * frames - 1] - 1.0f) < 1e-3f;   // Lowpass passes DC
+    valid &= fabsf(rows[3 * frames - 1]) < 1e-3f;          // Highpass blocks DC
+    valid &= fabsf(rows[4 * frames - 1] - 1.0f) < 1e-3f;   // Ladder passes DC without feedback
+
+    // Lanes are independent: voice 0 alone must match voice 0 in a full group
+    voice_filter_set(&bank, 0, VOICE_FILTER_LADDER, 2000.0f, 0.9f);
+    voice_filter_set(&bank, 1, VOICE_FILTER_LADDER, 300.0f, 0.3f);
+    for (uint32_t v = 0; v < LANES; v++) {
+        voice_filter_reset_voice(&bank, v);
+    }
+    for (uint32_t i = 0; i < frames; i++) {
+        alone[i] = rows[i] = (i % 50) < 25 ? 0.5f : -0.5f;
+        rows[frames + i] = (i % 7) * 0.1f;
+    }
+    voice_filter_process(&bank, rows, frames, frames);
+
+    voice_filter_reset_voice(&bank, 0);
+    voice_filter_disable(&bank, 1);
+    voice_filter_disable(&bank, 2);
+    voice_filter_disable(&bank, 3);
+    voice_filter_process(&bank, alone, frames, frames);
+    valid &= memcmp(alone, rows, frames * sizeof(float)) == 0;
+
+    // High resonance stays bounded
+    for (uint32_t i = 0; i < frames; i++) {
+        valid &= isfinite(rows[i]) && fabsf(rows[i]) < 10.0f;
+    }
+
+    free(rows);
+    free(alone);
+    voice_filter_bank_destroy(&bank);
+    return valid;
+}
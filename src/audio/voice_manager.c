@@ -0,0 +1,1191 @@
+/*
+ * Voice Manager Module
+ * Polyphonic voice pool and sub-block render engine
+ */
+
+#define _DEFAULT_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <unistd.h>
+#include "audio/voice_manager.h"
+#include "audio/render_kernels.h"
+#include "audio/effect_engine.h"
+#include "audio/envelope.h"
+#include "audio/audio_params.h"
+#include "audio/voice_filter.h"
+#include "audio/midi_event.h"
+#include "audio/midi_processing.h"
+#include "audio/audio_trace.h"
+#include "audio/audio_arena.h"
+#include "audio/audio_workers.h"
+#include "audio/sample_bank.h"
+#include "audio/pitch_table.h"
+#include "audio/input_audio.h"
+#include "audio/audio_snapshot.h"
+
+#define VOICE_MIDI_CHANNELS   16
+#define VOICE_MAX_OUTPUTS     8
+#define VOICE_HEADROOM        0.25f
+#define VOICE_NOTE_BEND_RANGE 48.0f    // Per-note pitch bend, semitones
+#define VOICE_MAX_GROUPS      (128 / VOICE_FILTER_LANES)
+#define VOICE_PARALLEL_MIN_VOICES 8    // Fewer voices render on the calling thread
+
+typedef struct {
+    render_osc_t osc;
+    sample_voice_t sampler;       // Plays instead of osc when sampler.zone is set
+    envelope_t envelope;
+    float gain;                   // Headroom x 16-bit velocity x per-note volume
+    float velocity_gain;
+    float pitch;                  // Fractional note number, per-note pitch 7.25
+    float note_bend;              // Per-note pitch bend, semitones
+    bool pitch_dirty;
+    float block_gain_start;       // Envelope x channel gain for the current sub-block
+    float block_gain_end;
+    bool finishing;               // Envelope went idle during the current sub-block
+    uint32_t age;                 // Start order, oldest is stolen first
+    uint8_t waveform;
+    uint8_t channel;
+    uint8_t note;
+    bool active;
+} voice_t;
+
+typedef struct {
+    uint32_t first_group;         // Filter groups [first_group, end_group)
+    uint32_t end_group;
+    float* bus;                   // Worker 0 mixes straight into the sub-block bus
+    uint32_t active;
+} voice_partition_t;
+
+typedef struct {
+    bool initialized;
+    uint32_t operations_count;
+
+    voice_t* voices;
+    uint32_t voice_count;
+    uint32_t next_age;
+
+    float sample_rate;
+    uint32_t sub_block_frames;
+    uint8_t channels;
+    const render_kernels_t* kernels;  // Resolved once for (sub_block_frames, channels)
+    pitch_table_t pitch;              // Note increments at sample_rate
+
+    audio_arena_t* arena;             // Engine arena; voice rows are per-block scratch
+    size_t voice_rows_bytes;          // One sub-block per voice, voice-major
+    voice_filter_bank_t filters;
+    float* sub_block;                 // Interleaved bus for partially consumed sub-blocks
+    uint32_t sub_block_read;          // Frames of sub_block already handed out
+    uint32_t sub_block_pending;       // Frames of sub_block still to hand out
+    bool sub_block_silent;
+
+    // Current sub-block, shared with the render workers
+    float* block_rows;
+    uint32_t block_bend_changed;
+    uint32_t block_filter_changed;
+
+    // Intra-block parallelism over the audio_workers pool
+    uint32_t worker_count;
+    bool parallel;
+    float* worker_buses;              // Partial mixes of workers 1..worker_count-1
+    float* worker_lanes;              // Their filter transpose buffers
+    voice_partition_t partitions[AUDIO_WORKERS_MAX];
+    uint32_t partition_count;
+
+    uint8_t channel_waveform[VOICE_MIDI_CHANNELS];
+    float channel_gains[VOICE_MIDI_CHANNELS][VOICE_MAX_OUTPUTS];  // Derived from pan
+    uint8_t channel_filter[VOICE_MIDI_CHANNELS];
+    uint32_t filter_dirty;            // Channels whose filter mode changed
+    envelope_shape_t channel_envelope[VOICE_MIDI_CHANNELS];
+    const sample_bank_t* channel_bank[VOICE_MIDI_CHANNELS];  // NULL plays the channel waveform
+
+    voice_manager_stats_t stats;
+} voice_manager_state_t;
+
+static voice_manager_state_t g_voice_state = {0};
+
+// Equal-power pan for stereo buses; other layouts feed every output
+static void update_channel_gains(uint8_t channel, float pan) {
+    float* gains = g_voice_state.channel_gains[channel];
+    if (g_voice_state.channels == 2) {
+        float angle = (pan + 1.0f) * 0.78539816f;
+        gains[0] = cosf(angle);
+        gains[1] = sinf(angle);
+        return;
+    }
+    for (uint8_t c = 0; c < g_voice_state.channels; c++) {
+        gains[c] = 1.0f;
+    }
+}
+
+static void update_voice_filter(uint32_t index, uint8_t channel) {
+    const audio_param_bank_t* bank = audio_params_channel(channel);
+    voice_filter_set(&g_voice_state.filters, index, (voice_filter_mode_t)g_voice_state.channel_filter[channel],
+                     voice_filter_cutoff_hz(bank->params[AUDIO_PARAM_CUTOFF].value),
+                     bank->params[AUDIO_PARAM_RESONANCE].value);
+}
+
+static uint32_t note_increment(float pitch, float bend_semitones) {
+    return pitch_table_increment(&g_voice_state.pitch, pitch + bend_semitones);
+}
+
+static void update_voice_pitch(voice_t* voice) {
+    const audio_param_bank_t* bank = audio_params_channel(voice->channel);
+    float bend = bank->params[AUDIO_PARAM_PITCH_BEND].value + voice->note_bend;
+    if (voice->sampler.zone) {
+        sample_voice_set_pitch(&voice->sampler, voice->pitch + bend, g_voice_state.sample_rate);
+    } else {
+        voice->osc.increment = note_increment(voice->pitch, bend);
+    }
+    voice->pitch_dirty = false;
+}
+
+static float bipolar_32(uint32_t value) {
+    double offset = (double)value - 2147483648.0;
+    return (float)(offset / (value >= 0x80000000u ? 2147483647.0 : 2147483648.0));
+}
+
+int voice_manager_init(void) {
+    if (g_voice_state.initialized) {
+        return RETROSAGA_ERROR_ALREADY_INITIALIZED;
+    }
+
+    printf("[VOICE_MANAGER] Initializing voice manager...\n");
+
+    const retrosaga_audio_config_t* config = retrosaga_audio_get_config();
+    if (config->channels == 0 || config->channels > VOICE_MAX_OUTPUTS || config->sub_block_frames == 0) {
+        return RETROSAGA_ERROR_INVALID_PARAM;
+    }
+
+    g_voice_state.voice_count = config->max_polyphony;
+    g_voice_state.sample_rate = (float)config->sample_rate;
+    g_voice_state.sub_block_frames = config->sub_block_frames;
+    g_voice_state.channels = config->channels;
+    g_voice_state.kernels = render_kernels_select(config->sub_block_frames, config->channels);
+    pitch_table_set_rate(&g_voice_state.pitch, g_voice_state.sample_rate);
+
+    // All render state lives in the engine arena and is reclaimed with it
+    audio_arena_t* arena = audio_arena_engine();
+    if (!arena) {
+        printf("[VOICE_MANAGER] ERROR: Engine arena not initialized\n");
+        return RETROSAGA_ERROR_NOT_INITIALIZED;
+    }
+    g_voice_state.arena = arena;
+    g_voice_state.voice_rows_bytes = (size_t)g_voice_state.voice_count * config->sub_block_frames * sizeof(float);
+    g_voice_state.voices = audio_arena_alloc(arena, g_voice_state.voice_count * sizeof(voice_t));
+    g_voice_state.sub_block = audio_arena_alloc(arena, (size_t)config->sub_block_frames * config->channels *
+                                                           sizeof(float));
+    int filter_result = voice_filter_bank_init(&g_voice_state.filters, g_voice_state.voice_count,
+                                               config->sub_block_frames, g_voice_state.sample_rate, arena);
+
+    // Workers beyond the first need their own partial mix and lane buffers
+    g_voice_state.worker_count = audio_workers_count();
+    g_voice_state.parallel = g_voice_state.worker_count > 1;
+    bool workers_ready = true;
+    if (g_voice_state.parallel) {
+        uint32_t helpers = g_voice_state.worker_count - 1;
+        g_voice_state.worker_buses = audio_arena_alloc(arena, (size_t)helpers * config->sub_block_frames *
+                                                                  config->channels * sizeof(float));
+        g_voice_state.worker_lanes = audio_arena_alloc(arena, (size_t)helpers * 2 * config->sub_block_frames *
+                                                                  VOICE_FILTER_LANES * sizeof(float));
+        workers_ready = g_voice_state.worker_buses && g_voice_state.worker_lanes;
+    }
+    if (!g_voice_state.voices || !g_voice_state.sub_block || filter_result != RETROSAGA_SUCCESS || !workers_ready) {
+        memset(&g_voice_state, 0, sizeof(g_voice_state));
+        return RETROSAGA_ERROR_AUDIO_INIT;
+    }
+    audio_arena_scratch_reserve(arena, g_voice_state.voice_rows_bytes);
+
+    // Sampler voices report their playheads to the bank prefetcher
+    for (uint32_t i = 0; i < g_voice_state.voice_count; i++) {
+        g_voice_state.voices[i].sampler.cursor = sample_bank_cursor_acquire();
+    }
+
+    const envelope_params_t default_envelope = ENVELOPE_PARAMS_DEFAULT;
+    for (int i = 0; i < VOICE_MIDI_CHANNELS; i++) {
+        g_voice_state.channel_waveform[i] = WAVEFORM_SINE;
+        g_voice_state.channel_filter[i] = VOICE_FILTER_OFF;   // Filter cost only where a channel asks
+        update_channel_gains((uint8_t)i, audio_params_channel((uint8_t)i)->params[AUDIO_PARAM_PAN].value);
+        envelope_shape_init(&g_voice_state.channel_envelope[i], &default_envelope,
+                            g_voice_state.sample_rate, g_voice_state.sub_block_frames);
+    }
+
+    g_voice_state.initialized = true;
+
+    printf("[VOICE_MANAGER] %u voices, %u-frame sub-blocks (%.2f ms), %s kernels, %u render workers\n",
+           g_voice_state.voice_count, g_voice_state.sub_block_frames,
+           1000.0f * g_voice_state.sub_block_frames / g_voice_state.sample_rate,
+           render_kernels_is_specialized(g_voice_state.kernels) ? "specialized" : "generic",
+           g_voice_state.worker_count);
+    return RETROSAGA_SUCCESS;
+}
+
+int voice_manager_process(void) {
+    if (!g_voice_state.initialized) {
+        return RETROSAGA_ERROR_NOT_INITIALIZED;
+    }
+
+    g_voice_state.operations_count++;
+    return RETROSAGA_SUCCESS;
+}
+
+// ---------------------------------------------------------------------------
+// Voice allocation
+// ---------------------------------------------------------------------------
+
+static voice_t* allocate_voice(void) {
+    voice_t* oldest = NULL;
+    voice_t* quietest_release = NULL;
+    for (uint32_t i = 0; i < g_voice_state.voice_count; i++) {
+        voice_t* voice = &g_voice_state.voices[i];
+        if (!voice->active) {
+            voice->envelope.level = 0.0f;
+            return voice;
+        }
+        if (envelope_is_releasing(&voice->envelope) &&
+            (!quietest_release || voice->envelope.level < quietest_release->envelope.level)) {
+            quietest_release = voice;
+        }
+        if (!oldest || (int32_t)(voice->age - oldest->age) < 0) {
+            oldest = voice;
+        }
+    }
+
+    g_voice_state.stats.voices_stolen++;
+    return quietest_release ? quietest_release : oldest;
+}
+
+static int start_voice(uint8_t channel, uint8_t note, float velocity) {
+    // Keys outside every zone of the channel's bank stay silent
+    const sample_bank_t* sample_bank = g_voice_state.channel_bank[channel];
+    const sample_zone_t* zone = NULL;
+    if (sample_bank) {
+        uint8_t velocity_7 = (uint8_t)lrintf(velocity * 127.0f);
+        zone = sample_bank_find_zone(sample_bank, note, velocity_7 ? velocity_7 : 1);
+        if (!zone) {
+            return RETROSAGA_SUCCESS;
+        }
+    }
+
+    voice_t* voice = allocate_voice();
+    sample_voice_stop(&voice->sampler);
+    if (zone) {
+        sample_voice_start(&voice->sampler, sample_bank, zone);
+    }
+
+    voice->osc.phase = 0;
+    voice->velocity_gain = VOICE_HEADROOM * velocity;
+    voice->gain = voice->velocity_gain;
+    voice->pitch = (float)note;
+    voice->note_bend = 0.0f;
+    voice->age = g_voice_state.next_age++;
+    voice->waveform = g_voice_state.channel_waveform[channel];
+    voice->channel = channel;
+    voice->note = note;
+    voice->active = true;
+    update_voice_pitch(voice);
+    envelope_gate_on(&voice->envelope);
+
+    uint32_t index = (uint32_t)(voice - g_voice_state.voices);
+    voice_filter_reset_voice(&g_voice_state.filters, index);
+    update_voice_filter(index, channel);
+
+    g_voice_state.stats.voices_started++;
+    return RETROSAGA_SUCCESS;
+}
+
+int voice_manager_note_on(uint8_t channel, uint8_t note, uint8_t velocity) {
+    if (!g_voice_state.initialized) {
+        return RETROSAGA_ERROR_NOT_INITIALIZED;
+    }
+    if (channel >= VOICE_MIDI_CHANNELS || note > 127 || velocity > 127) {
+        return RETROSAGA_ERROR_INVALID_PARAM;
+    }
+    if (velocity == 0) {
+        return voice_manager_note_off(channel, note);
+    }
+
+    return start_voice(channel, note, (float)velocity / 127.0f);
+}
+
+int voice_manager_note_off(uint8_t channel, uint8_t note) {
+    if (!g_voice_state.initialized) {
+        return RETROSAGA_ERROR_NOT_INITIALIZED;
+    }
+    if (channel >= VOICE_MIDI_CHANNELS || note > 127) {
+        return RETROSAGA_ERROR_INVALID_PARAM;
+    }
+
+    for (uint32_t i = 0; i < g_voice_state.voice_count; i++) {
+        voice_t* voice = &g_voice_state.voices[i];
+        if (voice->active && voice->channel == channel && voice->note == note) {
+            envelope_gate_off(&voice->envelope);
+        }
+    }
+    return RETROSAGA_SUCCESS;
+}
+
+void voice_manager_all_notes_off(void) {
+    for (uint32_t i = 0; i < g_voice_state.voice_count; i++) {
+        envelope_gate_off(&g_voice_state.voices[i].envelope);
+    }
+}
+
+void voice_manager_all_sound_off(void) {
+    for (uint32_t i = 0; i < g_voice_state.voice_count; i++) {
+        voice_t* voice = &g_voice_state.voices[i];
+        voice->active = false;
+        sample_voice_stop(&voice->sampler);
+        voice->envelope.level = 0.0f;
+        voice->envelope.stage = ENVELOPE_IDLE;
+        voice_filter_disable(&g_voice_state.filters, i);
+    }
+}
+
+// Per-note controllers address every sounding voice of a note
+static void apply_per_note(const midi_event_t* event) {
+    for (uint32_t i = 0; i < g_voice_state.voice_count; i++) {
+        voice_t* voice = &g_voice_state.voices[i];
+        if (!voice->active || voice->channel != event->channel || voice->note != event->note) {
+            continue;
+        }
+
+        switch (event->type) {
+            case MIDI_EVENT_PER_NOTE_PITCH_BEND:
+                voice->note_bend = bipolar_32(event->value) * VOICE_NOTE_BEND_RANGE;
+                voice->pitch_dirty = true;
+                break;
+            case MIDI_EVENT_PER_NOTE_CONTROL:
+                if (event->index == MIDI_PER_NOTE_PITCH_7_25) {
+                    voice->pitch = (float)(event->value >> 25) + (float)(event->value & 0x1FFFFFF) / 33554432.0f;
+                    voice->pitch_dirty = true;
+                } else if (event->index == MIDI_PER_NOTE_VOLUME) {
+                    voice->gain = voice->velocity_gain * (float)(event->value / 4294967295.0);
+                }
+                break;
+            case MIDI_EVENT_PER_NOTE_MANAGEMENT:
+                if (event->attribute & MIDI_PER_NOTE_RESET) {
+                    voice->pitch = (float)voice->note;
+                    voice->note_bend = 0.0f;
+                    voice->gain = voice->velocity_gain;
+                    voice->pitch_dirty = true;
+                }
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+int voice_manager_apply_event(const midi_event_t* event) {
+    if (!g_voice_state.initialized) {
+        return RETROSAGA_ERROR_NOT_INITIALIZED;
+    }
+    if (!event || event->channel >= VOICE_MIDI_CHANNELS || event->note > 127) {
+        return RETROSAGA_ERROR_INVALID_PARAM;
+    }
+
+    switch (event->type) {
+        case MIDI_EVENT_NOTE_ON:
+            return start_voice(event->channel, event->note, (float)event->velocity / 65535.0f);
+
+        case MIDI_EVENT_NOTE_OFF:
+            return voice_manager_note_off(event->channel, event->note);
+
+        case MIDI_EVENT_CONTROL_CHANGE:
+            // All Sound Off cuts voices, All Notes Off lets them release
+            if (event->index == 120) {
+                voice_manager_all_sound_off();
+                return RETROSAGA_SUCCESS;
+            }
+            if (event->index == 123) {
+                voice_manager_all_notes_off();
+                return RETROSAGA_SUCCESS;
+            }
+            return audio_params_control_change_hr(event->channel, event->index, event->value);
+
+        case MIDI_EVENT_PROGRAM_CHANGE:
+            return voice_manager_set_program(event->channel, (uint8_t)(event->value & 0x7F));
+
+        case MIDI_EVENT_PITCH_BEND:
+            return audio_params_pitch_bend_hr(event->channel, event->value);
+
+        case MIDI_EVENT_PER_NOTE_CONTROL:
+        case MIDI_EVENT_PER_NOTE_PITCH_BEND:
+        case MIDI_EVENT_PER_NOTE_MANAGEMENT:
+            apply_per_note(event);
+            return RETROSAGA_SUCCESS;
+
+        default:
+            // Pressure has no destination yet
+            return RETROSAGA_SUCCESS;
+    }
+}
+
+static void drain_events(void) {
+    midi_event_queue_t* queue = midi_processing_event_queue();
+    midi_event_t event;
+    uint32_t applied = 0;
+    while (queue && midi_event_queue_pop(queue, &event)) {
+        voice_manager_apply_event(&event);
+        applied++;
+    }
+    AUDIO_TRACE_COUNT(AUDIO_TRACE_EVENTS_APPLIED, applied);
+    (void)applied;
+}
+
+int voice_manager_set_program(uint8_t channel, uint8_t program) {
+    if (channel >= VOICE_MIDI_CHANNELS || program > 127) {
+        return RETROSAGA_ERROR_INVALID_PARAM;
+    }
+
+    g_voice_state.channel_waveform[channel] = (uint8_t)(program % WAVEFORM_COUNT);
+    return RETROSAGA_SUCCESS;
+}
+
+int voice_manager_set_sample_bank(uint8_t channel, const sample_bank_t* bank) {
+    if (channel >= VOICE_MIDI_CHANNELS) {
+        return RETROSAGA_ERROR_INVALID_PARAM;
+    }
+
+    g_voice_state.channel_bank[channel] = bank;
+    return RETROSAGA_SUCCESS;
+}
+
+int voice_manager_set_filter(uint8_t channel, voice_filter_mode_t mode) {
+    if (channel >= VOICE_MIDI_CHANNELS || mode >= VOICE_FILTER_MODE_COUNT) {
+        return RETROSAGA_ERROR_INVALID_PARAM;
+    }
+
+    g_voice_state.channel_filter[channel] = (uint8_t)mode;
+    g_voice_state.filter_dirty |= 1u << channel;
+    return RETROSAGA_SUCCESS;
+}
+
+int voice_manager_set_envelope(uint8_t channel, const envelope_params_t* params) {
+    if (channel >= VOICE_MIDI_CHANNELS || !params || params->attack_ms < 0.0f ||
+        params->decay_ms < 0.0f || params->release_ms < 0.0f) {
+        return RETROSAGA_ERROR_INVALID_PARAM;
+    }
+
+    envelope_shape_init(&g_voice_state.channel_envelope[channel], params,
+                        g_voice_state.sample_rate, g_voice_state.sub_block_frames);
+    return RETROSAGA_SUCCESS;
+}
+
+// ---------------------------------------------------------------------------
+// Sub-block engine
+// ---------------------------------------------------------------------------
+
+// Voices [first_group, end_group) * LANES: control updates, oscillators,
+// filters, gain ramps and mixdown into the partition's bus. Partitions
+// own whole filter groups, so workers never touch the same voice, group
+// or bus.
+static void render_partition(voice_partition_t* partition, uint32_t worker) {
+    const render_kernels_t* kernels = g_voice_state.kernels;
+    const uint32_t frames = g_voice_state.sub_block_frames;
+    const uint8_t channels = g_voice_state.channels;
+    float* voice_rows = g_voice_state.block_rows;
+    const uint32_t first = partition->first_group * VOICE_FILTER_LANES;
+    uint32_t end = partition->end_group * VOICE_FILTER_LANES;
+    end = end < g_voice_state.voice_count ? end : g_voice_state.voice_count;
+    uint32_t active = 0;
+
+    if (worker > 0) {
+        memset(partition->bus, 0, (size_t)frames * channels * sizeof(float));
+    }
+
+    // Pass 1: control-rate updates and oscillators into per-voice rows
+    AUDIO_TRACE_BEGIN(osc_start);
+    for (uint32_t i = first; i < end; i++) {
+        voice_t* voice = &g_voice_state.voices[i];
+        if (!voice->active) {
+            continue;
+        }
+
+        const audio_param_bank_t* bank = audio_params_channel(voice->channel);
+        const audio_param_t* volume = &bank->params[AUDIO_PARAM_VOLUME];
+        const audio_param_t* expression = &bank->params[AUDIO_PARAM_EXPRESSION];
+        const uint32_t channel_bit = 1u << voice->channel;
+        if ((g_voice_state.block_bend_changed & channel_bit) || voice->pitch_dirty) {
+            update_voice_pitch(voice);
+        }
+        if (g_voice_state.block_filter_changed & channel_bit) {
+            update_voice_filter(i, voice->channel);
+        }
+
+        // Envelope and channel gain advance once per sub-block and are
+        // applied together as one ramp after the filter
+        float env_start, env_end;
+        voice->finishing = !envelope_next_block(&voice->envelope, &g_voice_state.channel_envelope[voice->channel],
+                                                &env_start, &env_end);
+        voice->block_gain_start = voice->gain * env_start * volume->block_start * expression->block_start;
+        voice->block_gain_end = voice->gain * env_end * volume->value * expression->value;
+
+        float* row = voice_rows + (size_t)i * frames;
+        if (voice->sampler.zone) {
+            voice->finishing |= !sample_voice_render(&voice->sampler, row, frames);
+        } else {
+            kernels->oscillator[voice->waveform](&voice->osc, 1.0f, row, frames);
+        }
+    }
+    AUDIO_TRACE_END(AUDIO_TRACE_VOICE_OSC, osc_start);
+
+    // Pass 2: every filtered voice, a lane group at a time
+    AUDIO_TRACE_BEGIN(filter_start);
+    float* lanes = worker == 0 ? NULL
+                               : g_voice_state.worker_lanes + (size_t)(worker - 1) * 2 * frames * VOICE_FILTER_LANES;
+    voice_filter_process_groups(&g_voice_state.filters, voice_rows, frames, frames, partition->first_group,
+                                partition->end_group, lanes ? lanes : g_voice_state.filters.lane_input,
+                                lanes ? lanes + (size_t)frames * VOICE_FILTER_LANES
+                                      : g_voice_state.filters.lane_output);
+    AUDIO_TRACE_END(AUDIO_TRACE_VOICE_FILTER, filter_start);
+
+    // Pass 3: gain ramps and mix down
+    AUDIO_TRACE_BEGIN(mix_start);
+    for (uint32_t i = first; i < end; i++) {
+        voice_t* voice = &g_voice_state.voices[i];
+        if (!voice->active) {
+            continue;
+        }
+
+        float* row = voice_rows + (size_t)i * frames;
+        kernels->ramp(row, voice->block_gain_start, voice->block_gain_end, frames);
+        kernels->mix(row, g_voice_state.channel_gains[voice->channel], partition->bus, frames, channels);
+        active++;
+    }
+    AUDIO_TRACE_END(AUDIO_TRACE_VOICE_MIX, mix_start);
+
+    partition->active = active;
+}
+
+static void render_worker(void* context, uint32_t worker, uint32_t worker_count) {
+    (void)context;
+    (void)worker_count;
+    voice_partition_t* partition = &g_voice_state.partitions[worker];
+    if (worker < g_voice_state.partition_count) {
+        render_partition(partition, worker);
+    }
+}
+
+// Split the filter groups into contiguous ranges holding roughly equal
+// numbers of active voices, one per worker. Light blocks stay on the
+// calling thread, where a fork-join would cost more than it saves, and
+// a block with no voices gets no partitions at all.
+static uint32_t plan_partitions(float* bus) {
+    const uint32_t groups = g_voice_state.filters.group_count;
+    const size_t bus_samples = (size_t)g_voice_state.sub_block_frames * g_voice_state.channels;
+    uint8_t group_active[VOICE_MAX_GROUPS];
+    uint32_t total = 0;
+
+    memset(group_active, 0, sizeof(group_active));
+    for (uint32_t i = 0; i < g_voice_state.voice_count; i++) {
+        if (g_voice_state.voices[i].active) {
+            group_active[i / VOICE_FILTER_LANES]++;
+            total++;
+        }
+    }
+
+    if (total == 0) {
+        g_voice_state.partition_count = 0;
+        return 0;
+    }
+
+    uint32_t workers = g_voice_state.parallel && total >= VOICE_PARALLEL_MIN_VOICES ? g_voice_state.worker_count : 1;
+    uint32_t group = 0;
+    uint32_t assigned = 0;
+    for (uint32_t w = 0; w < workers; w++) {
+        voice_partition_t* partition = &g_voice_state.partitions[w];
+        uint32_t target = (uint32_t)((uint64_t)total * (w + 1) / workers);
+        partition->first_group = group;
+        while (group < groups && (assigned < target || w + 1 == workers)) {
+            assigned += group_active[group++];
+        }
+        partition->end_group = group;
+        partition->bus = w == 0 ? bus : g_voice_state.worker_buses + (w - 1) * bus_samples;
+        partition->active = 0;
+    }
+
+    g_voice_state.partition_count = workers;
+    return workers;
+}
+
+// Render exactly one sub-block into an interleaved bus. All per-block
+// state (oscillator phase, parameters, effect state) lives outside this
+// call, so it is the only place the engine advances time. Returns true
+// when the bus is silent, which lets effects and output sleep.
+static bool render_sub_block(float* bus) {
+    const uint32_t frames = g_voice_state.sub_block_frames;
+    const uint8_t channels = g_voice_state.channels;
+    const size_t bus_samples = (size_t)frames * channels;
+    uint32_t active = 0;
+    AUDIO_TRACE_BEGIN(block_start);
+
+    // Scratch lives for exactly one sub-block; the size was reserved at init
+    audio_arena_scratch_reset(g_voice_state.arena);
+    g_voice_state.block_rows = audio_arena_scratch_alloc(g_voice_state.arena, g_voice_state.voice_rows_bytes);
+
+    memset(bus, 0, bus_samples * sizeof(float));
+
+    // MIDI input takes effect on sub-block boundaries
+    AUDIO_TRACE_BEGIN(drain_start);
+    drain_events();
+    AUDIO_TRACE_END(AUDIO_TRACE_MIDI_DRAIN, drain_start);
+
+    // Derived channel values are only recomputed for parameters that moved
+    const uint32_t filter_bits = AUDIO_PARAM_BIT(AUDIO_PARAM_CUTOFF) | AUDIO_PARAM_BIT(AUDIO_PARAM_RESONANCE);
+    audio_params_advance_block();
+    uint32_t bend_changed = 0;
+    uint32_t filter_changed = g_voice_state.filter_dirty;
+    g_voice_state.filter_dirty = 0;
+    for (uint8_t c = 0; c < VOICE_MIDI_CHANNELS; c++) {
+        const audio_param_bank_t* bank = audio_params_channel(c);
+        if (bank->changed & AUDIO_PARAM_BIT(AUDIO_PARAM_PAN)) {
+            update_channel_gains(c, bank->params[AUDIO_PARAM_PAN].value);
+        }
+        if (bank->changed & AUDIO_PARAM_BIT(AUDIO_PARAM_PITCH_BEND)) {
+            bend_changed |= 1u << c;
+        }
+        if (bank->changed & filter_bits) {
+            filter_changed |= 1u << c;
+        }
+    }
+    g_voice_state.block_bend_changed = bend_changed;
+    g_voice_state.block_filter_changed = filter_changed;
+
+    // Voices render on the calling thread or fork-join across the pool;
+    // partial mixes are summed in worker order so results are repeatable
+    uint32_t partitions = plan_partitions(bus);
+    bool silent = partitions == 0;
+    if (partitions > 1) {
+        audio_workers_run(render_worker, NULL);
+        for (uint32_t w = 1; w < partitions; w++) {
+            const float* partial = g_voice_state.partitions[w].bus;
+            for (size_t i = 0; i < bus_samples; i++) {
+                bus[i] += partial[i];
+            }
+        }
+        g_voice_state.stats.parallel_sub_blocks++;
+    } else if (partitions == 1) {
+        render_partition(&g_voice_state.partitions[0], 0);
+    }
+    for (uint32_t w = 0; w < partitions; w++) {
+        active += g_voice_state.partitions[w].active;
+    }
+
+    // Retire voices whose envelope finished during this sub-block
+    for (uint32_t i = 0; i < g_voice_state.voice_count && !silent; i++) {
+        voice_t* voice = &g_voice_state.voices[i];
+        if (voice->active && voice->finishing) {
+            voice->active = false;
+            sample_voice_stop(&voice->sampler);
+            voice_filter_disable(&g_voice_state.filters, i);
+            g_voice_state.stats.voices_finished++;
+        }
+    }
+    AUDIO_TRACE_COUNT(AUDIO_TRACE_VOICES_RENDERED, active);
+
+    // Captured input joins the voices so both go through one effect chain
+    silent &= input_audio_mix(bus, frames, channels) == 0;
+
+    AUDIO_TRACE_BEGIN(effects_start);
+    effect_engine_process_block(bus, frames, channels, &silent);
+    AUDIO_TRACE_END(AUDIO_TRACE_EFFECTS, effects_start);
+
+    g_voice_state.stats.active_voices = active;
+    if (active > g_voice_state.stats.peak_voices) {
+        g_voice_state.stats.peak_voices = active;
+    }
+    g_voice_state.stats.sub_blocks_rendered++;
+    g_voice_state.stats.silent_sub_blocks += silent;
+    AUDIO_TRACE_END(AUDIO_TRACE_SUB_BLOCK, block_start);
+    return silent;
+}
+
+void voice_manager_set_parallel(bool enabled) {
+    g_voice_state.parallel = enabled && g_voice_state.worker_count > 1;
+}
+
+int voice_manager_render(float* output, uint32_t frames) {
+    return voice_manager_render_block(output, frames, NULL);
+}
+
+int voice_manager_render_block(float* output, uint32_t frames, bool* silent) {
+    if (!g_voice_state.initialized) {
+        return RETROSAGA_ERROR_NOT_INITIALIZED;
+    }
+    if (!output && frames > 0) {
+        return RETROSAGA_ERROR_INVALID_PARAM;
+    }
+
+    const uint32_t sub_frames = g_voice_state.sub_block_frames;
+    const uint8_t channels = g_voice_state.channels;
+    uint32_t done = 0;
+    bool all_silent = true;
+    AUDIO_ARENA_RT_ENTER();
+
+    while (done < frames) {
+        float* dest = output + (size_t)done * channels;
+        uint32_t remaining = frames - done;
+
+        // Whole sub-blocks go straight into the host buffer
+        if (g_voice_state.sub_block_pending == 0 && remaining >= sub_frames) {
+            all_silent &= render_sub_block(dest);
+            done += sub_frames;
+            continue;
+        }
+
+        // Otherwise serve the host from a staged sub-block
+        if (g_voice_state.sub_block_pending == 0) {
+            g_voice_state.sub_block_silent = render_sub_block(g_voice_state.sub_block);
+            g_voice_state.sub_block_read = 0;
+            g_voice_state.sub_block_pending = sub_frames;
+        }
+
+        uint32_t count = remaining < g_voice_state.sub_block_pending ? remaining : g_voice_state.sub_block_pending;
+        memcpy(dest, g_voice_state.sub_block + (size_t)g_voice_state.sub_block_read * channels,
+               (size_t)count * channels * sizeof(float));
+        all_silent &= g_voice_state.sub_block_silent;
+        g_voice_state.sub_block_read += count;
+        g_voice_state.sub_block_pending -= count;
+        done += count;
+    }
+
+    g_voice_state.stats.frames_rendered += frames;
+    if (silent) {
+        *silent = all_silent;
+    }
+    AUDIO_ARENA_RT_LEAVE();
+    return RETROSAGA_SUCCESS;
+}
+
+void voice_manager_reset(void) {
+    // Pending input belongs to the voices being dropped
+    midi_event_queue_t* queue = midi_processing_event_queue();
+    if (queue) {
+        midi_event_queue_discard(queue);
+    }
+
+    voice_manager_all_sound_off();
+    g_voice_state.sub_block_read = 0;
+    g_voice_state.sub_block_pending = 0;
+    g_voice_state.next_age = 0;
+}
+
+// ---------------------------------------------------------------------------
+// Snapshots
+// ---------------------------------------------------------------------------
+
+#define VOICE_SNAPSHOT_TAG AUDIO_SNAPSHOT_TAG('V', 'O', 'I', 'C')
+
+typedef struct {
+    uint32_t voice_count;
+    uint32_t group_count;
+    uint32_t group_bytes;
+    uint32_t next_age;
+    uint32_t filter_dirty;
+    uint32_t sub_block_read;
+    uint32_t sub_block_pending;
+    bool sub_block_silent;
+    uint32_t active;              // Voice records that follow
+    uint8_t channel_waveform[VOICE_MIDI_CHANNELS];
+    uint8_t channel_filter[VOICE_MIDI_CHANNELS];
+    uint64_t channel_bank[VOICE_MIDI_CHANNELS];  // Bank ids; checked, not restored
+} voice_snapshot_t;
+
+// Sampler pointers are rebuilt from the zone index on restore
+typedef struct {
+    uint32_t index;
+    int32_t zone;                 // -1 for an oscillator voice
+} voice_snapshot_record_t;
+
+void voice_manager_snapshot_save(audio_snapshot_stream_t* stream) {
+    voice_snapshot_t header = {
+        .voice_count = g_voice_state.voice_count,
+        .group_count = g_voice_state.filters.group_count,
+        .group_bytes = sizeof(voice_filter_group_t),
+        .next_age = g_voice_state.next_age,
+        .filter_dirty = g_voice_state.filter_dirty,
+        .sub_block_read = g_voice_state.sub_block_read,
+        .sub_block_pending = g_voice_state.sub_block_pending,
+        .sub_block_silent = g_voice_state.sub_block_silent,
+    };
+    memcpy(header.channel_waveform, g_voice_state.channel_waveform, sizeof(header.channel_waveform));
+    memcpy(header.channel_filter, g_voice_state.channel_filter, sizeof(header.channel_filter));
+    for (uint8_t c = 0; c < VOICE_MIDI_CHANNELS; c++) {
+        header.channel_bank[c] = sample_bank_id(g_voice_state.channel_bank[c]);
+    }
+    for (uint32_t i = 0; i < g_voice_state.voice_count; i++) {
+        header.active += g_voice_state.voices[i].active;
+    }
+
+    audio_snapshot_begin_section(stream, VOICE_SNAPSHOT_TAG, sizeof(voice_t));
+    audio_snapshot_put(stream, &header, sizeof(header));
+    audio_snapshot_put(stream, g_voice_state.channel_gains, sizeof(g_voice_state.channel_gains));
+    audio_snapshot_put(stream, g_voice_state.channel_envelope, sizeof(g_voice_state.channel_envelope));
+    if (header.sub_block_pending) {
+        audio_snapshot_put(stream, g_voice_state.sub_block,
+                           (size_t)g_voice_state.sub_block_frames * g_voice_state.channels * sizeof(float));
+    }
+    audio_snapshot_put(stream, g_voice_state.filters.groups, (size_t)header.group_count * sizeof(voice_filter_group_t));
+
+    for (uint32_t i = 0; i < g_voice_state.voice_count; i++) {
+        const voice_t* voice = &g_voice_state.voices[i];
+        if (!voice->active) {
+            continue;
+        }
+        const sample_voice_t* sampler = &voice->sampler;
+        voice_snapshot_record_t record = {
+            i, sampler->zone ? (int32_t)(sampler->zone - sample_bank_zone(sampler->bank, 0)) : -1};
+        audio_snapshot_put(stream, &record, sizeof(record));
+        audio_snapshot_put(stream, voice, sizeof(*voice));
+    }
+}
+
+bool voice_manager_snapshot_restore(audio_snapshot_stream_t* stream) {
+    voice_snapshot_t header;
+    if (!audio_snapshot_expect_section(stream, VOICE_SNAPSHOT_TAG, sizeof(voice_t)) ||
+        !audio_snapshot_get(stream, &header, sizeof(header))) {
+        return false;
+    }
+    if (header.voice_count != g_voice_state.voice_count || header.group_count != g_voice_state.filters.group_count ||
+        header.group_bytes != sizeof(voice_filter_group_t) || header.active > header.voice_count ||
+        header.sub_block_read + header.sub_block_pending > g_voice_state.sub_block_frames) {
+        return audio_snapshot_refuse(stream, "Voice pool laid out differently");
+    }
+    for (uint8_t c = 0; c < VOICE_MIDI_CHANNELS; c++) {
+        if (header.channel_bank[c] != sample_bank_id(g_voice_state.channel_bank[c])) {
+            return audio_snapshot_refuse(stream, "Another sample bank is assigned to a channel");
+        }
+    }
+
+    const size_t sub_block_bytes = (size_t)g_voice_state.sub_block_frames * g_voice_state.channels * sizeof(float);
+    const size_t group_bytes = (size_t)header.group_count * sizeof(voice_filter_group_t);
+    const void* channel_gains = audio_snapshot_view(stream, sizeof(g_voice_state.channel_gains));
+    const void* channel_envelope = audio_snapshot_view(stream, sizeof(g_voice_state.channel_envelope));
+    const void* sub_block = header.sub_block_pending ? audio_snapshot_view(stream, sub_block_bytes) : NULL;
+    const void* groups = audio_snapshot_view(stream, group_bytes);
+    if (!channel_gains || !channel_envelope || (header.sub_block_pending && !sub_block) || !groups) {
+        return false;
+    }
+
+    if (stream->apply) {
+        for (uint32_t i = 0; i < g_voice_state.voice_count; i++) {
+            voice_t* voice = &g_voice_state.voices[i];
+            sample_voice_stop(&voice->sampler);
+            voice->active = false;
+            voice->envelope.level = 0.0f;
+            voice->envelope.stage = ENVELOPE_IDLE;
+        }
+        memcpy(g_voice_state.filters.groups, groups, group_bytes);
+        memcpy(g_voice_state.channel_gains, channel_gains, sizeof(g_voice_state.channel_gains));
+        memcpy(g_voice_state.channel_envelope, channel_envelope, sizeof(g_voice_state.channel_envelope));
+        memcpy(g_voice_state.channel_waveform, header.channel_waveform, sizeof(header.channel_waveform));
+        memcpy(g_voice_state.channel_filter, header.channel_filter, sizeof(header.channel_filter));
+        if (sub_block) {
+            memcpy(g_voice_state.sub_block, sub_block, sub_block_bytes);
+        }
+        g_voice_state.next_age = header.next_age;
+        g_voice_state.filter_dirty = header.filter_dirty;
+        g_voice_state.sub_block_read = header.sub_block_read;
+        g_voice_state.sub_block_pending = header.sub_block_pending;
+        g_voice_state.sub_block_silent = header.sub_block_silent;
+    }
+
+    for (uint32_t n = 0; n < header.active; n++) {
+        voice_snapshot_record_t record;
+        voice_t saved;
+        if (!audio_snapshot_get(stream, &record, sizeof(record)) || !audio_snapshot_get(stream, &saved, sizeof(saved))) {
+            return false;
+        }
+        const sample_bank_t* bank = saved.channel < VOICE_MIDI_CHANNELS ? g_voice_state.channel_bank[saved.channel]
+                                                                       : NULL;
+        const sample_zone_t* zone = record.zone >= 0 ? sample_bank_zone(bank, (uint32_t)record.zone) : NULL;
+        if (record.index >= g_voice_state.voice_count || saved.channel >= VOICE_MIDI_CHANNELS ||
+            (record.zone >= 0 && !zone)) {
+            return audio_snapshot_refuse(stream, "Voice record out of range");
+        }
+        if (stream->apply) {
+            voice_t* voice = &g_voice_state.voices[record.index];
+            sample_voice_t sampler = voice->sampler;
+            *voice = saved;
+            voice->sampler = sampler;
+            if (zone) {
+                sample_voice_start(&voice->sampler, bank, zone);
+                voice->sampler.position = saved.sampler.position;
+                voice->sampler.step = saved.sampler.step;
+            }
+        }
+    }
+    return true;
+}
+
+void voice_manager_get_stats(voice_manager_stats_t* stats) {
+    if (stats) {
+        *stats = g_voice_state.stats;
+    }
+}
+
+void voice_manager_shutdown(void) {
+    if (!g_voice_state.initialized) {
+        return;
+    }
+
+    printf("[VOICE_MANAGER] Shutting down voice manager...\n");
+    printf("[VOICE_MANAGER] Voices started: %lu, finished: %lu, stolen: %lu, peak: %u\n",
+           (unsigned long)g_voice_state.stats.voices_started,
+           (unsigned long)g_voice_state.stats.voices_finished,
+           (unsigned long)g_voice_state.stats.voices_stolen, g_voice_state.stats.peak_voices);
+    printf("[VOICE_MANAGER] Sub-blocks rendered: %lu (%lu parallel, %lu silent)\n",
+           (unsigned long)g_voice_state.stats.sub_blocks_rendered,
+           (unsigned long)g_voice_state.stats.parallel_sub_blocks,
+           (unsigned long)g_voice_state.stats.silent_sub_blocks);
+
+    for (uint32_t i = 0; i < g_voice_state.voice_count; i++) {
+        sample_voice_stop(&g_voice_state.voices[i].sampler);
+        sample_bank_cursor_release(g_voice_state.voices[i].sampler.cursor);
+    }
+    voice_filter_bank_destroy(&g_voice_state.filters);
+    memset(&g_voice_state, 0, sizeof(g_voice_state));
+    printf("[VOICE_MANAGER] Voice manager shutdown complete\n");
+}
+
+// ---------------------------------------------------------------------------
+// Validation
+// ---------------------------------------------------------------------------
+
+static void start_test_chord(void) {
+    voice_manager_reset();
+    voice_manager_note_on(0, 60, 100);
+    voice_manager_note_on(0, 64, 90);
+    voice_manager_note_on(1, 67, 80);
+}
+
+static voice_t* find_test_voice(uint8_t channel, uint8_t note) {
+    for (uint32_t i = 0; i < g_voice_state.voice_count; i++) {
+        voice_t* voice = &g_voice_state.voices[i];
+        if (voice->active && voice->channel == channel && voice->note == note) {
+            return voice;
+        }
+    }
+    return NULL;
+}
+
+// A channel with a sample bank picks its zone by velocity, and a one-shot
+// zone frees its voice when the sample ends even while the key is held
+static bool validate_sampler_voices(void) {
+    enum { FRAMES = 256, CHANNEL = 4 };
+    static float loop[FRAMES], shot[FRAMES];
+    uint32_t rate = (uint32_t)g_voice_state.sample_rate;
+    for (uint32_t i = 0; i < FRAMES; i++) {
+        loop[i] = 0.5f;
+        shot[i] = 0.5f;
+    }
+    sample_zone_t zones[2];
+    memset(zones, 0, sizeof(zones));
+    zones[0] = (sample_zone_t){0, 127, 0, 63, 60, 1, 0, rate, FRAMES, 0, FRAMES, 0};
+    zones[1] = (sample_zone_t){0, 127, 64, 127, 60, 0, 0, rate, FRAMES, 0, 0, 0};
+    const float* samples[2] = {loop, shot};
+
+    char path[64];
+    snprintf(path, sizeof(path), "/tmp/retrosaga_voices_%ld.rsbk", (long)getpid());
+    sample_bank_t* bank = NULL;
+    if (sample_bank_write(path, zones, samples, 2, SAMPLE_FORMAT_FLOAT32) != RETROSAGA_SUCCESS ||
+        sample_bank_open(path, &bank) != RETROSAGA_SUCCESS) {
+        unlink(path);
+        return false;
+    }
+
+    const sample_bank_t* previous = g_voice_state.channel_bank[CHANNEL];
+    voice_manager_reset();
+    voice_manager_set_sample_bank(CHANNEL, bank);
+    voice_manager_note_on(CHANNEL, 60, 100);
+    voice_manager_note_on(CHANNEL, 62, 30);
+    voice_t* shot_voice = find_test_voice(CHANNEL, 60);
+    voice_t* loop_voice = find_test_voice(CHANNEL, 62);
+    bool valid = shot_voice && loop_voice && shot_voice->sampler.zone == sample_bank_zone(bank, 1) &&
+                 loop_voice->sampler.zone == sample_bank_zone(bank, 0);
+
+    float block[VOICE_MAX_OUTPUTS * 64];
+    uint64_t finished = g_voice_state.stats.voices_finished;
+    uint32_t blocks = 0;
+    while (valid && find_test_voice(CHANNEL, 60) && blocks < 64) {
+        voice_manager_render(block, 64);
+        blocks++;
+    }
+    valid = valid && blocks <= FRAMES / 64 + 1 && !find_test_voice(CHANNEL, 60) && find_test_voice(CHANNEL, 62) &&
+            shot_voice->sampler.zone == NULL && g_voice_state.stats.voices_finished == finished + 1;
+
+    voice_manager_reset();
+    voice_manager_set_sample_bank(CHANNEL, previous);
+    sample_bank_close(bank);
+    unlink(path);
+    return valid;
+}
+
+// Checks that reset the pool and drive the live queue and effect chain;
+// voice_manager_validate() puts the host's engine state back afterwards
+static bool validate_render_paths(void) {
+    // Output must not depend on how the host slices its buffers
+    static const uint32_t host_sizes[] = {1, 7, 32, 100, 333, 64, 515, 1024};
+    const uint32_t total = 2048;
+    const uint8_t channels = g_voice_state.channels;
+    float* reference = calloc((size_t)total * channels, sizeof(float));
+    float* sliced = calloc((size_t)total * channels, sizeof(float));
+    if (!reference || !sliced) {
+        free(reference);
+        free(sliced);
+        printf("[VOICE_MANAGER] VALIDATION FAILED: Out of memory\n");
+        return false;
+    }
+
+    start_test_chord();
+    voice_manager_render(reference, total);
+
+    start_test_chord();
+    uint32_t done = 0;
+    for (size_t i = 0; done < total; i = (i + 1) % (sizeof(host_sizes) / sizeof(host_sizes[0]))) {
+        uint32_t count = host_sizes[i] < total - done ? host_sizes[i] : total - done;
+        voice_manager_render(sliced + (size_t)done * channels, count);
+        done += count;
+    }
+
+    bool valid = memcmp(reference, sliced, (size_t)total * channels * sizeof(float)) == 0;
+    if (!valid) {
+        free(reference);
+        free(sliced);
+        printf("[VOICE_MANAGER] VALIDATION FAILED: Output depends on host buffer size\n");
+        voice_manager_reset();
+        return false;
+    }
+
+    // Split rendering matches the calling thread up to summation order
+    if (g_voice_state.worker_count > 1) {
+        bool parallel = g_voice_state.parallel;
+        uint32_t voices = g_voice_state.voice_count < 24 ? g_voice_state.voice_count : 24;
+        float max_error = 0.0f;
+        for (int pass = 0; pass < 2; pass++) {
+            voice_manager_set_parallel(pass == 1);
+            voice_manager_reset();
+            for (uint32_t v = 0; v < voices; v++) {
+                voice_manager_note_on((uint8_t)(v % VOICE_MIDI_CHANNELS), (uint8_t)(40 + v * 2), 100);
+            }
+            voice_manager_render(pass == 0 ? reference : sliced, total);
+        }
+        for (size_t i = 0; i < (size_t)total * channels; i++) {
+            float error = fabsf(reference[i] - sliced[i]);
+            max_error = error > max_error ? error : max_error;
+        }
+        g_voice_state.parallel = parallel;
+        valid = max_error < 1.0e-5f &&
+                (voices < VOICE_PARALLEL_MIN_VOICES || g_voice_state.stats.parallel_sub_blocks > 0);
+        if (!valid) {
+            free(reference);
+            free(sliced);
+            printf("[VOICE_MANAGER] VALIDATION FAILED: Parallel render differs by %g\n", max_error);
+            voice_manager_reset();
+            return false;
+        }
+    }
+    free(reference);
+    free(sliced);
+
+    // A full pool steals the oldest voice instead of dropping the note
+    voice_manager_reset();
+    uint64_t stolen = g_voice_state.stats.voices_stolen;
+    for (uint32_t i = 0; i <= g_voice_state.voice_count; i++) {
+        voice_manager_note_on(2, (uint8_t)(i % 128), 64);
+    }
+    valid = g_voice_state.stats.voices_stolen == stolen + 1 && g_voice_state.voices[0].age == g_voice_state.voice_count;
+    voice_manager_reset();
+    if (!valid) {
+        printf("[VOICE_MANAGER] VALIDATION FAILED: Voice stealing\n");
+        return false;
+    }
+
+    // Released voices return to the pool once their envelope is silent
+    float block[VOICE_MAX_OUTPUTS * 64];
+    uint64_t finished = g_voice_state.stats.voices_finished;
+    uint32_t blocks_per_second = (uint32_t)(g_voice_state.sample_rate / 64.0f);
+    voice_manager_note_on(3, 69, 127);
+    for (uint32_t i = 0; i < blocks_per_second / 4; i++) {
+        voice_manager_render(block, 64);
+    }
+    bool sustained = g_voice_state.voices[0].envelope.stage == ENVELOPE_SUSTAIN;
+    voice_manager_note_off(3, 69);
+    for (uint32_t i = 0; i < blocks_per_second && g_voice_state.voices[0].active; i++) {
+        voice_manager_render(block, 64);
+    }
+    valid = sustained && !g_voice_state.voices[0].active &&
+            g_voice_state.stats.voices_finished == finished + 1;
+    voice_manager_reset();
+    if (!valid) {
+        printf("[VOICE_MANAGER] VALIDATION FAILED: Envelope did not release its voice\n");
+        return false;
+    }
+
+    if (!validate_sampler_voices()) {
+        printf("[VOICE_MANAGER] VALIDATION FAILED: Sampler voice did not free at the end of its zone\n");
+        return false;
+    }
+
+    // An empty pool renders silence and says so; one voice ends it
+    bool silent = false;
+    voice_manager_render_block(block, 64, &silent);
+    bool was_silent = silent && block[0] == 0.0f;
+    voice_manager_note_on(3, 69, 127);
+    voice_manager_render_block(block, 64, &silent);
+    valid = was_silent && !silent;
+    voice_manager_reset();
+    if (!valid) {
+        printf("[VOICE_MANAGER] VALIDATION FAILED: Silent block detection\n");
+        return false;
+    }
+
+    // UMP input reaches the voice at full resolution on the next sub-block
+    static const uint32_t packets[] = {
+        0x40943C00, 0xFFFF0000,    // Note on ch5 note 60, velocity 0xFFFF
+        0x40043C03, 0x90000000     // Per-note pitch 7.25: note 72.0
+    };
+    if (midi_processing_ingest_ump(packets, 4) == 4) {
+        voice_manager_render(block, 64);
+        voice_t* voice = &g_voice_state.voices[0];
+        valid = voice->active && voice->note == 60 && voice->gain == VOICE_HEADROOM && voice->pitch == 72.0f &&
+                voice->osc.increment == note_increment(72.0f, 0.0f);
+        voice_manager_reset();
+        if (!valid) {
+            printf("[VOICE_MANAGER] VALIDATION FAILED: High-resolution event path\n");
+            return false;
+        }
+    }
+    return true;
+}
+
+bool voice_manager_validate(void) {
+    if (!g_voice_state.initialized) {
+        printf("[VOICE_MANAGER] VALIDATION FAILED: Not initialized\n");
+        return false;
+    }
+
+    // Voices, queued events, parameters and effect tails the host had
+    size_t saved_size = audio_snapshot_size();
+    uint8_t* saved = malloc(saved_size);
+    if (!saved || audio_snapshot_save(saved, saved_size, 0, &saved_size) != RETROSAGA_SUCCESS) {
+        free(saved);
+        printf("[VOICE_MANAGER] VALIDATION FAILED: Cannot save the engine state\n");
+        return false;
+    }
+
+    bool valid = validate_render_paths();
+    if (audio_snapshot_restore(saved, saved_size) != RETROSAGA_SUCCESS) {
+        printf("[VOICE_MANAGER] VALIDATION FAILED: Cannot restore the engine state\n");
+        valid = false;
+    }
+    free(saved);
+    if (valid) {
+        printf("[VOICE_MANAGER] Voice manager validation passed\n");
+    }
+    return valid;
+}
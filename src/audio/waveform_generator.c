@@ -7,11 +7,9 @@
 #include <stdlib.h>
 #include <math.h>
 #include "audio/waveform_generator.h"
+#include "audio/render_kernels.h"
 #include <string.h>
 #include <stdlib.h>
-#ifndef M_PI
-#define M_PI 3.14159265358979323846
-#endif
 
 typedef struct {
     bool initialized;
@@ -28,62 +26,49 @@ int waveform_generator_init(void) {
     
     printf("[WAVEFORM_GENERATOR] Initializing waveform generator...\n");
     
-    g_waveform_state.sample_rate = RETROSAGA_SAMPLE_RATE;
+    g_waveform_state.sample_rate = (float)retrosaga_audio_get_config()->sample_rate;
     g_waveform_state.waveforms_generated = 0;
     g_waveform_state.initialized = true;
     
-    printf("[WAVEFORM_GENERATOR] Waveform generator initialized at %d Hz\n", 
-           RETROSAGA_SAMPLE_RATE);
+    printf("[WAVEFORM_GENERATOR] Waveform generator initialized at %.0f Hz\n", 
+           g_waveform_state.sample_rate);
     return RETROSAGA_SUCCESS;
 }
 
-// Generate sine wave
-static void generate_sine_wave(float frequency, float amplitude, float* buffer, size_t samples) {
-    for (size_t i = 0; i < samples; i++) {
-        float t = (float)i / g_waveform_state.sample_rate;
-        buffer[i] = amplitude * sinf(2.0f * M_PI * frequency * t);
-    }
-}
-
-// Generate sawtooth wave
-static void generate_sawtooth_wave(float frequency, float amplitude, float* buffer, size_t samples) {
-    for (size_t i = 0; i < samples; i++) {
-        float t = (float)i / g_waveform_state.sample_rate;
-        float phase = fmodf(frequency * t, 1.0f);
-        buffer[i] = amplitude * (2.0f * phase - 1.0f);
-    }
-}
-
-// Generate square wave
-static void generate_square_wave(float frequency, float amplitude, float* buffer, size_t samples) {
-    for (size_t i = 0; i < samples; i++) {
-        float t = (float)i / g_waveform_state.sample_rate;
-        float phase = fmodf(frequency * t, 1.0f);
-        buffer[i] = amplitude * (phase < 0.5f ? 1.0f : -1.0f);
-    }
-}
-
-// Generate triangle wave
-static void generate_triangle_wave(float frequency, float amplitude, float* buffer, size_t samples) {
-    for (size_t i = 0; i < samples; i++) {
-        float t = (float)i / g_waveform_state.sample_rate;
-        float phase = fmodf(frequency * t, 1.0f);
-        buffer[i] = amplitude * (phase < 0.5f ? 4.0f * phase - 1.0f : 3.0f - 4.0f * phase);
-    }
+// Phase accumulator positioned at sample n; the starting phase is computed
+// in double so long streams stay in tune. A fraction that rounds up to a
+// whole cycle wraps to phase 0 through the 64-bit conversion
+static inline render_osc_t osc_at(float frequency, uint64_t n) {
+    double cycles = (double)frequency * (double)n / g_waveform_state.sample_rate;
+    render_osc_t osc = {
+        (uint32_t)(uint64_t)((cycles - floor(cycles)) * 4294967296.0),
+        render_osc_increment(frequency, g_waveform_state.sample_rate)
+    };
+    return osc;
 }
 
-int generate_waveform(float frequency, float amplitude, float* buffer, size_t samples) {
+int generate_waveform_at(waveform_type_t type, float frequency, float amplitude,
+                         uint64_t start_sample, float* buffer, size_t samples) {
     if (!g_waveform_state.initialized || !buffer) {
         return RETROSAGA_ERROR_INVALID_PARAM;
     }
+    if ((unsigned)type >= WAVEFORM_COUNT || samples > UINT32_MAX) {
+        return RETROSAGA_ERROR_INVALID_PARAM;
+    }
     
-    // Default to sine wave for now
-    generate_sine_wave(frequency, amplitude, buffer, samples);
+    render_osc_t osc = osc_at(frequency, start_sample);
+    const render_kernels_t* kernels = render_kernels_select((uint32_t)samples, 1);
+    kernels->oscillator[type](&osc, amplitude, buffer, (uint32_t)samples);
     
     g_waveform_state.waveforms_generated++;
     return RETROSAGA_SUCCESS;
 }
 
+int generate_waveform(float frequency, float amplitude, float* buffer, size_t samples) {
+    // Default to sine wave for now
+    return generate_waveform_at(WAVEFORM_SINE, frequency, amplitude, 0, buffer, samples);
+}
+
 int waveform_generator_process(void) {
     if (!g_waveform_state.initialized) {
         return RETROSAGA_ERROR_NOT_INITIALIZED;